@@ -0,0 +1,189 @@
+#include "compositor.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#ifdef COMPOSITOR_SSE2
+#include <emmintrin.h>
+#endif
+
+uint32_t colorRefToPixel(uint32_t color) {
+    return ((color & 0xFF) << 16) | (color & 0xFF00) | ((color >> 16) & 0xFF);
+}
+
+void resetGlyphAtlas(GlyphAtlas& atlas, const std::wstring& fontName, int cellWidth, int cellHeight) {
+    atlas.fontName = fontName;
+    atlas.cellWidth = cellWidth;
+    atlas.cellHeight = cellHeight;
+    atlas.slotOfGlyph.assign(0x10000, -1);
+    atlas.coverage.clear();
+}
+
+const uint8_t* findGlyphMask(const GlyphAtlas& atlas, wchar_t glyph) {
+    if ((size_t)glyph >= atlas.slotOfGlyph.size() || atlas.slotOfGlyph[glyph] < 0) return nullptr;
+    return &atlas.coverage[(size_t)atlas.slotOfGlyph[glyph] * atlas.cellWidth * atlas.cellHeight];
+}
+
+void addGlyphMask(GlyphAtlas& atlas, wchar_t glyph, const uint8_t* mask) {
+    if ((size_t)glyph >= atlas.slotOfGlyph.size() || atlas.slotOfGlyph[glyph] >= 0) return;
+    size_t maskSize = (size_t)atlas.cellWidth * atlas.cellHeight;
+    atlas.slotOfGlyph[glyph] = (int)(atlas.coverage.size() / std::max(maskSize, (size_t)1));
+    atlas.coverage.insert(atlas.coverage.end(), mask, mask + maskSize);
+}
+
+void fillPixels(PixelBuffer& buffer, int x, int y, int w, int h, uint32_t color) {
+    for (int row = 0; row < h; ++row) {
+        std::fill_n(buffer.pixels + (size_t)(y + row) * buffer.stride + x, w, color);
+    }
+}
+
+// Per channel: (fg * a + dst * (255 - a)) / 255, rounded. Exact for a = 0 and a = 255.
+uint32_t blendPixel(uint32_t dst, uint32_t fg, uint32_t a) {
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t x = ((fg >> shift) & 0xFF) * a + ((dst >> shift) & 0xFF) * (255 - a) + 128;
+        out |= (((x + (x >> 8)) >> 8) & 0xFF) << shift;
+    }
+    return out;
+}
+
+// Blends columns [first, w) of each mask row; blendGlyphMask's tail and the whole of the scalar reference.
+static void blendGlyphMaskColumns(PixelBuffer& buffer, int x, int y, const uint8_t* mask, int w, int h, uint32_t fg, int first) {
+    for (int row = 0; row < h; ++row) {
+        uint32_t* dst = buffer.pixels + (size_t)(y + row) * buffer.stride + x;
+        const uint8_t* coverage = mask + (size_t)row * w;
+        for (int i = first; i < w; ++i) {
+            if (coverage[i]) dst[i] = blendPixel(dst[i], fg, coverage[i]);
+        }
+    }
+}
+
+void blendGlyphMaskScalar(PixelBuffer& buffer, int x, int y, const uint8_t* mask, int w, int h, uint32_t fg) {
+    blendGlyphMaskColumns(buffer, x, y, mask, w, h, fg, 0);
+}
+
+// Blends a w x h coverage mask in colour fg over the buffer at (x, y). The SSE2 path does four pixels per
+// step with the same arithmetic as blendPixel, so both paths give identical output.
+void blendGlyphMask(PixelBuffer& buffer, int x, int y, const uint8_t* mask, int w, int h, uint32_t fg) {
+#ifdef COMPOSITOR_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i fgWide = _mm_unpacklo_epi8(_mm_set1_epi32((int)fg), zero);
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i half = _mm_set1_epi16(128);
+    auto blend = [&](__m128i dstWide, __m128i coverageWide) {
+        __m128i sum = _mm_add_epi16(_mm_mullo_epi16(fgWide, coverageWide), _mm_mullo_epi16(dstWide, _mm_sub_epi16(full, coverageWide)));
+        sum = _mm_add_epi16(sum, half);
+        return _mm_srli_epi16(_mm_add_epi16(sum, _mm_srli_epi16(sum, 8)), 8);
+    };
+    const int vectorWidth = w & ~3;
+    for (int row = 0; row < h; ++row) {
+        uint32_t* dst = buffer.pixels + (size_t)(y + row) * buffer.stride + x;
+        const uint8_t* coverage = mask + (size_t)row * w;
+        for (int i = 0; i < vectorWidth; i += 4) {
+            int packed;
+            memcpy(&packed, coverage + i, sizeof(packed));
+            if (packed == 0) continue; // Glyph rows are mostly empty
+            __m128i c = _mm_cvtsi32_si128(packed);
+            c = _mm_unpacklo_epi8(c, c);  // c0 c0 c1 c1 c2 c2 c3 c3
+            c = _mm_unpacklo_epi16(c, c); // Each coverage byte once per channel
+            __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+            __m128i lo = blend(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(c, zero));
+            __m128i hi = blend(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(c, zero));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+        }
+    }
+    blendGlyphMaskColumns(buffer, x, y, mask, w, h, fg, vectorWidth);
+#else
+    blendGlyphMaskColumns(buffer, x, y, mask, w, h, fg, 0);
+#endif
+}
+
+void compositeCell(PixelBuffer& buffer, const GlyphAtlas& atlas, const ScreenCell& cell, int x, int y) {
+    const int w = atlas.cellWidth, h = atlas.cellHeight;
+    fillPixels(buffer, x, y, w, h, cell.bg);
+    if (cell.glyph != L' ') {
+        if (const uint8_t* mask = findGlyphMask(atlas, cell.glyph)) blendGlyphMask(buffer, x, y, mask, w, h, cell.fg);
+    }
+    if (cell.overlay != L' ') {
+        if (const uint8_t* mask = findGlyphMask(atlas, cell.overlay)) blendGlyphMask(buffer, x, y, mask, w, h, cell.overlayFg);
+    }
+}
+
+// Composites every cell of a columns x rows grid that differs from what the buffer already shows, recorded in
+// presented (empty means nothing is known). The buffer must be at least columns * cellWidth by rows * cellHeight.
+// Glyphs missing from the atlas leave just the background. Returns how many cells were redrawn.
+int compositeChangedCells(PixelBuffer& buffer, const GlyphAtlas& atlas, const ScreenCell* cells, std::vector<ScreenCell>& presented, int columns, int rows) {
+    size_t count = (size_t)columns * rows;
+    if (presented.size() != count) presented.assign(count, UNKNOWN_SCREEN_CELL);
+    int redrawn = 0;
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < columns; ++col) {
+            size_t i = (size_t)row * columns + col;
+            if (cells[i] == presented[i]) continue;
+            compositeCell(buffer, atlas, cells[i], col * atlas.cellWidth, row * atlas.cellHeight);
+            presented[i] = cells[i];
+            ++redrawn;
+        }
+    }
+    return redrawn;
+}
+
+// Moves the buffer's contents by (dx, dy) pixels. The strip left uncovered keeps stale pixels; callers mark those
+// cells unknown so they get redrawn.
+void shiftPixels(PixelBuffer& buffer, int dx, int dy) {
+    int w = buffer.width - abs(dx), h = buffer.height - abs(dy);
+    if (w <= 0 || h <= 0 || (dx == 0 && dy == 0)) return;
+    int srcX = std::max(-dx, 0), dstX = std::max(dx, 0);
+    int srcY = std::max(-dy, 0), dstY = std::max(dy, 0);
+    for (int i = 0; i < h; ++i) {
+        int row = dy > 0 ? h - 1 - i : i; // Bottom-up when moving down, so no row is overwritten before it is read
+        memmove(buffer.pixels + (size_t)(dstY + row) * buffer.stride + dstX, buffer.pixels + (size_t)(srcY + row) * buffer.stride + srcX, (size_t)w * sizeof(uint32_t));
+    }
+}
+
+// The cell-grid counterpart of shiftPixels: moves cells by (dx, dy) and marks the uncovered ones unknown.
+void shiftCells(std::vector<ScreenCell>& cells, int columns, int rows, int dx, int dy) {
+    if (cells.size() != (size_t)columns * rows || (dx == 0 && dy == 0)) return;
+    std::vector<ScreenCell> shifted(cells.size(), UNKNOWN_SCREEN_CELL);
+    for (int row = std::max(dy, 0); row < std::min(rows, rows + dy); ++row) {
+        for (int col = std::max(dx, 0); col < std::min(columns, columns + dx); ++col) {
+            shifted[(size_t)row * columns + col] = cells[(size_t)(row - dy) * columns + (col - dx)];
+        }
+    }
+    cells.swap(shifted);
+}
+
+int lightScale(float lightLevel) {
+    return std::max(0, std::min(256, (int)(lightLevel * 256.0f + 0.5f)));
+}
+
+void tintPixelsScalar(const uint32_t* src, uint32_t* dst, size_t count, int scale) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t p = src[i];
+        uint32_t pixelScale = (p & PIXEL_TINTED) ? (uint32_t)scale : 256;
+        dst[i] = ((((p >> 16) & 0xFF) * pixelScale >> 8) << 16) | ((((p >> 8) & 0xFF) * pixelScale >> 8) << 8) | ((p & 0xFF) * pixelScale >> 8);
+    }
+}
+
+// Copies count pixels from src to dst, scaling each channel of flagged pixels by scale / 256 and clearing the
+// flag byte. The SSE2 path does four pixels per step and matches tintPixelsScalar exactly.
+void tintPixels(const uint32_t* src, uint32_t* dst, size_t count, int scale) {
+    size_t i = 0;
+#ifdef COMPOSITOR_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i flag = _mm_set1_epi32((int)PIXEL_TINTED);
+    const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i tinted = _mm_set1_epi32(scale | (scale << 16));
+    const __m128i untinted = _mm_set1_epi32(256 | (256 << 16));
+    for (; i + 4 <= count; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i isTinted = _mm_cmpeq_epi32(_mm_and_si128(p, flag), flag);
+        __m128i pixelScale = _mm_or_si128(_mm_and_si128(isTinted, tinted), _mm_andnot_si128(isTinted, untinted));
+        p = _mm_and_si128(p, colorMask);
+        __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), _mm_unpacklo_epi32(pixelScale, pixelScale)), 8);
+        __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), _mm_unpackhi_epi32(pixelScale, pixelScale)), 8);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    tintPixelsScalar(src + i, dst + i, count - i, scale);
+}
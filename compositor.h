@@ -0,0 +1,58 @@
+#pragma once
+// --- Glyph Atlas Compositor ---
+// The tile viewport is composited in software: each glyph of the display font is rasterised once into a coverage
+// mask, and every frame the viewport's cells are blended into a 32-bit pixel buffer that reaches the window in one
+// blit. The buffer is kept between frames along with the cells it shows, so only cells that differ from the last
+// frame are composited again, and a camera scroll shifts the pixels it already has. Nothing here touches Win32:
+// main.cpp rasterises the glyphs and blits the buffer, and tests/compositor_test.cpp runs this on its own.
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define COMPOSITOR_SSE2 1
+#endif
+
+struct PixelBuffer {
+    uint32_t* pixels = nullptr; // 0x00RRGGBB, top-down rows
+    int width = 0, height = 0;
+    int stride = 0;             // In pixels
+};
+struct GlyphAtlas {
+    std::wstring fontName;
+    int cellWidth = 0, cellHeight = 0;
+    std::vector<int> slotOfGlyph;  // Indexed by glyph; -1 until rasterised
+    std::vector<uint8_t> coverage; // cellWidth * cellHeight bytes per slot, 0 = background, 255 = full ink
+};
+struct ScreenCell {
+    wchar_t glyph = L' ';
+    uint32_t fg = 0, bg = 0;
+    wchar_t overlay = L' '; // Blended over the glyph in its own colour, e.g. a designation
+    uint32_t overlayFg = 0;
+    bool operator==(const ScreenCell& other) const {
+        return glyph == other.glyph && fg == other.fg && bg == other.bg && overlay == other.overlay && overlayFg == other.overlayFg;
+    }
+};
+const ScreenCell UNKNOWN_SCREEN_CELL = { (wchar_t)0xFFFF }; // Never built by the view, so always redrawn
+const uint32_t PIXEL_TINTED = 0x01000000; // Flag in a source pixel's top byte: tintPixels scales it by the light level
+
+// A Win32 COLORREF (0x00BBGGRR) as a buffer pixel.
+uint32_t colorRefToPixel(uint32_t color);
+
+void resetGlyphAtlas(GlyphAtlas& atlas, const std::wstring& fontName, int cellWidth, int cellHeight);
+const uint8_t* findGlyphMask(const GlyphAtlas& atlas, wchar_t glyph);
+void addGlyphMask(GlyphAtlas& atlas, wchar_t glyph, const uint8_t* mask);
+
+void fillPixels(PixelBuffer& buffer, int x, int y, int w, int h, uint32_t color);
+uint32_t blendPixel(uint32_t dst, uint32_t fg, uint32_t a);
+void blendGlyphMask(PixelBuffer& buffer, int x, int y, const uint8_t* mask, int w, int h, uint32_t fg);
+void blendGlyphMaskScalar(PixelBuffer& buffer, int x, int y, const uint8_t* mask, int w, int h, uint32_t fg);
+void compositeCell(PixelBuffer& buffer, const GlyphAtlas& atlas, const ScreenCell& cell, int x, int y);
+int compositeChangedCells(PixelBuffer& buffer, const GlyphAtlas& atlas, const ScreenCell* cells, std::vector<ScreenCell>& presented, int columns, int rows);
+void shiftPixels(PixelBuffer& buffer, int dx, int dy);
+void shiftCells(std::vector<ScreenCell>& cells, int columns, int rows, int dx, int dy);
+
+int lightScale(float lightLevel);
+void tintPixels(const uint32_t* src, uint32_t* dst, size_t count, int scale);
+void tintPixelsScalar(const uint32_t* src, uint32_t* dst, size_t count, int scale);
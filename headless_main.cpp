@@ -0,0 +1,25 @@
+// ColonySimHeadless and the CMake colony_headless target: the simulation without the window, for timing runs and
+// determinism checks on any platform. It takes the same options as `ColonySim --headless` (see
+// parseHeadlessOptions) and prints to the console it was started from, so scripts can wait on it. Command log
+// replay and --fast-forward-check drive the game's input handlers, so only the windowed build runs those.
+#include "simulation.h"
+
+#include <cstdio>
+#include <string>
+
+int main(int argc, char** argv) {
+    setWorldSeed(makeRandomSeed());
+    initGameData();
+    std::string commandLine;
+    for (int i = 1; i < argc; ++i) commandLine += std::string(argv[i]) + " ";
+    HeadlessOptions headless = parseHeadlessOptions(commandLine);
+    if (!headless.replayPath.empty() || headless.fastForwardCheck) {
+        printf("--replay and --fast-forward-check need the windowed build: ColonySim --headless ...\n");
+        return 2;
+    }
+
+    startWorkerPool(g_simThreadCount);
+    int result = headless.determinism ? runDeterminismCheck(headless) : runHeadless(headless);
+    stopWorkerPool();
+    return result;
+}
@@ -0,0 +1,5079 @@
+#include "simulation.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <codecvt>
+#include <cstring>
+#include <ctime>
+#include <locale>
+#include <queue>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+// --- Simulation State ---
+std::map<TileType, TileData> TILE_DATA;
+std::map<Biome, BiomeData> BIOME_DATA;
+Biome landingBiome = Biome::TEMPERATE_FOREST;
+
+SimulationHooks g_simHooks;
+
+FastForwardMode g_fastForwardMode = FastForwardMode::OFF;
+std::wstring g_fastForwardStopReason;
+
+uint64_t g_worldSeed = 0;
+RandomStream g_rngCritters;
+RandomStream g_rngPawns;
+RandomStream g_rngWeather;
+RandomStream g_rngEvents;
+
+long long gameTicks = 0;
+int gameHour = 12, gameMinute = 0, gameSecond = 0, gameDay = 1, gameMonth = 0, gameYear = 1;
+bool isFullMoon = false;
+Season currentSeason = Season::SPRING;
+Weather currentWeather = Weather::CLEAR;
+int temperature = 15;
+TimeOfDay currentTimeOfDay = TimeOfDay::MIDDAY;
+float currentLightLevel = 1.0f;
+std::vector<LightSource> g_lightSources;
+std::vector<LightMapLevel> g_lightMaps;
+bool g_lightShadows = true;
+SolidColumnIndex g_solidColumns;
+int TROPOSPHERE_TOP_Z_LEVEL = 0;
+
+TimerWheel g_timerWheel;
+std::deque<AiTask> g_aiDeferredTasks;
+int g_aiBudgetMicros = 2000;
+int g_aiTaskQuota = 0;
+HaulScanState g_haulScan;
+AiSchedulerStats g_aiStats;
+WorkerPool g_workerPool;
+int g_simThreadCount = 0;
+#ifdef PROFILER_ENABLED
+Profiler g_profiler;
+#endif
+
+std::map<CritterType, CritterData> g_CritterData;
+std::map<CritterTag, std::wstring> g_CritterTagNames;
+std::vector<Critter> g_critters;
+std::map<Biome, std::vector<CritterType>> g_BiomeCritters;
+int TILE_WORLD_DEPTH = 0; int BIOSPHERE_Z_LEVEL = 0; int HYDROSPHERE_Z_LEVEL = 0; int ATMOSPHERE_TOP_Z = 0;
+
+std::map<std::wstring, ResearchProject> g_allResearch;
+unsigned g_researchDataVersion = 0;
+std::set<std::wstring> g_completedResearch;
+std::wstring g_currentResearchProject = L"";
+int g_researchProgress = 0;
+std::set<TileType> g_unlockedBuildings;
+unsigned g_unlockedContentVersion = 0;
+
+std::vector<Planet> solarSystem; Moon homeMoon;
+std::vector<Star> distantStars; int g_homeSystemStarIndex = -1;
+int landingSiteX = -1, landingSiteY = -1; int finalStartX = -1, finalStartY = -1;
+
+std::vector<std::vector<std::vector<MapCell>>> Z_LEVELS;
+std::vector<std::wstring> designations(WORLD_HEIGHT, std::wstring(WORLD_WIDTH, L' '));
+std::map<int, Tree> a_trees;
+int nextTreeId = 0;
+std::vector<FallenTree> a_fallingTrees;
+std::map<std::wstring, Backstory> g_Backstories;
+std::map<std::wstring, std::wstring> g_SkillDescriptions;
+std::vector<Job> jobQueue;
+std::vector<Pawn> rerollablePawns; std::vector<Pawn> colonists;
+std::map<std::wstring, int> resources;
+std::map<TileType, int> g_stockpiledResources;
+unsigned g_stockpileContentsVersion = 0;
+
+std::vector<Stockpile> g_stockpiles;
+std::vector<int> g_stockpileSlotById;
+int nextStockpileId = 0;
+std::map<int, int> g_unreachableStockpileCache;
+std::map<TileTag, std::wstring> g_tagNames;
+std::map<TileTag, std::vector<TileType>> g_haulableItemsGrouped;
+
+std::map<TileType, ItemTypeIndex> g_itemIndex;
+std::vector<StairLink> g_stairLinks;
+std::vector<std::vector<int>> g_stairNodesByLevel;
+bool g_stairGraphDirty = true;
+MapHashState g_mapHash;
+
+int gameSpeed = 1;
+std::vector<std::vector<std::vector<bool>>> g_isTileReachable;
+
+// Helper function to convert wstring to string for Discord SDK
+std::string WStringToString(const std::wstring& wstr) {
+    if (wstr.empty()) {
+        return std::string();
+    }
+    std::string strTo;
+    strTo.reserve(wstr.size());
+    for (size_t i = 0; i < wstr.size(); ++i) {
+        uint32_t c = (uint32_t)wstr[i];
+        // UTF-16 (Windows wchar_t): join a surrogate pair into one code point
+        if (c >= 0xD800 && c < 0xDC00 && i + 1 < wstr.size() && (uint32_t)wstr[i + 1] >= 0xDC00 && (uint32_t)wstr[i + 1] < 0xE000) {
+            c = 0x10000 + ((c - 0xD800) << 10) + ((uint32_t)wstr[++i] - 0xDC00);
+        }
+        if (c < 0x80) {
+            strTo += (char)c;
+        } else if (c < 0x800) {
+            strTo += (char)(0xC0 | (c >> 6));
+            strTo += (char)(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            strTo += (char)(0xE0 | (c >> 12));
+            strTo += (char)(0x80 | ((c >> 6) & 0x3F));
+            strTo += (char)(0x80 | (c & 0x3F));
+        } else {
+            strTo += (char)(0xF0 | (c >> 18));
+            strTo += (char)(0x80 | ((c >> 12) & 0x3F));
+            strTo += (char)(0x80 | ((c >> 6) & 0x3F));
+            strTo += (char)(0x80 | (c & 0x3F));
+        }
+    }
+    return strTo;
+}
+
+// --- Random Streams ---
+uint64_t mixRandomSeed(uint64_t seed, uint64_t salt) {
+    // splitmix64 finalizer: nearby inputs land far apart.
+    uint64_t z = seed + 0x9e3779b97f4a7c15ULL * (salt + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+uint32_t randomNext(RandomStream& rng) {
+    uint64_t old = rng.state;
+    rng.state = old * 6364136223846793005ULL + rng.inc;
+    uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+    uint32_t rot = static_cast<uint32_t>(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+// Non-negative int, a drop-in for rand() in the `% n` idiom.
+int randomInt(RandomStream& rng) {
+    return static_cast<int>(randomNext(rng) >> 1);
+}
+
+RandomStream deriveRandomStream(uint64_t seed, RandomStreamId id, uint64_t index = 0) {
+    RandomStream rng;
+    rng.state = 0;
+    rng.inc = (mixRandomSeed(static_cast<uint64_t>(id), index) << 1) | 1;
+    randomNext(rng);
+    rng.state += mixRandomSeed(seed, index);
+    randomNext(rng);
+    return rng;
+}
+
+uint64_t makeRandomSeed() {
+    return mixRandomSeed(static_cast<uint64_t>(time(0)), static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+}
+
+void setWorldSeed(uint64_t seed) {
+    g_worldSeed = seed;
+    g_rngCritters = deriveRandomStream(seed, RandomStreamId::CRITTERS);
+    g_rngPawns = deriveRandomStream(seed, RandomStreamId::PAWNS);
+    g_rngWeather = deriveRandomStream(seed, RandomStreamId::WEATHER);
+    g_rngEvents = deriveRandomStream(seed, RandomStreamId::EVENTS);
+}
+
+CounterRandom counterRandom(RandomStreamId id, uint64_t entity, long long tick) {
+    return { mixRandomSeed(mixRandomSeed(mixRandomSeed(g_worldSeed, static_cast<uint64_t>(id)), entity), static_cast<uint64_t>(tick)) };
+}
+
+int randomInt(CounterRandom& rng) {
+    return static_cast<int>(mixRandomSeed(rng.key, rng.counter++) >> 33);
+}
+
+// --- Worker Pool ---
+void runWorkerPoolChunks() {
+    WorkerPool& pool = g_workerPool;
+    for (;;) {
+        size_t begin = pool.nextChunk.fetch_add(1) * pool.chunkSize;
+        if (begin >= pool.itemCount) return;
+        pool.job(begin, std::min(begin + pool.chunkSize, pool.itemCount));
+    }
+}
+
+void workerPoolThread() {
+    WorkerPool& pool = g_workerPool;
+    unsigned long long seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(pool.mutex);
+            pool.wake.wait(lock, [&] { return pool.stopping || pool.generation != seenGeneration; });
+            if (pool.stopping) return;
+            seenGeneration = pool.generation;
+        }
+        runWorkerPoolChunks();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (--pool.busyWorkers == 0) pool.done.notify_one();
+    }
+}
+
+void startWorkerPool(int threadCount) {
+    stopWorkerPool();
+    if (threadCount <= 0) threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+    for (int i = 1; i < threadCount; ++i) g_workerPool.threads.emplace_back(workerPoolThread);
+}
+
+void stopWorkerPool() {
+    WorkerPool& pool = g_workerPool;
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.stopping = true;
+    }
+    pool.wake.notify_all();
+    for (std::thread& thread : pool.threads) thread.join();
+    pool.threads.clear();
+    pool.stopping = false;
+}
+
+// Calls fn over [0, count) in chunks spread across the pool. Small batches run inline.
+void parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& fn) {
+    WorkerPool& pool = g_workerPool;
+    if (pool.threads.empty() || count <= chunkSize) {
+        if (count > 0) fn(0, count);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.job = fn;
+        pool.itemCount = count;
+        pool.chunkSize = chunkSize;
+        pool.nextChunk = 0;
+        pool.busyWorkers = pool.threads.size();
+        pool.generation++;
+    }
+    pool.wake.notify_all();
+    runWorkerPoolChunks();
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    pool.done.wait(lock, [&] { return pool.busyWorkers == 0; });
+    pool.job = nullptr;
+}
+
+// --- Profiler ---
+#ifdef PROFILER_ENABLED
+int registerProfileZone(ProfileCategory category, const char* name) {
+    ProfileZone zone;
+    zone.name = name;
+    zone.category = category;
+    std::lock_guard<std::mutex> lock(g_profiler.mutex);
+    g_profiler.zones.push_back(zone);
+    return static_cast<int>(g_profiler.zones.size()) - 1;
+}
+
+ProfileScope::~ProfileScope() {
+    auto end = std::chrono::steady_clock::now();
+    long long duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::lock_guard<std::mutex> lock(g_profiler.mutex);
+    ProfileZone& profileZone = g_profiler.zones[zone];
+    profileZone.frameMicros += duration;
+    profileZone.totalMicros += duration;
+    profileZone.calls++;
+    if (g_profiler.capturing && g_profiler.trace.size() < PROFILE_TRACE_MAX_EVENTS) {
+        g_profiler.trace.push_back({ zone, std::chrono::duration_cast<std::chrono::microseconds>(start - g_profiler.epoch).count(), duration });
+    }
+}
+
+// Chrome trace_event "complete" events; sim and render zones go on separate rows.
+void writeProfilerTrace(const std::string& path) {
+    std::ofstream out(path);
+    out << "{\"traceEvents\":[\n";
+    for (size_t i = 0; i < g_profiler.trace.size(); ++i) {
+        const ProfileTraceEvent& event = g_profiler.trace[i];
+        const ProfileZone& zone = g_profiler.zones[event.zone];
+        bool isSim = (zone.category == ProfileCategory::SIM);
+        out << (i > 0 ? ",\n" : "") << "{\"name\":\"" << zone.name << "\",\"cat\":\"" << (isSim ? "sim" : "render")
+            << "\",\"ph\":\"X\",\"ts\":" << event.startMicros << ",\"dur\":" << event.durationMicros
+            << ",\"pid\":1,\"tid\":" << (isSim ? 1 : 2) << "}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+#endif
+
+// Ends a frame for every zone of the category: what it spent since the last call joins its rolling window.
+void profilerEndFrame(ProfileCategory category) {
+#ifdef PROFILER_ENABLED
+    std::lock_guard<std::mutex> lock(g_profiler.mutex);
+    for (ProfileZone& zone : g_profiler.zones) {
+        if (zone.category != category) continue;
+        zone.history[zone.historyNext] = zone.frameMicros;
+        zone.historyNext = (zone.historyNext + 1) % PROFILE_HISTORY;
+        zone.historyCount = std::min(PROFILE_HISTORY, zone.historyCount + 1);
+        zone.frameMicros = 0;
+    }
+#endif
+}
+
+// Starts a trace capture, or ends the running one and writes it next to the executable.
+void toggleProfilerTrace() {
+#ifdef PROFILER_ENABLED
+    std::lock_guard<std::mutex> lock(g_profiler.mutex);
+    if (!g_profiler.capturing) {
+        g_profiler.trace.clear();
+        g_profiler.capturing = true;
+    }
+    else {
+        g_profiler.capturing = false;
+        writeProfilerTrace("profile_trace.json");
+        std::vector<ProfileTraceEvent>().swap(g_profiler.trace);
+    }
+#endif
+}
+
+void spawnInitialCritters() {
+    g_critters.clear(); // Ensure we start with a clean slate
+
+    const int INITIAL_CRITTER_COUNT = 15 + (randomInt(g_rngCritters) % 10); // Spawn 15-24 critters initially
+
+    for (int i = 0; i < INITIAL_CRITTER_COUNT; ++i) {
+        // Decide if we're spawning a land or aquatic critter
+        bool spawn_aquatic = (randomInt(g_rngCritters) % 100 < 20); // 20% chance to try spawning an aquatic one
+
+        CritterType type_to_spawn;
+        bool found_type = false;
+
+        if (spawn_aquatic) {
+            const auto& aquatic_critters = g_BiomeCritters.at(Biome::OCEAN);
+            if (!aquatic_critters.empty()) {
+                type_to_spawn = aquatic_critters[randomInt(g_rngCritters) % aquatic_critters.size()];
+                found_type = true;
+            }
+        }
+
+        // If not spawning aquatic, or if aquatic list was empty, spawn a land critter
+        if (!found_type) {
+            if (g_BiomeCritters.count(landingBiome) && !g_BiomeCritters.at(landingBiome).empty()) {
+                const auto& possible_critters = g_BiomeCritters.at(landingBiome);
+                type_to_spawn = possible_critters[randomInt(g_rngCritters) % possible_critters.size()];
+                found_type = true;
+            }
+        }
+
+        if (!found_type) continue; // Skip if no valid critter types for this biome
+
+        const auto& data = g_CritterData.at(type_to_spawn);
+        bool is_aquatic = std::find(data.tags.begin(), data.tags.end(), CritterTag::AQUATIC) != data.tags.end();
+
+        // Find a valid spawn location
+        int spawn_x = -1, spawn_y = -1;
+        int attempts = 50;
+        while (attempts > 0) {
+            int try_x = randomInt(g_rngCritters) % WORLD_WIDTH;
+            int try_y = randomInt(g_rngCritters) % WORLD_HEIGHT;
+
+            if (is_aquatic) {
+                if (Z_LEVELS[BIOSPHERE_Z_LEVEL][try_y][try_x].type == TileType::WATER) {
+                    spawn_x = try_x;
+                    spawn_y = try_y;
+                    break;
+                }
+            }
+            else {
+                if (isCritterWalkable(try_x, try_y, BIOSPHERE_Z_LEVEL)) {
+                    spawn_x = try_x;
+                    spawn_y = try_y;
+                    break;
+                }
+            }
+            attempts--;
+        }
+
+        if (spawn_x != -1) {
+            Critter new_critter;
+            new_critter.type = type_to_spawn;
+            new_critter.x = spawn_x;
+            new_critter.y = spawn_y;
+            new_critter.z = BIOSPHERE_Z_LEVEL;
+            new_critter.wanderCooldown = data.wander_speed + (randomInt(g_rngCritters) % 50); // Random initial cooldown
+            g_critters.push_back(new_critter);
+        }
+    }
+}
+
+void initResearchData() {
+    g_allResearch.clear();
+    g_researchDataVersion++;
+    g_completedResearch.clear();
+
+    // --- Neolithic Era ---
+    g_allResearch[L"AGR"] = { L"AGR", L"Agriculture", L"Unlock the ability to create farm plots to grow crops.", 1500, ResearchEra::NEOLITHIC, ResearchCategory::FARMING, {}, {L"Building: Farm Plot", L"Work: Sowing & Harvesting", L"Building: Growing Zone"} };
+    g_allResearch[L"ANH"] = { L"ANH", L"Animal Husbandry", L"Learn to domesticate and breed animals for food, leather, and labor.", 1800, ResearchEra::NEOLITHIC, ResearchCategory::ANIMALS, {L"AGR"}, {L"Building: Animal Pen", L"Work: Taming"} };
+    g_allResearch[L"BSC"] = { L"BSC", L"Construction", L"Build walls and structures from wood.", 1000, ResearchEra::NEOLITHIC, ResearchCategory::CONSTRUCTION, {}, {L"Building: Wall"} };
+    g_allResearch[L"BWW"] = { L"BWW", L"Woodworking", L"Develop techniques to craft simple furniture and items from wood.", 1000, ResearchEra::NEOLITHIC, ResearchCategory::CRAFTING, {L"BSC"}, {L"Building: Carpentry Workbench", L"Building: Chair", L"Building: Table", L"Building: Torch"} };
+    g_allResearch[L"STC"] = { L"STC", L"Stonecutting", L"Process rough stone chunks into uniform blocks, which are required for advanced stone buildings.", 1200, ResearchEra::NEOLITHIC, ResearchCategory::CRAFTING, {L"BSC"}, {L"Building: Stonecutting Table", L"Recipe: Stone Blocks"} };
+    g_allResearch[L"TXS"] = { L"TXS", L"Textile Spinning", L"Learn to spin raw fibers from plants or animals into thread, the basic component for weaving cloth.", 1800, ResearchEra::NEOLITHIC, ResearchCategory::APPAREL, {L"AGR"}, {L"Building: Spinning Wheel", L"Recipe: Thread", L"Recipe: Basic Apparel"} };
+    g_allResearch[L"BRW"] = { L"BRW", L"Beer Brewing", L"Discover the process of fermentation to turn grains and fruits into a pleasant alcoholic beverage.", 1500, ResearchEra::NEOLITHIC, ResearchCategory::COOKING, {L"AGR"}, {L"Building: Brewery", L"Recipe: Beer"} };
+    g_allResearch[L"MAS"] = { L"MAS", L"Masonry", L"Learn to shape stone into blocks and construct sturdy stone walls and structures.", 1200, ResearchEra::NEOLITHIC, ResearchCategory::CONSTRUCTION, {L"STC"}, {L"Building: Stone Wall"} };
+    g_allResearch[L"ARC"] = { L"ARC", L"Archery", L"Train skilled hunters and fletchers to craft bows and arrows for ranged combat and hunting.", 1200, ResearchEra::NEOLITHIC, ResearchCategory::COMBAT, {L"BWW", L"HUNT"}, {L"Recipe: Bow", L"Recipe: Arrow"}};
+    g_allResearch[L"BZWRK"] = { L"BZWRK", L"Bronze Working", L"Master the art of combining copper and tin to forge bronze, a stronger metal for tools and weapons.", 2000, ResearchEra::NEOLITHIC, ResearchCategory::CRAFTING, {L"MIN"}, {L"Recipe: Bronze Ingot", L"Building: Bronze Anvil (future)"} };
+    g_allResearch[L"CAL"] = { L"CAL", L"Calendar", L"Organize time with a calendar to track seasons, predict harvests, and plan events.", 1000, ResearchEra::NEOLITHIC, ResearchCategory::SCIENCE, {}, {} };
+    g_allResearch[L"MIN"] = { L"MIN", L"Mining", L"Unlock basic techniques for systematically excavating ore veins and extracting raw minerals from rock.", 1000, ResearchEra::NEOLITHIC, ResearchCategory::CRAFTING, {L"STC"}, {L"Work: Mine Ores", L"Building: Mine Shaft", L"Recipe: Pickaxe"} };
+    g_allResearch[L"POT"] = { L"POT", L"Pottery", L"Craft basic clay vessels for storage, cooking, and decorative purposes.", 800, ResearchEra::NEOLITHIC, ResearchCategory::CRAFTING, {L"AGR"}, {L"Recipe: Clay Pot", L"Building: Potter's Wheel (future)"} };
+    g_allResearch[L"SAI"] = { L"SAI", L"Sailing", L"Develop rudimentary sailing techniques, allowing for exploration and trade across water bodies.", 1500, ResearchEra::NEOLITHIC, ResearchCategory::TRANSPORT, {L"BWW"}, {L"Recipe: Raft"}};
+    g_allResearch[L"TRA"] = { L"TRA", L"Trapping", L"Learn to set traps for small game, providing a reliable source of food and fur.", 900, ResearchEra::NEOLITHIC, ResearchCategory::COMBAT, {L"HUNT"}, {L"Recipe: Simple Trap", L"Recipe: Spike Trap"} };
+    g_allResearch[L"IRR"] = { L"IRR", L"Irrigation", L"Develop systems to transport water to crops, improving agricultural yields and resilience to drought.", 1700, ResearchEra::NEOLITHIC, ResearchCategory::FARMING, {L"AGR"}, {L"Building: Irrigation Ditch (future)"} };
+    g_allResearch[L"ASTRO"] = { L"ASTRO", L"Astrology", L"Observe celestial bodies to predict natural phenomena and understand their influence on life.", 1100, ResearchEra::NEOLITHIC, ResearchCategory::SCIENCE, {L"CAL"}, {} };
+    g_allResearch[L"FIS"] = { L"FIS", L"Fishing", L"Develop primitive tools and techniques to catch fish, providing a new food source.", 800, ResearchEra::NEOLITHIC, ResearchCategory::COOKING, {}, {L"Building: Fishing Zone (future)", L"Recipe: Fish (future)"} }; // NEW
+    g_allResearch[L"HUNT"] = { L"HUNT", L"Hunting", L"Master the techniques of tracking, ambushing, and eliminating wild animals for resources and security.", 9500, ResearchEra::NEOLITHIC, ResearchCategory::COMBAT, {}, {L"Work: Hunting"} };
+    g_allResearch[L"FIRE_TAM"] = { L"FIRE_TAM", L"Fire Taming", L"Learn to safely maintain and utilize fire for warmth, cooking, and crafting, essential for survival.", 1500, ResearchEra::NEOLITHIC, ResearchCategory::COOKING, {}, {L"Building: Campfire"} };
+
+    // --- Classical Era ---
+    g_allResearch[L"CLS_PHL"] = { L"CLS_PHL", L"Philosophy", L"Ponder the big questions, establishing formal methods of thought and debate.", 2500, ResearchEra::CLASSICAL, ResearchCategory::SCIENCE, {}, {L"Recreation: Meditation Spot"} };
+    g_allResearch[L"WRT"] = { L"WRT", L"Writing", L"Develop a system of written symbols to record knowledge, improving research and social organization.", 2000, ResearchEra::CLASSICAL, ResearchCategory::SCIENCE, {L"CLS_PHL"}, {L"Passive: +10% Research Speed", L"Building: Bookshelf (future)"} };
+    g_allResearch[L"CLS_SMT"] = { L"CLS_SMT", L"Smithing", L"Learn to work with metals to craft durable tools, weapons, and armor.", 3000, ResearchEra::CLASSICAL, ResearchCategory::CRAFTING, {L"MAS", L"BZWRK"}, {L"Building: Smithy", L"Recipe: Metal Tools & Weapons"} };
+    g_allResearch[L"CLS_WHL"] = { L"CLS_WHL", L"The Wheel", L"Develop the wheel and axle for transportation and construction, improving hauling efficiency.", 2200, ResearchEra::CLASSICAL, ResearchCategory::TRANSPORT, {L"BWW"}, {L"Passive: +10% Pawn move speed", L"Recipe: Wheel", L"Unlock: Basic Land Vehicles (future)", L"Unlock: Windmills"} };
+    g_allResearch[L"CUR"] = { L"CUR", L"Currency", L"Establish a standardized system of trade, allowing for more efficient exchanges and economic growth.", 2500, ResearchEra::CLASSICAL, ResearchCategory::TECH, {L"WRT"}, {L"Unlocks advanced trade options (future)", L"Building: Coining Mill", L"Recipe: Coin"} };
+    g_allResearch[L"DRA"] = { L"DRA", L"Drama and Poetry", L"Cultivate artistic expression through dramatic performances and poetic verse, improving colony morale.", 1800, ResearchEra::CLASSICAL, ResearchCategory::RECREATION, {L"WRT"}, {L"Building: Theatre Stage"} };
+    g_allResearch[L"ENG"] = { L"ENG", L"Engineering", L"Apply scientific principles to design and build complex structures, including bridges and defensive works.", 3000, ResearchEra::CLASSICAL, ResearchCategory::CONSTRUCTION, {L"CLS_SMT", L"MAT"}, {L"Building: Stone Bridge (future)", L"Building: Siege Wall (future)"} };
+    g_allResearch[L"HRB"] = { L"HRB", L"Horseback Riding", L"Domesticate and train horses for transportation, warfare, and labor.", 2000, ResearchEra::CLASSICAL, ResearchCategory::ANIMALS, {L"ANH"}, {L"Work: Horse Riding (future)", L"Building: Stables (future)"} };
+    g_allResearch[L"IRW"] = { L"IRW", L"Iron Working", L"Discover how to smelt iron from ore and forge it into strong tools and weapons.", 3500, ResearchEra::CLASSICAL, ResearchCategory::CRAFTING, {L"MIN", L"CLS_SMT"}, {L"Recipe: Iron Ingot", L"Building: Bloomery (future)"} };
+    g_allResearch[L"MAT"] = { L"MAT", L"Mathematics", L"Develop advanced mathematical concepts for improved construction, engineering, and astronomy.", 2800, ResearchEra::CLASSICAL, ResearchCategory::SCIENCE, {L"CLS_PHL"}, {L"Passive: +10% Construction Speed", L"Passive: +10% Research Speed"} };
+    g_allResearch[L"OPT"] = { L"OPT", L"Optics", L"Craft basic lenses and mirrors, leading to advancements in scientific observation and ranged weaponry.", 2200, ResearchEra::CLASSICAL, ResearchCategory::TECH, {L"CLS_SMT"}, {L"Building: Simple Telescope (future)", L"Recipe: Spyglass (future)", L"Recipe: Lens", L"Recipe: Glasses"} };
+    g_allResearch[L"WNDM"] = { L"WNDM", L"Windmills", L"Harness wind power for grinding grain and pumping water, improving efficiency in production.", 2500, ResearchEra::CLASSICAL, ResearchCategory::POWER, {L"CLS_WHL", L"ENG"}, {L"Building: Windmill"} };
+    g_allResearch[L"PAP"] = { L"PAP", L"Paper Making", L"Process plant fibers into paper, a superior medium for writing and record-keeping.", 2000, ResearchEra::CLASSICAL, ResearchCategory::SCIENCE, {L"AGR", L"BWW"}, {L"Recipe: Paper"} };
+    g_allResearch[L"GLS"] = { L"GLS", L"Glassblowing", L"Learn to shape molten glass into functional and decorative items, from windows to lenses.", 5000, ResearchEra::CLASSICAL, ResearchCategory::CRAFTING, {L"STC"}, {L"Recipe: Glass", L"Recipe: Glass Pane"} };
+
+    // --- Medieval Era ---
+    g_allResearch[L"MED_MSC"] = { L"MED_MSC", L"Metal Casting", L"Master the techniques for casting molten metal, allowing for the creation of complex and sturdy metal items.", 4500, ResearchEra::MEDIEVAL, ResearchCategory::CRAFTING, {L"CLS_SMT", L"IRW"}, {L"Building: Blast Furnace", L"Unlocks advanced metal recipes"} };
+    g_allResearch[L"MED_CRB"] = { L"MED_CRB", L"Crossbows", L"Engineer powerful crossbows that are easier to use than conventional bows and have excellent armor penetration.", 3500, ResearchEra::MEDIEVAL, ResearchCategory::COMBAT, {L"BWW", L"CLS_SMT"}, {L"Recipe: Crossbow"} };
+    g_allResearch[L"MED_GLD"] = { L"MED_GLD", L"Guilds", L"Formalize craftsmenship into guilds, improving the quality and speed of production for specialized goods.", 4000, ResearchEra::MEDIEVAL, ResearchCategory::CRAFTING, {L"WRT", L"CUR"}, {L"Passive: +10% Crafting Speed"} };
+    g_allResearch[L"EDU"] = { L"EDU", L"Education", L"Establish formal schools and universities to greatly enhance learning and scientific discovery.", 7000, ResearchEra::MEDIEVAL, ResearchCategory::SCIENCE, {L"WRT", L"MAT"}, {L"Building: Advanced Research Bench", L"Building: Blackboard", L"Building: School Chair", L"Building: School Desk"} };
+    g_allResearch[L"CHV"] = { L"CHV", L"Chivalry", L"Develop a code of conduct and advanced combat techniques, improving military discipline and morale.", 3800, ResearchEra::MEDIEVAL, ResearchCategory::COMBAT, {L"CLS_SMT", L"HRB"}, {L"Recipe: Knight Armor", L"Recipe: Knight Weapons"} };
+    g_allResearch[L"CIV"] = { L"CIV", L"Civil Service", L"Establish a bureaucracy and organized governance for greater efficiency in managing your colony.", 4200, ResearchEra::MEDIEVAL, ResearchCategory::SCIENCE, {L"EDU"}, {L"Passive: +10% Work Speed"} };
+    g_allResearch[L"CMP"] = { L"CMP", L"Compass", L"Invent the magnetic compass, greatly aiding navigation and long-distance travel.", 3200, ResearchEra::MEDIEVAL, ResearchCategory::TRANSPORT, {L"OPT"}, {L"Recipe: Compass"} };
+    g_allResearch[L"MCH"] = { L"MCH", L"Machinery", L"Develop complex mechanical devices for improved resource extraction and production.", 5000, ResearchEra::MEDIEVAL, ResearchCategory::CRAFTING, {L"MED_MSC", L"ENG"}, {L"Building: Gear Press (future)", L"Recipe: Gears (future)"} };
+    g_allResearch[L"PHY"] = { L"PHY", L"Physics", L"Explore the fundamental laws of nature, laying the groundwork for future technological breakthroughs.", 4800, ResearchEra::MEDIEVAL, ResearchCategory::SCIENCE, {L"MAT"}, {L"Passive: +15% Research Speed"} };
+    g_allResearch[L"STL"] = { L"STL", L"Steel", L"Discover the process of making steel, a much stronger and more durable metal than iron or bronze.", 5500, ResearchEra::MEDIEVAL, ResearchCategory::CRAFTING, {L"MED_MSC"}, {L"Recipe: Steel Ingot"} };
+    g_allResearch[L"THL"] = { L"THL", L"Theology", L"Formalize spiritual beliefs, providing comfort and social cohesion for your colonists.", 3000, ResearchEra::MEDIEVAL, ResearchCategory::RECREATION, {L"CLS_PHL"}, {L"Building: Shrine (future)"} };
+    g_allResearch[L"FOR"] = { L"FOR", L"Fortification", L"Design and construct formidable defensive structures to withstand sieges.", 5200, ResearchEra::MEDIEVAL, ResearchCategory::SECURITY, {L"MAS", L"ENG"}, {L"Building: Watchtower (future)", L"Building: Drawbridge (future)"} };
+    g_allResearch[L"MIL_ENG"] = { L"MIL_ENG", L"Military Engineering", L"Combine engineering prowess with military tactics to build siege engines and defensive works in the field.", 5800, ResearchEra::MEDIEVAL, ResearchCategory::SECURITY, {L"ENG", L"CHV"}, {L"Recipe: Catapult (future)", L"Recipe: Ballista (future)"} };
+    g_allResearch[L"MIL_TAC"] = { L"MIL_TAC", L"Military Tactics", L"Study strategic and tactical principles to improve the effectiveness of your combat units.", 4500, ResearchEra::MEDIEVAL, ResearchCategory::COMBAT, {L"CHV", L"WRT"}, {L"Passive: +5% Combat Effectiveness"} };
+    g_allResearch[L"TOR"] = { L"TOR", L"Torture", L"Develop methods of extracting information or influencing behavior through coercion.", 3000, ResearchEra::MEDIEVAL, ResearchCategory::SECURITY, {L"CIV"}, {} };
+    g_allResearch[L"STI"] = { L"STI", L"Stirrups", L"Equip cavalry with stirrups for better stability and effectiveness in mounted combat.", 3500, ResearchEra::MEDIEVAL, ResearchCategory::ANIMALS, {L"HRB"}, {} };
+    g_allResearch[L"NOB_APP"] = { L"NOB_APP", L"Noble Apparel", L"Craft fine clothing and adornments befitting royalty and the aristocracy, signifying status and wealth.", 6000, ResearchEra::MEDIEVAL, ResearchCategory::APPAREL, {L"TXS", L"MED_GLD"}, {L"Recipe: Noble Dress", L"Recipe: Noble Tunic"} };
+    g_allResearch[L"ALCH"] = { L"ALCH", L"Alchemy", L"Experiment with chemical compounds and processes, seeking to transmute materials and unlock potent elixirs.", 7000, ResearchEra::RENAISSANCE, ResearchCategory::SCIENCE, {L"PHY"}, {L"Building: Alchemy Lab (future)"} };
+
+    // --- Renaissance Era ---
+    g_allResearch[L"REN_PRP"] = { L"REN_PRP", L"Printing Press", L"Create a machine that allows for the mass production of written works, dramatically accelerating research.", 6000, ResearchEra::RENAISSANCE, ResearchCategory::SCIENCE, {L"WRT", L"MCH"}, {L"Passive: +25% Research Speed", L"Building: Printing Press", L"Building: Typewriter"} };
+    g_allResearch[L"REN_GUN"] = { L"REN_GUN", L"Gunpowder", L"Experiment with black powder to create the first primitive firearms.", 7500, ResearchEra::RENAISSANCE, ResearchCategory::COMBAT, {L"MED_MSC", L"CHEM"}, {L"Recipe: Musket", L"Recipe: Gunpowder"} };
+    g_allResearch[L"REN_BNK"] = { L"REN_BNK", L"Banking", L"Develop complex economic systems and currency, enabling more efficient trade with off-world factions.", 6500, ResearchEra::RENAISSANCE, ResearchCategory::TECH, {L"MED_GLD", L"ECO"}, {L"Building: Trade Beacon (future)"} };
+    g_allResearch[L"ACS"] = { L"ACS", L"Acoustics", L"Study the science of sound, leading to improved communication and musical instruments.", 6000, ResearchEra::RENAISSANCE, ResearchCategory::SCIENCE, {L"PHY"}, {L"Building: Acoustic Wall"} };
+    g_allResearch[L"ARC_REN"] = { L"ARC_REN", L"Architecture", L"Master advanced building design and structural integrity for grander and more efficient constructions.", 7000, ResearchEra::RENAISSANCE, ResearchCategory::CONSTRUCTION, {L"ENG"}, {L"Building: Column"} };
+    g_allResearch[L"AST"] = { L"AST", L"Astronomy", L"Chart the stars and planets with improved observation tools, enhancing navigation and understanding of the cosmos.", 6800, ResearchEra::RENAISSANCE, ResearchCategory::SCIENCE, {L"OPT", L"MAT"}, {L"Building: Telescope"} };
+    g_allResearch[L"CHEM"] = { L"CHEM", L"Chemistry", L"Explore the fundamental composition of matter and chemical reactions, enabling new industrial processes.", 7200, ResearchEra::RENAISSANCE, ResearchCategory::SCIENCE, {L"PHY"}, {L"Building: Drug Lab", L"Recipe: Various Drugs", L"Recipe: Chemical Equipment"} };
+    g_allResearch[L"ECO"] = { L"ECO", L"Economics", L"Formulate theories of production, distribution, and consumption of goods, improving trade and resource management.", 6500, ResearchEra::RENAISSANCE, ResearchCategory::SCIENCE, {L"MED_GLD"}, {} };
+    g_allResearch[L"REN_MET"] = { L"REN_MET", L"Metallurgy", L"Advance the science of metals, leading to purer alloys and more sophisticated forging techniques.", 8000, ResearchEra::RENAISSANCE, ResearchCategory::CRAFTING, {L"MED_MSC", L"CHEM"}, {L"Recipe: Alloys"} };
+    g_allResearch[L"NAV"] = { L"NAV", L"Navigation", L"Develop advanced navigational instruments and techniques for accurate long-distance travel across oceans and plains.", 7500, ResearchEra::RENAISSANCE, ResearchCategory::TRANSPORT, {L"CMP", L"AST"}, {L"Recipe: Boat", L"Building: Lighthouse"} };
+    g_allResearch[L"SQR_RIG"] = { L"SQR_RIG", L"Square Rigging", L"Improve ship design with square rigs for faster and more efficient long-distance ocean travel.", 7800, ResearchEra::RENAISSANCE, ResearchCategory::TRANSPORT, {L"SAI", L"NAV"}, {} };
+    g_allResearch[L"SIE_TAC"] = { L"SIE_TAC", L"Siege Tactics", L"Master the art of assaulting and defending fortified positions with specialized military doctrines.", 8200, ResearchEra::RENAISSANCE, ResearchCategory::COMBAT, {L"FOR", L"MIL_ENG"}, {} };
+    g_allResearch[L"CAR"] = { L"CAR", L"Cartography", L"Create accurate maps of explored territories, enhancing navigation and strategic planning.", 7000, ResearchEra::RENAISSANCE, ResearchCategory::SCIENCE, {L"AST", L"WRT"}, {} };
+    g_allResearch[L"MAS_PRO"] = { L"MAS_PRO", L"Mass Production", L"Implement early forms of standardized production to create items more quickly and efficiently.", 7500, ResearchEra::RENAISSANCE, ResearchCategory::CRAFTING, {L"REN_MET", L"MCH"}, {L"Passive: +10% Production Speed"} };
+    g_allResearch[L"LAC"] = { L"LAC", L"Lacework", L"Develop intricate techniques for creating delicate, patterned fabrics used in high-fashion apparel.", 5500, ResearchEra::RENAISSANCE, ResearchCategory::APPAREL, {L"TXS"}, {L"Recipe: Lace Trim"} };
+    g_allResearch[L"OILP"] = { L"OILP", L"Oil Painting", L"Master the use of oil paints to create rich, vibrant, and lasting works of art.", 5800, ResearchEra::RENAISSANCE, ResearchCategory::RECREATION, {L"PAP", L"CHEM"}, {L"Building: Easel (future)"} };
+    g_allResearch[L"PERSP"] = { L"PERSP", L"Perspectives", L"Understand geometric perspective to create more realistic and immersive artistic representations.", 5200, ResearchEra::RENAISSANCE, ResearchCategory::SCIENCE, {L"MAT", L"WRT"}, {} };
+    
+
+    
+    
+
+    // --- Industrial Era ---
+    g_allResearch[L"IND_STM"] = { L"IND_STM", L"Steam Power", L"Harness the power of steam to drive machinery and generators, providing a powerful new energy source.", 9000, ResearchEra::INDUSTRIAL, ResearchCategory::POWER, {L"REN_MET", L"MCH"}, {L"Building: Steam Generator"} };
+    g_allResearch[L"IND_MAN"] = { L"IND_MAN", L"Manufacturing", L"Establish principles of industrial manufacturing to produce complex items in large quantities.", 10000, ResearchEra::INDUSTRIAL, ResearchCategory::CRAFTING, {L"EDU", L"MCH", L"ECO"}, {L"Building: Machining Table"} };
+    g_allResearch[L"IND_ELC"] = { L"IND_ELC", L"Electricity", L"Harness electricity to create light, heat, and power for advanced machinery.", 12000, ResearchEra::INDUSTRIAL, ResearchCategory::POWER, {L"IND_MAN", L"SCI_THE"}, {L"Building: Power Generator"} };
+    g_allResearch[L"IND_RFL"] = { L"IND_RFL", L"Rifling", L"Develop spiral grooves in gun barrels to dramatically improve the accuracy and range of firearms.", 9500, ResearchEra::INDUSTRIAL, ResearchCategory::COMBAT, {L"REN_GUN", L"IND_MAN"}, {L"Recipe: Rifles"} };
+    g_allResearch[L"IND_BIO"] = { L"IND_BIO", L"Biology", L"Gain a deep understanding of microbiology and genetics, paving the way for modern medicine and hydroponics.", 11000, ResearchEra::INDUSTRIAL, ResearchCategory::MEDICINE, {L"EDU", L"CHEM"}, {} };
+    g_allResearch[L"IND_ARC"] = { L"IND_ARC", L"Archaeology", L"Unearth ancient artifacts and ruins to gain historical knowledge and recover lost technologies.", 8500, ResearchEra::INDUSTRIAL, ResearchCategory::SCIENCE, {L"AST"}, {} };
+    g_allResearch[L"DYN"] = { L"DYN", L"Dynamite", L"Invent powerful explosives for efficient mining, demolition, and combat engineering.", 10500, ResearchEra::INDUSTRIAL, ResearchCategory::TECH, {L"CHEM", L"MIN"}, {L"Recipe: Dynamite"} };
+    g_allResearch[L"FRT"] = { L"FRT", L"Fertilizer", L"Develop chemical compounds to enrich soil, significantly boosting crop yields and farm efficiency.", 9800, ResearchEra::INDUSTRIAL, ResearchCategory::FARMING, {L"CHEM", L"AGR"}, {L"Recipe: Synthetic Fertilizer"} };
+    g_allResearch[L"IND_IND"] = { L"IND_IND", L"Industrialization", L"Mass production techniques and assembly lines revolutionize manufacturing, vastly increasing output.", 11500, ResearchEra::INDUSTRIAL, ResearchCategory::CRAFTING, {L"IND_MAN", L"IND_STM"}, {L"Passive: +20% Production Speed", L"Building: Assembly Line"} };
+    g_allResearch[L"MLS"] = { L"MLS", L"Military Science", L"Apply scientific principles to military tactics and logistics, leading to more effective armies.", 10800, ResearchEra::INDUSTRIAL, ResearchCategory::COMBAT, {L"CHV", L"IND_RFL"}, {L"Recipe: Advanced Armor"} };
+    g_allResearch[L"SCI_THE"] = { L"SCI_THE", L"Scientific Theory", L"Formalize the scientific method, enabling rapid advancements across all fields of study.", 10000, ResearchEra::INDUSTRIAL, ResearchCategory::SCIENCE, {L"PHY", L"EDU"}, {L"Passive: +30% Research Speed"} };
+    g_allResearch[L"TGR"] = { L"TGR", L"Telegraph", L"Invent the telegraph, allowing for instant, long-distance communication and improved coordination.", 12500, ResearchEra::INDUSTRIAL, ResearchCategory::TECH, {L"IND_ELC"}, {L"Building: Telegraph Station (future)"} };
+    g_allResearch[L"HLC"] = { L"HLC", L"Healthcare", L"Establish modern medical practices and facilities to improve colonist health and recovery.", 13000, ResearchEra::INDUSTRIAL, ResearchCategory::MEDICINE, {L"IND_BIO"}, {L"Building: Hospital Bed"} };
+    g_allResearch[L"HYD"] = { L"HYD", L"Hydroponics", L"Grow crops efficiently in nutrient-rich water solutions, allowing farming in harsh environments.", 14000, ResearchEra::INDUSTRIAL, ResearchCategory::FARMING, {L"IND_BIO", L"FRT"}, {L"Building: Hydroponics Basin"} };
+    g_allResearch[L"WIR"] = { L"WIR", L"Wiring", L"Develop insulated wires and switches to safely distribute electricity for lighting and simple machines.", 12800, ResearchEra::INDUSTRIAL, ResearchCategory::POWER, {L"IND_ELC"}, {L"Recipe: Wire", L"Recipe: Lightbulb", L"Building: Electric Lamp"} };
+    g_allResearch[L"ADV_LGT"] = { L"ADV_LGT", L"Advanced Lighting", L"Design and implement more efficient and powerful lighting solutions for larger areas.", 13500, ResearchEra::INDUSTRIAL, ResearchCategory::LIGHTS, {L"WIR"}, {L"Building: Floodlight (future)"} };
+    g_allResearch[L"SAN"] = { L"SAN", L"Sanitation", L"Implement advanced waste disposal and water treatment systems to prevent disease and improve hygiene.", 9000, ResearchEra::INDUSTRIAL, ResearchCategory::MEDICINE, {L"CHEM"}, {L"Building: Latrine (future)", L"Building: Water Filter (future)"} };
+    g_allResearch[L"BALL"] = { L"BALL", L"Ballistics", L"Study projectile motion and weapon design for more accurate and powerful firearms.", 10500, ResearchEra::INDUSTRIAL, ResearchCategory::COMBAT, {L"IND_RFL", L"PHY"}, {L"Recipe: Improved Firearms"} };
+    g_allResearch[L"PROSTH"] = { L"PROSTH", L"Prosthetics", L"Develop artificial limbs to replace lost body parts, restoring function to injured colonists.", 11800, ResearchEra::INDUSTRIAL, ResearchCategory::MEDICINE, {L"IND_BIO", L"IND_MAN"}, {L"Recipe: Simple Prosthetics"} };
+    g_allResearch[L"PNM"] = { L"PNM", L"Pneumatics", L"Harness compressed air to power simple mechanisms, improving efficiency in tools and manufacturing.", 11000, ResearchEra::INDUSTRIAL, ResearchCategory::TECH, {L"MCH"}, {L"Building: Pneumatic Press (future)"} };
+
+
+    // --- Modern Era ---
+    g_allResearch[L"MOD_ELC"] = { L"MOD_ELC", L"Electronics", L"Create complex circuits and vacuum tubes, the foundation of all modern technology.", 15000, ResearchEra::MODERN, ResearchCategory::TECH, {L"IND_ELC", L"SCI_THE"}, {L"Building: Comms Console", L"Recipe: Electronic Components"} };
+    g_allResearch[L"MOD_MEDP"] = { L"MOD_MEDP", L"Medicine Production", L"Mass produce medical supplies and pharmaceuticals, improving colony health and recovery rates.", 13000, ResearchEra::MODERN, ResearchCategory::MEDICINE, {L"IND_BIO", L"CHEM"}, {L"Recipe: Medicine"} };
+    g_allResearch[L"TEL"] = { L"TEL", L"Television", L"Broadcast visual information, enabling mass communication and entertainment.", 17000, ResearchEra::MODERN, ResearchCategory::TECH, {L"MOD_ELC"}, {L"Building: Television (future)"} };
+    g_allResearch[L"RAD"] = { L"RAD", L"Radio", L"Develop wireless communication, allowing for instant, long-range messaging.", 16500, ResearchEra::MODERN, ResearchCategory::TECH, {L"MOD_ELC", L"ACS"}, {L"Building: Radio"} };
+    g_allResearch[L"RLR"] = { L"RLR", L"Railroad", L"Construct extensive rail networks for efficient, high-volume transportation of goods and people.", 19000, ResearchEra::MODERN, ResearchCategory::TRANSPORT, {L"IND_IND", L"STL"}, {L"Building: Rail Tracks (future)", L"Building: Train Station (future)"} };
+    g_allResearch[L"REF"] = { L"REF", L"Refrigeration", L"Preserve food and other perishables for extended periods, reducing spoilage and waste.", 15500, ResearchEra::MODERN, ResearchCategory::COOKING, {L"IND_ELC"}, {L"Building: Freezer (future)"} };
+    g_allResearch[L"REP"] = { L"REP", L"Replaceable Parts", L"Standardize manufacturing to produce interchangeable components, speeding up repairs and construction.", 17500, ResearchEra::MODERN, ResearchCategory::CRAFTING, {L"IND_IND"}, {L"Passive: +15% Repair Speed"} };
+    g_allResearch[L"REFINE"] = { L"REFINE", L"Refining", L"Develop chemical processes for purifying raw materials like petroleum into useful fuels and byproducts.", 17000, ResearchEra::MODERN, ResearchCategory::CRAFTING, {L"MOD_CMB", L"CHEM"}, {L"Building: Refinery (future)", L"Recipe: Chemfuel"} };
+    g_allResearch[L"MOD_PLA"] = { L"MOD_PLA", L"Plastics", L"Learn to refine chemical precursors into versatile polymers for use in countless applications.", 16000, ResearchEra::MODERN, ResearchCategory::CRAFTING, {L"MOD_CMB", L"CHEM"}, {L"Recipe: Plastic"} };
+    g_allResearch[L"MOD_CMB"] = { L"MOD_CMB", L"Combustion", L"Invent the internal combustion engine, enabling vehicles and more efficient power generation.", 14000, ResearchEra::MODERN, ResearchCategory::POWER, {L"IND_STM", L"REN_MET"}, {L"Building: Chemfuel Generator"} };
+    g_allResearch[L"FLI"] = { L"FLI", L"Flight", L"Achieve powered flight, opening up new possibilities for transportation and aerial reconnaissance.", 18000, ResearchEra::MODERN, ResearchCategory::TRANSPORT, {L"MOD_CMB", L"ENG"}, {L"Building: Airstrip (future)"} };
+    g_allResearch[L"AUTO"] = { L"AUTO", L"Automobile", L"Develop wheeled vehicles powered by internal combustion engines for efficient personal and cargo transport.", 20000, ResearchEra::MODERN, ResearchCategory::TRANSPORT, {L"MOD_CMB", L"IND_IND", L"CLS_WHL"}, {L"Recipe: Automobile"}};
+    g_allResearch[L"EV"] = { L"EV", L"Electric Vehicles", L"Harness electricity to power vehicles, offering a cleaner and quieter alternative to combustion engines.", 22000, ResearchEra::MODERN, ResearchCategory::TRANSPORT, {L"MOD_CMB", L"IND_ELC"}, {L"Recipe: Electric Car"} };
+
+    // --- Atomic Era ---
+    g_allResearch[L"ENC"] = { L"ENC", L"Encryption", L"Implement advanced algorithms to secure data and communications, vital for sensitive operations.", 14500, ResearchEra::ATOMIC, ResearchCategory::SECURITY, {L"MOD_ELC"}, {L"Passive: Enhanced Data Security (future)"} };
+    g_allResearch[L"ATO_CMP"] = { L"ATO_CMP", L"Computers", L"Develop primitive computers based on transistor logic, allowing for complex calculations and automation.", 20000, ResearchEra::ATOMIC, ResearchCategory::TECH, {L"MOD_ELC", L"ENC"}, {L"Building: Hi-Tech Research Bench", L"Furniture: Computer", L"Furniture: Mouse", L"Furniture: Screen", L"Furniture: Keyboard"} };
+    g_allResearch[L"ATO_RCK"] = { L"ATO_RCK", L"Rocketry", L"Develop powerful rockets capable of escaping the planet's gravitational pull.", 25000, ResearchEra::ATOMIC, ResearchCategory::SPACE, {L"MOD_CMB", L"PHY"}, {L"Building: Ship Engine Parts"} };
+    g_allResearch[L"ATO_NUC"] = { L"ATO_NUC", L"Nuclear Fission", L"Split the atom to release immense amounts of energy, providing a powerful but dangerous new power source.", 30000, ResearchEra::ATOMIC, ResearchCategory::POWER, {L"ATO_CMP", L"ATOT"}, {L"Building: Nuclear Reactor (future)"} };
+    g_allResearch[L"ATOT"] = { L"ATOT", L"Atomic Theory", L"Delve into the structure of atoms, leading to advancements in energy and materials science.", 22000, ResearchEra::ATOMIC, ResearchCategory::SCIENCE, {L"SCI_THE", L"CHEM"}, {} };
+    g_allResearch[L"CBA"] = { L"CBA", L"Combined Arms", L"Integrate different military branches for synergistic combat strategies.", 21000, ResearchEra::ATOMIC, ResearchCategory::COMBAT, {L"MLS", L"FLI"}, {} };
+    g_allResearch[L"ATO_ECO"] = { L"ATO_ECO", L"Ecology", L"Understand the interactions between organisms and their environment, enabling sustainable resource management.", 20500, ResearchEra::ATOMIC, ResearchCategory::FARMING, {L"IND_BIO", L"ECO"}, {} };
+    g_allResearch[L"ATO_RAD"] = { L"ATO_RAD", L"Radar", L"Utilize radio waves to detect objects and measure their range and speed, crucial for defense and navigation.", 23000, ResearchEra::ATOMIC, ResearchCategory::TECH, {L"RAD"}, {} };
+    g_allResearch[L"ADV_FLI"] = { L"ADV_FLI", L"Advanced Flight", L"Push the boundaries of atmospheric and sub-orbital flight, enabling faster and more efficient travel.", 26000, ResearchEra::ATOMIC, ResearchCategory::TRANSPORT, {L"FLI", L"ATO_RCK"}, {L"Recipe: Advanced Aircraft"} };
+    g_allResearch[L"AT_BAL"] = { L"AT_BAL", L"Advanced Ballistics", L"Refine projectile physics for unparalleled accuracy and destructive power in weaponry.", 28000, ResearchEra::ATOMIC, ResearchCategory::COMBAT, {L"BALL", L"ATOT"}, {L"Recipe: High-Velocity Rounds"} };
+    g_allResearch[L"SYN_MAT"] = { L"SYN_MAT", L"Synthetic Materials", L"Engineer new materials with superior properties by manipulating molecular structures.", 24000, ResearchEra::ATOMIC, ResearchCategory::CRAFTING, {L"MOD_PLA", L"ATOT"}, {L"Recipe: Synthetics"} };
+    g_allResearch[L"ARCADE"] = { L"ARCADE", L"Arcades", L"Create interactive entertainment centers that provide amusement and recreation for colonists.", 21000, ResearchEra::ATOMIC, ResearchCategory::RECREATION, {L"ATO_CMP"}, {L"Building: Arcade Cabinet (future)"} }; // NEW
+    g_allResearch[L"AER"] = { L"AER", L"Aerogels", L"Synthesize ultra-lightweight, highly insulative materials with diverse applications in construction and space travel.", 23000, ResearchEra::ATOMIC, ResearchCategory::CRAFTING, {L"SYN_MAT", L"CHEM"}, {L"Recipe: Aerogel Panels (future)", L"Passive: Improved Insulation (future)"} }; // NEW
+    g_allResearch[L"MECH"] = { L"MECH", L"Mechs", L"Design and construct large, bipedal combat machines, providing powerful mobile firepower.", 27000, ResearchEra::ATOMIC, ResearchCategory::COMBAT, {L"CBA", L"IND_IND"}, {L"Building: Mech Hangar (future)", L"Recipe: Light Combat Mech (future)"} }; // NEW
+    g_allResearch[L"MED_IMG"] = { L"MED_IMG", L"Medical Imaging", L"Develop advanced techniques for visualizing internal body structures, greatly improving diagnosis and treatment.", 24000, ResearchEra::ATOMIC, ResearchCategory::MEDICINE, {L"HLC", L"ATO_RAD"}, {L"Building: Medical Scanner (future)", L"Passive: Faster Diagnosis (future)"} }; // NEW
+    g_allResearch[L"RDL"] = { L"RDL", L"Radioluminescence", L"Harness the emission of light from radioactive materials for long-lasting, self-powered illumination.", 26000, ResearchEra::ATOMIC, ResearchCategory::LIGHTS, {L"ATO_NUC"}, {L"Recipe: Radiocells (future)", L"Building: Radioluminescent Lights (future)"} }; // NEW
+    g_allResearch[L"SPL"] = { L"SPL", L"Specialized Limbs", L"Engineer prosthetics with enhanced functionality beyond basic replacement, for specific tasks or combat.", 25000, ResearchEra::ATOMIC, ResearchCategory::MEDICINE, {L"PROSTH", L"SYN_MAT"}, {L"Recipe: Mining Arm (future)", L"Recipe: Combat Leg (future)"} }; // NEW
+    g_allResearch[L"VDG"] = { L"VDG", L"Videogames", L"Create complex interactive digital experiences for recreation and cognitive training.", 22000, ResearchEra::ATOMIC, ResearchCategory::RECREATION, {L"ATO_CMP", L"ARCADE"}, {L"Recipe: Game Cartridge (future)", L"Recreation: Video Games (future)"} }; // NEW
+
+    // --- Information Era ---
+    g_allResearch[L"INF_ROB"] = { L"INF_ROB", L"Robotics", L"Create autonomous robots to perform simple tasks like cleaning and hauling.", 35000, ResearchEra::INFORMATION, ResearchCategory::CRAFTING, {L"ATO_CMP", L"MCH"}, {L"Recipe: Hauling & Cleaning Bots"} };
+    g_allResearch[L"INF_SAT"] = { L"INF_SAT", L"Satellites", L"Launch satellites into orbit to provide global communications, weather prediction, and resource scanning.", 40000, ResearchEra::INFORMATION, ResearchCategory::SPACE, {L"ATO_RCK", L"TGR"}, {L"Unlocks Orbital Scanners & Trade Ships (future)"} };
+    g_allResearch[L"INF_FAB"] = { L"INF_FAB", L"Advanced Fabrication", L"Construct highly advanced fabrication benches capable of creating complex components and spacer-tech items.", 50000, ResearchEra::INFORMATION, ResearchCategory::CRAFTING, {L"INF_ROB", L"REP"}, {L"Building: Fabrication Bench"} };
+    g_allResearch[L"GLO"] = { L"GLO", L"Globalization", L"Establish interstellar trade networks and diplomatic relations across vast distances.", 42000, ResearchEra::INFORMATION, ResearchCategory::HOSPITALITY, {L"CUR", L"INF_SAT"}, {L"Unlocks Faction Trading (future)"} };
+    g_allResearch[L"LAS"] = { L"LAS", L"Lasers", L"Harness coherent light for cutting, communication, and powerful directed-energy weapons.", 45000, ResearchEra::INFORMATION, ResearchCategory::COMBAT, {L"OPT", L"PHY"}, {L"Recipe: Laser Rifle"} };
+    g_allResearch[L"MOB_TAC"] = { L"MOB_TAC", L"Mobile Tactics", L"Develop rapid deployment and maneuver warfare strategies for highly agile combat units.", 37000, ResearchEra::INFORMATION, ResearchCategory::COMBAT, {L"CBA"}, {} };
+    g_allResearch[L"NUF"] = { L"NUF", L"Nuclear Fusion", L"Unlock the power of the stars by fusing atomic nuclei, providing limitless clean energy.", 60000, ResearchEra::INFORMATION, ResearchCategory::POWER, {L"ATO_NUC", L"PAR_PHY"}, {L"Building: Fusion Reactor (future)"} };
+    g_allResearch[L"PAR_PHY"] = { L"PAR_PHY", L"Particle Physics", L"Investigate subatomic particles and fundamental forces, pushing the boundaries of scientific knowledge.", 48000, ResearchEra::INFORMATION, ResearchCategory::SCIENCE, {L"ATOT"}, {L"Passive: +40% Research Speed"} };
+    g_allResearch[L"AIT"] = { L"AIT", L"Artificial Intelligence", L"Create advanced sentient AI, revolutionizing automation and decision-making.", 55000, ResearchEra::INFORMATION, ResearchCategory::TECH, {L"INF_ROB", L"ATO_CMP"}, {L"Building: AI Core (future)"} };
+    g_allResearch[L"SDE"] = { L"SDE", L"Smart Devices", L"Integrate miniature computers into everyday objects, enhancing convenience and control.", 36000, ResearchEra::INFORMATION, ResearchCategory::TECH, {L"ATO_CMP", L"MOD_ELC"}, {L"Recipe: Comm Device", L"Recipe: Smartphone", L"Recipe: Tablet", L"Recipe: Smartwatch"} };
+    g_allResearch[L"TCM"] = { L"TCM", L"Telecommunication", L"Establish global communication networks via satellite and fiber optics.", 40000, ResearchEra::INFORMATION, ResearchCategory::TECH, {L"TGR", L"INF_SAT"}, {L"Building: Global Comm Hub (future)"} };
+    g_allResearch[L"INT"] = { L"INT", L"Internet", L"Create a vast, interconnected global network for rapid data exchange and information sharing.", 43000, ResearchEra::INFORMATION, ResearchCategory::TECH, {L"TCM", L"ATO_CMP"}, {L"Passive: +10% Global Work Speed", L"Unlock: Internetwork Access in Computers and Smart Devices", L"Building: Server", L"Building: Switch", L"Building: Router"} };
+    g_allResearch[L"INF_STH"] = { L"INF_STH", L"Stealth", L"Develop technologies to evade detection, crucial for espionage and covert operations.", 40000, ResearchEra::INFORMATION, ResearchCategory::SECURITY, {L"AT_BAL"}, {L"Recipe: Stealth Suit"} };
+    g_allResearch[L"REN_EN"] = { L"REN_EN", L"Renewable Energy", L"Develop sustainable power sources that harness natural phenomena, reducing reliance on fossil fuels.", 38000, ResearchEra::INFORMATION, ResearchCategory::POWER, {L"IND_ELC", L"ATO_ECO"}, {L"Building: Wind Turbine", L"Building: Solar Panel (future)"} };
+    g_allResearch[L"GEO_P"] = { L"GEO_P", L"Geothermal Power", L"Tap into the Earth's internal heat to generate clean, consistent energy.", 41000, ResearchEra::INFORMATION, ResearchCategory::POWER, {L"REN_EN", L"ENG"}, {L"Building: Geothermal Generator (future)"} };
+    g_allResearch[L"GUI_SYS"] = { L"GUI_SYS", L"Guidance Systems", L"Create sophisticated systems for automated navigation and precision targeting in vehicles and missiles.", 46000, ResearchEra::INFORMATION, ResearchCategory::TECH, {L"ATO_RAD", L"ATO_CMP"}, {L"Recipe: GPS Module"} };
+    g_allResearch[L"COMPO"] = { L"COMPO", L"Composites", L"Engineer advanced composite materials by combining different substances, yielding high strength-to-weight ratios.", 44000, ResearchEra::INFORMATION, ResearchCategory::CRAFTING, {L"SYN_MAT"}, {L"Recipe: Composite Panels"} };
+    g_allResearch[L"BIO"] = { L"BIO", L"Bionics", L"Integrate mechanical and electronic components with biological systems to create advanced prosthetics and implants.", 49000, ResearchEra::INFORMATION, ResearchCategory::MEDICINE, {L"PROSTH", L"INF_ROB"}, {L"Recipe: Bionic Arm"} };
+    g_allResearch[L"VRT"] = { L"VRT", L"Virtual Reality", L"Construct immersive virtual environments for training, entertainment, and advanced simulation.", 18000, ResearchEra::INFORMATION, ResearchCategory::RECREATION, {L"MOD_ELC"}, {L"Building: VR Station (future)", L"Recipe: VR Headset (future)"} }; // NEW
+    g_allResearch[L"BLC"] = { L"BLC", L"Blockchain", L"Implement a decentralized ledger system for secure and transparent transactions, revolutionizing trade and record-keeping.", 19000, ResearchEra::INFORMATION, ResearchCategory::TECH, {L"TGR"}, {L"Passive: Enhanced Trade Security (future)", L"Unlocks: Digital Currencies (future)"} }; // NEW
+    g_allResearch[L"CLN"] = { L"CLN", L"Cloning", L"Uncover the secrets of genetic replication, allowing for the creation of new lifeforms or the rapid healing of tissues.", 20000, ResearchEra::INFORMATION, ResearchCategory::MEDICINE, {L"IND_BIO"}, {L"Recipe: Cloning Vat (future)", L"Passive: Faster Healing (future)"} }; // NEW
+    g_allResearch[L"CLC"] = { L"CLC", L"Cloud Computing", L"Develop networked computing resources that can be accessed remotely, enabling scalable data processing and collaboration.", 17500, ResearchEra::INFORMATION, ResearchCategory::TECH, {L"TGR"}, {L"Building: Server Farm (future)", L"Passive: Increased Research Speed (future)"} }; // NEW
+    g_allResearch[L"CRG"] = { L"CRG", L"Cryptography", L"Devise secure communication methods to protect sensitive information from interception and tampering.", 16000, ResearchEra::INFORMATION, ResearchCategory::SECURITY, {L"MOD_ELC", L"ENC"}, {L"Passive: Enhanced Communication Security (future)"} }; // NEW
+    g_allResearch[L"CYS"] = { L"CYS", L"Cybersecurity", L"Implement defensive measures to protect digital systems and networks from malicious attacks and data breaches.", 18500, ResearchEra::INFORMATION, ResearchCategory::SECURITY, {L"CLC", L"CRG"}, {L"Building: Firewall (future)", L"Passive: Improved Network Resilience (future)"} }; // NEW
+    g_allResearch[L"DRN"] = { L"DRN", L"Drone Swarms", L"Design and control synchronized groups of autonomous drones for surveillance, transport, or combat operations.", 19500, ResearchEra::INFORMATION, ResearchCategory::COMBAT, {L"FLI", L"MOD_ELC"}, {L"Recipe: Combat Drone (future)", L"Work: Drone Piloting (future)"} }; // NEW
+    g_allResearch[L"HLG"] = { L"HLG", L"Holograms", L"Project three-dimensional images using light interference, allowing for advanced displays and communication.", 17000, ResearchEra::INFORMATION, ResearchCategory::TECH, {L"OPT"}, {L"Building: Holographic Projector (future)"} }; // NEW
+    g_allResearch[L"OPF"] = { L"OPF", L"Optic Fibers", L"Develop thin strands of glass or plastic for transmitting light signals over long distances, greatly improving data transfer.", 16500, ResearchEra::INFORMATION, ResearchCategory::TECH, {L"MOD_ELC"}, {L"Recipe: Fiber Optic Cable (future)", L"Passive: Increased Communication Range (future)"} }; // NEW
+
+
+    // --- Cybernetic Era ---
+    g_allResearch[L"ADV_AI"] = { L"ADV_AI", L"Advanced AI", L"Develop true sentient artificial intelligence capable of complex reasoning and independent learning.", 65000, ResearchEra::CYBERNETIC, ResearchCategory::TECH, {L"AIT", L"PAR_PHY"}, {L"Unlock: AI Colonists (future)"} };
+    g_allResearch[L"PWR_CEL"] = { L"PWR_CEL", L"Power Cells", L"Create highly efficient, compact energy storage devices for portable power.", 62000, ResearchEra::CYBERNETIC, ResearchCategory::POWER, {L"NUF", L"SYN_MAT"}, {L"Recipe: Power Cell"} };
+    g_allResearch[L"CYB"] = { L"CYB", L"Cybernetics", L"Directly interface technology with biological systems to augment human capabilities and treat severe injuries.", 70000, ResearchEra::CYBERNETIC, ResearchCategory::MEDICINE, {L"BIO", L"ADV_AI"}, {L"Recipe: Cybernetic Implants"} };
+    g_allResearch[L"PRE_SYS"] = { L"PRE_SYS", L"Predictive Systems", L"Develop sophisticated algorithms to analyze vast datasets and predict future events with high accuracy.", 68000, ResearchEra::CYBERNETIC, ResearchCategory::SCIENCE, {L"INT", L"ADV_AI"}, {L"Passive: Early Warning Systems"} };
+    g_allResearch[L"SEA"] = { L"SEA", L"Seasteads", L"Design and construct self-sustaining floating platforms for expanding habitable territory on water worlds.", 75000, ResearchEra::CYBERNETIC, ResearchCategory::CONSTRUCTION, {L"COMPO", L"ARC_REN", L"NAV"}, {L"Building: Modular Seastead (future)"} };
+    g_allResearch[L"SMT_MAT"] = { L"SMT_MAT", L"Smart Materials", L"Engineer materials that can react to external stimuli by changing their properties, enabling adaptive structures.", 67000, ResearchEra::CYBERNETIC, ResearchCategory::CRAFTING, {L"SYN_MAT", L"NUF"}, {L"Recipe: Self-Repairing Alloys"} };
+    g_allResearch[L"OFF_MIS"] = { L"OFF_MIS", L"Offworld Missions", L"Equip your colony for sustained operations beyond the homeworld, including deep space exploration.", 80000, ResearchEra::CYBERNETIC, ResearchCategory::SPACE, {L"INF_SAT", L"PWR_CEL", L"GUI_SYS"}, {L"Unlock: Interstellar Travel (future)"} };
+    g_allResearch[L"AND"] = { L"AND", L"Androids", L"Construct advanced humanoid robots with sophisticated AI, capable of performing complex tasks autonomously.", 70000, ResearchEra::CYBERNETIC, ResearchCategory::TECH, {L"ADV_AI", L"SMT_MAT"}, {L"Recruit: Basic Android (future)", L"Recipe: Android Chassis (future)"} }; // NEW
+    g_allResearch[L"EXO"] = { L"EXO", L"Exoskeletons", L"Develop powered external frameworks to augment strength and endurance for combat or heavy labor.", 65000, ResearchEra::CYBERNETIC, ResearchCategory::COMBAT, {L"CYB", L"SMT_MAT"}, {L"Recipe: Power Armor (future)", L"Recipe: Cargo Exoskeleton (future)"} }; // NEW
+    g_allResearch[L"GNBL"] = { L"GNBL", L"Gunblades", L"Integrate melee weapons with firearm capabilities, allowing for versatile combat styles.", 68000, ResearchEra::CYBERNETIC, ResearchCategory::COMBAT, {L"LAS", L"EXO"}, {L"Recipe: Prototype Gunblade (future)"} }; // NEW
+    g_allResearch[L"NEUCOMP"] = { L"NEUCOMP", L"Neural Computation", L"Develop computing systems that mimic biological neural networks, enabling advanced pattern recognition and learning.", 72000, ResearchEra::CYBERNETIC, ResearchCategory::SCIENCE, {L"ADV_AI", L"PAR_PHY"}, {L"Passive: Faster AI Learning (future)"} }; // NEW
+    g_allResearch[L"QUANTC"] = { L"QUANTC", L"Quantum Computing", L"Harness quantum-mechanical phenomena to perform calculations far beyond classical computers, breaking modern encryption.", 75000, ResearchEra::CYBERNETIC, ResearchCategory::TECH, {L"NEUCOMP"}, {L"Building: Quantum Computer (future)", L"Passive: Uncrackable Encryption (future)"} }; // NEW
+    g_allResearch[L"SMTWPN"] = { L"SMTWPN", L"Smart Weapons", L"Integrate advanced guidance systems and AI into projectile and energy weapons for unprecedented accuracy and lethality.", 69000, ResearchEra::CYBERNETIC, ResearchCategory::COMBAT, {L"GUI_SYS", L"AT_BAL"}, {L"Recipe: Smart Rifle (future)", L"Recipe: Guided Missile (future)"} }; // NEW
+    g_allResearch[L"ECOTHEORY"] = { L"ECOTHEORY", L"Ecotheory", L"Gain a profound understanding of planetary ecosystems, enabling advanced terraforming and environmental control.", 66000, ResearchEra::CYBERNETIC, ResearchCategory::SCIENCE, {L"ATO_ECO", L"PAR_PHY"}, {L"Passive: Terraforming Research (future)"} }; // NEW
+    g_allResearch[L"HEALFAC"] = { L"HEALFAC", L"Healing Factors", L"Manipulate biological regeneration processes to drastically accelerate wound healing and recovery from injury.", 71000, ResearchEra::CYBERNETIC, ResearchCategory::MEDICINE, {L"CYB", L"CLN"}, {L"Recipe: Regeneration Serum (future)", L"Passive: Rapid Healing for Colonists (future)"} }; // NEW
+    g_allResearch[L"MOLANA"] = { L"MOLANA", L"Molecular Analysis", L"Develop tools to analyze and manipulate matter at the molecular level, crucial for advanced synthesis and materials science.", 73000, ResearchEra::CYBERNETIC, ResearchCategory::SCIENCE, {L"SMT_MAT", L"PAR_PHY"}, {L"Building: Molecular Assembler (future)", L"Passive: Increased Crafting Efficiency (future)"} }; // NEW
+
+    // --- Interstellar Era ---
+    g_allResearch[L"ARCO"] = { L"ARCO", L"Arcologies", L"Design and construct massive, self-contained multi-story habitats capable of housing entire populations.", 90000, ResearchEra::INTERSTELLAR, ResearchCategory::CONSTRUCTION, {L"SEA", L"ENG"}, {L"Building: Basic Arcology (future)"} }; // NEW
+    g_allResearch[L"IONT"] = { L"IONT", L"Ion Thrusters", L"Develop highly efficient propulsion systems that use ionized particles for long-duration interstellar travel.", 95000, ResearchEra::INTERSTELLAR, ResearchCategory::SPACE, {L"OFF_MIS", L"NUF"}, {L"Building: Ion Engine (future)", L"Passive: Faster Interstellar Travel (future)"} }; // NEW
+    g_allResearch[L"THTR"] = { L"THTR", L"Thermal Thrusters", L"Engineer propulsion systems that heat propellant using nuclear fission or fusion for powerful, sustained thrust.", 92000, ResearchEra::INTERSTELLAR, ResearchCategory::SPACE, {L"OFF_MIS", L"ATO_NUC"}, {L"Building: Thermal Engine (future)", L"Passive: Increased Ship Speed (future)"} }; // NEW
+    g_allResearch[L"WHR"] = { L"WHR", L"Waste Heat Recovery", L"Implement advanced systems to capture and convert waste heat into usable energy, dramatically improving efficiency.", 88000, ResearchEra::INTERSTELLAR, ResearchCategory::POWER, {L"PWR_CEL", L"SMT_MAT"}, {L"Passive: +20% Power Efficiency (future)"} }; // NEW
+}
+
+// --- String Utility Function ---
+std::wstring replacePlaceholder(std::wstring original, const std::wstring& placeholder, const std::wstring& value) {
+    size_t pos = 0;
+    while ((pos = original.find(placeholder, pos)) != std::wstring::npos) {
+        original.replace(pos, placeholder.length(), value);
+        pos += value.length();
+    }
+    return original;
+}
+
+void generateOresInStratum(int z, const StratumInfo& sInfo,
+    const std::set<TileType>& sedimentaryStones,
+    const std::set<TileType>& igneousExtrusiveStones,
+    const std::set<TileType>& igneousIntrusiveStones,
+    const std::set<TileType>& metamorphicStones,
+    const std::set<TileType>& allIgneousStones,
+    const std::set<TileType>& allStones,
+    uint64_t mapSeed);
+
+// NEW: Helper function to read names from a text file (one name per line)
+std::vector<std::wstring> readNamesFromFile(const std::string& filePath) {
+    std::vector<std::wstring> names;
+    std::wifstream file(filePath);
+
+    if (!file.is_open()) {
+        return names; // Return empty vector if file can't be opened
+    }
+
+    // Set the locale to handle UTF-8 files correctly
+    file.imbue(std::locale(file.getloc(), new std::codecvt_utf8<wchar_t>));
+
+    std::wstring line;
+    while (std::getline(file, line)) {
+        // Remove potential carriage return at the end of the line
+        if (!line.empty() && line.back() == L'\r') {
+            line.pop_back();
+        }
+        // Add non-empty lines to our list
+        if (!line.empty()) {
+            names.push_back(line);
+        }
+    }
+
+    file.close();
+    return names;
+}
+
+void initGameData() {
+
+    int TROPOSPHERE_TOP_Z_LEVEL = 0;
+
+    TILE_DATA.clear();
+    // Base Tiles
+    TILE_DATA[TileType::EMPTY] = { L"Empty Space", L' ', makeColor(0,0,0), {}, TileType::EMPTY, 0.0f, 0.0f };
+    TILE_DATA[TileType::DIRT_FLOOR] = { L"Dirt", L'.', makeColor(139,69,19), {TileTag::DIRT, TileTag::SOIL}, TileType::EMPTY };
+    TILE_DATA[TileType::GRASS] = { L"Grass", L'.', makeColor(34,139,34), {TileTag::DIRT, TileTag::SOIL}, TileType::EMPTY };
+    TILE_DATA[TileType::JUNGLE_GRASS] = { L"Jungle Grass", L'.', makeColor(0, 100, 0), {TileTag::DIRT, TileTag::SOIL}, TileType::EMPTY };
+    TILE_DATA[TileType::SAND] = { L"Sand", L'~', makeColor(244,164,96), {TileTag::DIRT, TileTag::SOIL}, TileType::EMPTY };
+    TILE_DATA[TileType::SNOW] = { L"Snow", L'·', makeColor(255,250,250), {TileTag::DIRT, TileTag::SOIL}, TileType::EMPTY };
+    TILE_DATA[TileType::ICE] = { L"Ice", L'#', makeColor(173,216,230), {TileTag::DIRT}, TileType::EMPTY };
+    TILE_DATA[TileType::STONE_FLOOR] = { L"Stone Floor", L'.', makeColor(80, 80, 80), {TileTag::SOIL}, TileType::EMPTY };
+    TILE_DATA[TileType::WOOD_FLOOR] = { L"Wood Floor", L'=', makeColor(160, 82, 45), {TileTag::SOIL, TileTag::STRUCTURE}, TileType::EMPTY };
+
+    // Stones
+    TILE_DATA[TileType::CHALK] = { L"Chalk", L'#', makeColor(245,245,245), {TileTag::STONE, TileTag::SEDIMENTARY}, TileType::CHALK_CHUNK, 1.0f, 0.5f };
+    TILE_DATA[TileType::CHERT] = { L"Chert", L'#', makeColor(210,180,140), {TileTag::STONE, TileTag::SEDIMENTARY}, TileType::CHERT_CHUNK, 1.2f, 0.6f };
+    TILE_DATA[TileType::CLAYSTONE] = { L"Claystone", L'#', makeColor(188,143,143), {TileTag::STONE, TileTag::SEDIMENTARY}, TileType::CLAYSTONE_CHUNK, 0.9f, 0.4f };
+    TILE_DATA[TileType::CONGLOMERATE] = { L"Conglomerate", L'#', makeColor(160,160,160), {TileTag::STONE, TileTag::SEDIMENTARY}, TileType::CONGLOMERATE_CHUNK, 1.5f, 0.7f };
+    TILE_DATA[TileType::DOLOMITE] = { L"Dolomite", L'#', makeColor(192,192,192), {TileTag::STONE, TileTag::SEDIMENTARY}, TileType::DOLOMITE_CHUNK, 1.3f, 0.6f };
+    TILE_DATA[TileType::LIMESTONE] = { L"Limestone", L'#', makeColor(211,211,211), {TileTag::STONE, TileTag::SEDIMENTARY}, TileType::LIMESTONE_CHUNK, 1.1f, 0.5f };
+    TILE_DATA[TileType::MUDSTONE] = { L"Mudstone", L'#', makeColor(139,115,85), {TileTag::STONE, TileTag::SEDIMENTARY}, TileType::MUDSTONE_CHUNK, 0.8f, 0.3f };
+    TILE_DATA[TileType::ROCK_SALT] = { L"Rock Salt", L'#', makeColor(255,228,225), {TileTag::STONE, TileTag::SEDIMENTARY}, TileType::ROCK_SALT_CHUNK, 0.7f, 0.9f }; // High value for salt
+    TILE_DATA[TileType::SANDSTONE] = { L"Sandstone", L'#', makeColor(218,165,32), {TileTag::STONE, TileTag::SEDIMENTARY}, TileType::SANDSTONE_CHUNK, 1.0f, 0.5f };
+    TILE_DATA[TileType::SHALE] = { L"Shale", L'#', makeColor(128,128,128), {TileTag::STONE, TileTag::SEDIMENTARY}, TileType::SHALE_CHUNK, 1.1f, 0.4f };
+    TILE_DATA[TileType::SILTSTONE] = { L"Siltstone", L'#', makeColor(198,179,155), {TileTag::STONE, TileTag::SEDIMENTARY}, TileType::SILTSTONE_CHUNK, 1.0f, 0.45f };
+    TILE_DATA[TileType::DIORITE] = { L"Diorite", L'#', makeColor(119,136,153), {TileTag::STONE, TileTag::IGNEOUS_INTRUSIVE}, TileType::DIORITE_CHUNK, 1.8f, 0.9f };
+    TILE_DATA[TileType::GABBRO] = { L"Gabbro", L'#', makeColor(80,80,80), {TileTag::STONE, TileTag::IGNEOUS_INTRUSIVE}, TileType::GABBRO_CHUNK, 2.0f, 1.0f };
+    TILE_DATA[TileType::GRANITE] = { L"Granite", L'#', makeColor(150,150,150), {TileTag::STONE, TileTag::IGNEOUS_INTRUSIVE}, TileType::GRANITE_CHUNK, 7.0f, 1.2f }; // Original value
+    TILE_DATA[TileType::ANDESITE] = { L"Andesite", L'#', makeColor(130,130,130), {TileTag::STONE, TileTag::IGNEOUS_EXTRUSIVE}, TileType::ANDESITE_CHUNK, 1.6f, 0.8f };
+    TILE_DATA[TileType::BASALT] = { L"Basalt", L'#', makeColor(40,40,40), {TileTag::STONE, TileTag::IGNEOUS_EXTRUSIVE}, TileType::BASALT_CHUNK, 1.9f, 0.95f };
+    TILE_DATA[TileType::DACITE] = { L"Dacite", L'#', makeColor(180,180,180), {TileTag::STONE, TileTag::IGNEOUS_EXTRUSIVE}, TileType::DACITE_CHUNK, 1.7f, 0.85f };
+    TILE_DATA[TileType::OBSIDIAN] = { L"Obsidian", L'#', makeColor(20,20,20), {TileTag::STONE, TileTag::IGNEOUS_EXTRUSIVE}, TileType::OBSIDIAN_CHUNK, 2.5f, 1.5f }; // Higher value for obsidian
+    TILE_DATA[TileType::RHYOLITE] = { L"Rhyolite", L'#', makeColor(255,192,203), {TileTag::STONE, TileTag::IGNEOUS_EXTRUSIVE}, TileType::RHYOLITE_CHUNK, 1.5f, 0.75f };
+    TILE_DATA[TileType::GNEISS] = { L"Gneiss", L'#', makeColor(105,105,105), {TileTag::STONE, TileTag::METAMORPHIC}, TileType::GNEISS_CHUNK, 2.2f, 1.1f };
+    TILE_DATA[TileType::MARBLE] = { L"Marble", L'#', makeColor(255,250,250), {TileTag::STONE, TileTag::METAMORPHIC}, TileType::MARBLE_CHUNK, 2.3f, 1.3f };
+    TILE_DATA[TileType::PHYLLITE] = { L"Phyllite", L'#', makeColor(176,196,222), {TileTag::STONE, TileTag::METAMORPHIC}, TileType::PHYLLITE_CHUNK, 2.0f, 1.0f };
+    TILE_DATA[TileType::QUARTZITE] = { L"Quartzite", L'#', makeColor(238,232,170), {TileTag::STONE, TileTag::METAMORPHIC}, TileType::QUARTZITE_CHUNK, 2.4f, 1.2f };
+    TILE_DATA[TileType::SCHIST] = { L"Schist", L'#', makeColor(0,128,128), {TileTag::STONE, TileTag::METAMORPHIC}, TileType::SCHIST_CHUNK, 2.1f, 1.05f };
+    TILE_DATA[TileType::SLATE] = { L"Slate", L'#', makeColor(70,70,70), {TileTag::STONE, TileTag::METAMORPHIC}, TileType::SLATE_CHUNK, 1.9f, 0.9f };
+    TILE_DATA[TileType::CORESTONE] = { L"Corestone", L'#', makeColor(25,25,25), {TileTag::STONE, TileTag::INNER_STONE}, TileType::CORESTONE_CHUNK, 10.0f, 5.0f }; // Very high hardness/value
+    TILE_DATA[TileType::WATER] = { L"Water", L'~', makeColor(0,0,139), {TileTag::WATER, TileTag::FLUID}, TileType::EMPTY };
+    TILE_DATA[TileType::MOLTEN_CORE] = { L"Molten Core", L'~', makeColor(255,100,0), {TileTag::WATER, TileTag::FLUID}, TileType::EMPTY };
+    TILE_DATA[TileType::RICH_MINERALS] = { L"Rich Minerals", L'%', makeColor(255,215,0), {TileTag::MINERAL}, TileType::EMPTY, 3.0f, 10.0f };
+
+
+    // Base types (for spawning logic) - These are not items, they are world features.
+    TILE_DATA[TileType::OAK] = { L"Oak Tree", L' ', makeColor(0,0,0), {}, TileType::OAK_WOOD, 0.0f, 0.0f, TileType::OAK_TRUNK };
+    TILE_DATA[TileType::ACACIA] = { L"Acacia Tree", L' ', makeColor(0,0,0), {}, TileType::ACACIA_WOOD, 0.0f, 0.0f, TileType::ACACIA_TRUNK };
+    TILE_DATA[TileType::SPRUCE] = { L"Spruce Tree", L' ', makeColor(0,0,0), {}, TileType::SPRUCE_WOOD, 0.0f, 0.0f, TileType::SPRUCE_TRUNK };
+    TILE_DATA[TileType::BIRCH] = { L"Birch Tree", L' ', makeColor(0,0,0), {}, TileType::BIRCH_WOOD, 0.0f, 0.0f, TileType::BIRCH_TRUNK };
+    TILE_DATA[TileType::PINE] = { L"Pine Tree", L' ', makeColor(0,0,0), {}, TileType::PINE_WOOD, 0.0f, 0.0f, TileType::PINE_TRUNK };
+    TILE_DATA[TileType::POPLAR] = { L"Poplar Tree", L' ', makeColor(0,0,0), {}, TileType::POPLAR_WOOD, 0.0f, 0.0f, TileType::POPLAR_TRUNK };
+    TILE_DATA[TileType::CECROPIA] = { L"Cecropia Tree", L' ', makeColor(0,0,0), {}, TileType::CECROPIA_WOOD, 0.0f, 0.0f, TileType::CECROPIA_TRUNK };
+    TILE_DATA[TileType::COCOA] = { L"Cocoa Tree", L' ', makeColor(0,0,0), {}, TileType::COCOA_WOOD, 0.0f, 0.0f, TileType::COCOA_TRUNK };
+    TILE_DATA[TileType::CYPRESS] = { L"Cypress Tree", L' ', makeColor(0,0,0), {}, TileType::CYPRESS_WOOD, 0.0f, 0.0f, TileType::CYPRESS_TRUNK };
+    TILE_DATA[TileType::MAPLE] = { L"Maple Tree", L' ', makeColor(0,0,0), {}, TileType::MAPLE_WOOD, 0.0f, 0.0f, TileType::MAPLE_TRUNK };
+    TILE_DATA[TileType::PALM] = { L"Palm Tree", L' ', makeColor(0,0,0), {}, TileType::PALM_WOOD, 0.0f, 0.0f, TileType::PALM_TRUNK };
+    TILE_DATA[TileType::TEAK] = { L"Teak Tree", L' ', makeColor(0,0,0), {}, TileType::TEAK_WOOD, 0.0f, 0.0f, TileType::TEAK_TRUNK };
+    TILE_DATA[TileType::SAGUARO] = { L"Saguaro Cactus", L' ', makeColor(0,0,0), {}, TileType::SAGUARO_WOOD, 0.0f, 0.0f, TileType::SAGUARO_TRUNK };
+    TILE_DATA[TileType::PRICKLYPEAR] = { L"Prickly Pear Cactus", L' ', makeColor(0,0,0), {}, TileType::PRICKLYPEAR_WOOD, 0.0f, 0.0f, TileType::PRICKLYPEAR_PAD };
+    TILE_DATA[TileType::CHOLLA] = { L"Cholla Cactus", L' ', makeColor(0,0,0), {}, TileType::CHOLLA_WOOD, 0.0f, 0.0f, TileType::CHOLLA_TRUNK };
+
+    // Tree Parts
+    // These are temporary parts of a tree and generally shouldn't be picked up as loose items
+    // unless they have a 'drops' defined, in which case their 'drops' item would be haulable.
+    // For now, they are not marked as TileTag::ITEM directly.
+    TILE_DATA[TileType::TRUNK] = { L"Trunk", L'0', makeColor(139,69,19), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::OAK_WOOD };
+    TILE_DATA[TileType::BRANCH] = { L"Branch", L'|', makeColor(139,69,19), {TileTag::TREE_PART, TileTag::TREE_BRANCH}, TileType::OAK_WOOD };
+    TILE_DATA[TileType::LEAF] = { L"Leaves", L'♣', makeColor(0,100,0), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::OAK_TRUNK] = { L"Oak Trunk", L'0', makeColor(139,69,19), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::OAK_WOOD };
+    TILE_DATA[TileType::OAK_BRANCH] = { L"Oak Branch", L'|', makeColor(139,69,19), {TileTag::TREE_PART, TileTag::TREE_BRANCH}, TileType::OAK_WOOD };
+    TILE_DATA[TileType::OAK_LEAF] = { L"Oak Leaves", L'♣', makeColor(0,100,0), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::ACACIA_TRUNK] = { L"Acacia Trunk", L'0', makeColor(184, 142, 90), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::ACACIA_WOOD };
+    TILE_DATA[TileType::ACACIA_BRANCH] = { L"Acacia Branch", L'-', makeColor(184, 142, 90), {TileTag::TREE_PART, TileTag::TREE_BRANCH}, TileType::ACACIA_WOOD };
+    TILE_DATA[TileType::ACACIA_LEAF] = { L"Acacia Leaves", L'☘', makeColor(124, 252, 0), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::SPRUCE_TRUNK] = { L"Spruce Trunk", L'0', makeColor(94, 65, 41), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::SPRUCE_WOOD };
+    TILE_DATA[TileType::SPRUCE_BRANCH] = { L"Spruce Branch", L'\\', makeColor(94, 65, 41), {TileTag::TREE_PART, TileTag::TREE_BRANCH}, TileType::SPRUCE_WOOD };
+    TILE_DATA[TileType::SPRUCE_NEEDLE] = { L"Spruce Needles", L'♠', makeColor(26, 61, 26), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::BIRCH_TRUNK] = { L"Birch Trunk", L'0', makeColor(245, 245, 220), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::BIRCH_WOOD };
+    TILE_DATA[TileType::BIRCH_BRANCH] = { L"Birch Branch", L'/', makeColor(225, 225, 200), {TileTag::TREE_PART, TileTag::TREE_BRANCH}, TileType::BIRCH_WOOD };
+    TILE_DATA[TileType::BIRCH_LEAF] = { L"Birch Leaves", L'♣', makeColor(154, 205, 50), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::PINE_TRUNK] = { L"Pine Trunk", L'0', makeColor(115, 74, 47), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::PINE_WOOD };
+    TILE_DATA[TileType::PINE_BRANCH] = { L"Pine Branch", L'-', makeColor(115, 74, 47), {TileTag::TREE_PART, TileTag::TREE_BRANCH}, TileType::PINE_WOOD };
+    TILE_DATA[TileType::PINE_NEEDLE] = { L"Pine Needles", L'♠', makeColor(0, 80, 0), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::POPLAR_TRUNK] = { L"Poplar Trunk", L'║', makeColor(191, 179, 155), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::POPLAR_WOOD };
+    TILE_DATA[TileType::POPLAR_BRANCH] = { L"Poplar Branch", L'|', makeColor(191, 179, 155), {TileTag::TREE_PART, TileTag::TREE_BRANCH}, TileType::POPLAR_WOOD };
+    TILE_DATA[TileType::POPLAR_LEAF] = { L"Poplar Leaves", L'♥', makeColor(255, 215, 0), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::CECROPIA_TRUNK] = { L"Cecropia Trunk", L'0', makeColor(170, 169, 173), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::CECROPIA_WOOD };
+    TILE_DATA[TileType::CECROPIA_BRANCH] = { L"Cecropia Stalk", L'/', makeColor(170, 169, 173), {TileTag::TREE_PART, TileTag::TREE_BRANCH}, TileType::CECROPIA_WOOD };
+    TILE_DATA[TileType::CECROPIA_LEAF] = { L"Cecropia Leaves", L'☘', makeColor(74, 114, 48), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::COCOA_TRUNK] = { L"Cocoa Trunk", L'0', makeColor(112, 66, 20), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::COCOA_WOOD };
+    TILE_DATA[TileType::COCOA_BRANCH] = { L"Cocoa Branch", L'|', makeColor(112, 66, 20), {TileTag::TREE_PART, TileTag::TREE_BRANCH}, TileType::COCOA_WOOD };
+    TILE_DATA[TileType::COCOA_LEAF] = { L"Cocoa Leaves", L'♣', makeColor(0, 70, 0), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::CYPRESS_TRUNK] = { L"Cypress Trunk", L'║', makeColor(116, 95, 68), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::CYPRESS_WOOD };
+    TILE_DATA[TileType::CYPRESS_BRANCH] = { L"Cypress Branch", L'|', makeColor(116, 95, 68), {TileTag::TREE_PART, TileTag::TREE_BRANCH}, TileType::CYPRESS_WOOD };
+    TILE_DATA[TileType::CYPRESS_FOLIAGE] = { L"Cypress Foliage", L'♠', makeColor(46, 70, 46), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::MAPLE_TRUNK] = { L"Maple Trunk", L'0', makeColor(129, 93, 56), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::MAPLE_WOOD };
+    TILE_DATA[TileType::MAPLE_BRANCH] = { L"Maple Branch", L'|', makeColor(129, 93, 56), {TileTag::TREE_PART, TileTag::TREE_BRANCH}, TileType::MAPLE_WOOD };
+    TILE_DATA[TileType::MAPLE_LEAF] = { L"Maple Leaves", L'♥', makeColor(227, 66, 52), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::PALM_TRUNK] = { L"Palm Trunk", L'║', makeColor(210, 180, 140), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::PALM_WOOD };
+    TILE_DATA[TileType::PALM_FROND] = { L"Palm Frond", L'¥', makeColor(0, 128, 0), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::TEAK_TRUNK] = { L"Teak Trunk", L'0', makeColor(138, 104, 53), {TileTag::TREE_PART, TileTag::TREE_TRUNK}, TileType::TEAK_WOOD };
+    TILE_DATA[TileType::TEAK_BRANCH] = { L"Teak Branch", L'|', makeColor(138, 104, 53), {TileTag::TREE_PART, TileTag::TREE_BRANCH}, TileType::TEAK_WOOD };
+    TILE_DATA[TileType::TEAK_LEAF] = { L"Teak Leaves", L'♣', makeColor(60, 90, 30), {TileTag::TREE_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::SAGUARO_TRUNK] = { L"Saguaro Trunk", L'┃', makeColor(0, 107, 60), {TileTag::CACTUS_PART, TileTag::TREE_TRUNK}, TileType::SAGUARO_WOOD };
+    TILE_DATA[TileType::SAGUARO_ARM] = { L"Saguaro Arm", L'┃', makeColor(0, 128, 70), {TileTag::CACTUS_PART, TileTag::TREE_BRANCH}, TileType::SAGUARO_WOOD };
+    TILE_DATA[TileType::PRICKLYPEAR_PAD] = { L"Prickly Pear Pad", L'O', makeColor(84, 140, 61), {TileTag::CACTUS_PART, TileTag::TREE_BRANCH}, TileType::PRICKLYPEAR_WOOD };
+    TILE_DATA[TileType::PRICKLYPEAR_TUNA] = { L"Prickly Pear Fruit", L'o', makeColor(199, 21, 133), {TileTag::CACTUS_PART, TileTag::TREE_LEAF}, TileType::EMPTY };
+    TILE_DATA[TileType::CHOLLA_TRUNK] = { L"Cholla Trunk", L'|', makeColor(141, 120, 81), {TileTag::CACTUS_PART, TileTag::TREE_TRUNK}, TileType::CHOLLA_WOOD };
+    TILE_DATA[TileType::CHOLLA_JOINT] = { L"Cholla Joint", L'#', makeColor(161, 140, 101), {TileTag::CACTUS_PART, TileTag::TREE_BRANCH}, TileType::CHOLLA_WOOD };
+
+    // Resources (Items on ground)
+    /// Stone Chunks
+    TILE_DATA[TileType::STONE_CHUNK] = { L"Stone Chunk", L'*', makeColor(128,128,128), {TileTag::ITEM, TileTag::CHUNK, TileTag::STONE}, TileType::EMPTY };
+    TILE_DATA[TileType::CHALK_CHUNK] = { L"Chalk Chunk", L'*', makeColor(245,245,245), {TileTag::ITEM, TileTag::CHUNK, TileTag::SEDIMENTARY}, TileType::EMPTY };
+    TILE_DATA[TileType::CHERT_CHUNK] = { L"Chert Chunk", L'*', makeColor(210,180,140), {TileTag::ITEM, TileTag::CHUNK, TileTag::SEDIMENTARY}, TileType::EMPTY };
+    TILE_DATA[TileType::CLAYSTONE_CHUNK] = { L"Claystone Chunk", L'*', makeColor(188,143,143), {TileTag::ITEM, TileTag::CHUNK, TileTag::SEDIMENTARY}, TileType::EMPTY };
+    TILE_DATA[TileType::CONGLOMERATE_CHUNK] = { L"Conglomerate Chunk", L'*', makeColor(160,160,160), {TileTag::ITEM, TileTag::CHUNK, TileTag::SEDIMENTARY}, TileType::EMPTY };
+    TILE_DATA[TileType::DOLOMITE_CHUNK] = { L"Dolomite Chunk", L'*', makeColor(192,192,192), {TileTag::ITEM, TileTag::CHUNK, TileTag::SEDIMENTARY}, TileType::EMPTY };
+    TILE_DATA[TileType::LIMESTONE_CHUNK] = { L"Limestone Chunk", L'*', makeColor(211,211,211), {TileTag::ITEM, TileTag::CHUNK, TileTag::SEDIMENTARY}, TileType::EMPTY };
+    TILE_DATA[TileType::MUDSTONE_CHUNK] = { L"Mudstone Chunk", L'*', makeColor(139,115,85), {TileTag::ITEM, TileTag::CHUNK, TileTag::SEDIMENTARY}, TileType::EMPTY };
+    TILE_DATA[TileType::ROCK_SALT_CHUNK] = { L"Rock Salt Chunk", L'*', makeColor(255,228,225), {TileTag::ITEM, TileTag::CHUNK, TileTag::SEDIMENTARY}, TileType::EMPTY };
+    TILE_DATA[TileType::SANDSTONE_CHUNK] = { L"Sandstone Chunk", L'*', makeColor(218,165,32), {TileTag::ITEM, TileTag::CHUNK, TileTag::SEDIMENTARY}, TileType::EMPTY };
+    TILE_DATA[TileType::SHALE_CHUNK] = { L"Shale Chunk", L'*', makeColor(128,128,128), {TileTag::ITEM, TileTag::CHUNK, TileTag::SEDIMENTARY}, TileType::EMPTY };
+    TILE_DATA[TileType::SILTSTONE_CHUNK] = { L"Siltstone Chunk", L'*', makeColor(198,179,155), {TileTag::ITEM, TileTag::CHUNK, TileTag::SEDIMENTARY}, TileType::EMPTY };
+    TILE_DATA[TileType::DIORITE_CHUNK] = { L"Diorite Chunk", L'*', makeColor(119,136,153), {TileTag::ITEM, TileTag::CHUNK, TileTag::IGNEOUS_INTRUSIVE}, TileType::EMPTY };
+    TILE_DATA[TileType::GABBRO_CHUNK] = { L"Gabbro Chunk", L'*', makeColor(80,80,80), {TileTag::ITEM, TileTag::CHUNK, TileTag::IGNEOUS_INTRUSIVE}, TileType::EMPTY };
+    TILE_DATA[TileType::GRANITE_CHUNK] = { L"Granite Chunk", L'*', makeColor(150,150,150), {TileTag::ITEM, TileTag::CHUNK, TileTag::IGNEOUS_INTRUSIVE}, TileType::EMPTY };
+    TILE_DATA[TileType::ANDESITE_CHUNK] = { L"Andesite Chunk", L'*', makeColor(130,130,130), {TileTag::ITEM, TileTag::CHUNK, TileTag::IGNEOUS_EXTRUSIVE}, TileType::EMPTY };
+    TILE_DATA[TileType::BASALT_CHUNK] = { L"Basalt Chunk", L'*', makeColor(40,40,40), {TileTag::ITEM, TileTag::CHUNK, TileTag::IGNEOUS_EXTRUSIVE}, TileType::EMPTY };
+    TILE_DATA[TileType::DACITE_CHUNK] = { L"Dacite Chunk", L'*', makeColor(180,180,180), {TileTag::ITEM, TileTag::CHUNK, TileTag::IGNEOUS_EXTRUSIVE}, TileType::EMPTY };
+    TILE_DATA[TileType::OBSIDIAN_CHUNK] = { L"Obsidian Chunk", L'*', makeColor(20,20,20), {TileTag::ITEM, TileTag::CHUNK, TileTag::IGNEOUS_EXTRUSIVE}, TileType::EMPTY };
+    TILE_DATA[TileType::RHYOLITE_CHUNK] = { L"Rhyolite Chunk", L'*', makeColor(255,192,203), {TileTag::ITEM, TileTag::CHUNK, TileTag::IGNEOUS_EXTRUSIVE}, TileType::EMPTY };
+    TILE_DATA[TileType::GNEISS_CHUNK] = { L"Gneiss Chunk", L'*', makeColor(105,105,105), {TileTag::ITEM, TileTag::CHUNK, TileTag::METAMORPHIC}, TileType::EMPTY };
+    TILE_DATA[TileType::MARBLE_CHUNK] = { L"Marble Chunk", L'*', makeColor(255,250,250), {TileTag::ITEM, TileTag::CHUNK, TileTag::METAMORPHIC}, TileType::EMPTY };
+    TILE_DATA[TileType::PHYLLITE_CHUNK] = { L"Phyllite Chunk", L'*', makeColor(176,196,222), {TileTag::ITEM, TileTag::CHUNK, TileTag::METAMORPHIC}, TileType::EMPTY };
+    TILE_DATA[TileType::QUARTZITE_CHUNK] = { L"Quartzite Chunk", L'*', makeColor(238,232,170), {TileTag::ITEM, TileTag::CHUNK, TileTag::METAMORPHIC}, TileType::EMPTY };
+    TILE_DATA[TileType::SCHIST_CHUNK] = { L"Schist Chunk", L'*', makeColor(0,128,128), {TileTag::ITEM, TileTag::CHUNK, TileTag::METAMORPHIC}, TileType::EMPTY };
+    TILE_DATA[TileType::SLATE_CHUNK] = { L"Slate Chunk", L'*', makeColor(70,70,70), {TileTag::ITEM, TileTag::CHUNK, TileTag::METAMORPHIC}, TileType::EMPTY };
+    TILE_DATA[TileType::CORESTONE_CHUNK] = { L"Corestone Chunk", L'*', makeColor(25,25,25), {TileTag::ITEM, TileTag::CHUNK, TileTag::INNER_STONE}, TileType::EMPTY };
+    /// Woods
+    TILE_DATA[TileType::OAK_WOOD] = { L"Oak Wood", L'=', makeColor(139,69,19), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY, 4.0f, 0.8f };
+    TILE_DATA[TileType::ACACIA_WOOD] = { L"Acacia Wood", L'=', makeColor(205,133,63), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+    TILE_DATA[TileType::SPRUCE_WOOD] = { L"Spruce Wood", L'=', makeColor(139,90,43), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+    TILE_DATA[TileType::BIRCH_WOOD] = { L"Birch Wood", L'=', makeColor(245,222,179), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+    TILE_DATA[TileType::PINE_WOOD] = { L"Pine Wood", L'=', makeColor(160,82,45), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY, 2.0f, 1.5f };
+    TILE_DATA[TileType::POPLAR_WOOD] = { L"Poplar Wood", L'=', makeColor(222,184,135), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+    TILE_DATA[TileType::CECROPIA_WOOD] = { L"Cecropia Wood", L'=', makeColor(188,143,143), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+    TILE_DATA[TileType::COCOA_WOOD] = { L"Cocoa Wood", L'=', makeColor(139,69,19), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+    TILE_DATA[TileType::CYPRESS_WOOD] = { L"Cypress Wood", L'=', makeColor(210,180,140), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+    TILE_DATA[TileType::MAPLE_WOOD] = { L"Maple Wood", L'=', makeColor(205,92,92), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+    TILE_DATA[TileType::PALM_WOOD] = { L"Palm Wood", L'=', makeColor(238,221,130), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+    TILE_DATA[TileType::TEAK_WOOD] = { L"Teak Wood", L'=', makeColor(165,42,42), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+    TILE_DATA[TileType::SAGUARO_WOOD] = { L"Saguaro Wood", L'=', makeColor(152,251,152), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+    TILE_DATA[TileType::PRICKLYPEAR_WOOD] = { L"Prickly Pear Wood", L'=', makeColor(84, 140, 61), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+    TILE_DATA[TileType::CHOLLA_WOOD] = { L"Cholla Wood", L'=', makeColor(141, 120, 81), {TileTag::ITEM, TileTag::WOOD}, TileType::EMPTY };
+
+    // Refined Metals
+
+    TILE_DATA[TileType::COPPER_METAL] = { L"Copper", L'I', makeColor(184,115,51), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 0.5f, 1.0f, TileType::EMPTY, L"Cu" };
+    TILE_DATA[TileType::TIN_METAL] = { L"Tin", L'I', makeColor(192,192,192), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 0.6f, 1.1f, TileType::EMPTY, L"Sn" };
+    TILE_DATA[TileType::NICKEL_METAL] = { L"Nickel", L'I', makeColor(150,150,150), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 0.8f, 1.5f, TileType::EMPTY, L"Ni" };
+    TILE_DATA[TileType::ZINC_METAL] = { L"Zinc", L'I', makeColor(175,175,175), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 0.7f, 1.4f, TileType::EMPTY, L"Zn" };
+    TILE_DATA[TileType::IRON_METAL] = { L"Iron", L'I', makeColor(100,100,100), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 1.0f, 1.8f, TileType::EMPTY, L"Fe" };
+    TILE_DATA[TileType::LEAD_METAL] = { L"Lead", L'I', makeColor(70,80,90), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 0.9f, 1.6f, TileType::EMPTY, L"Pb" };
+    TILE_DATA[TileType::SILVER_METAL] = { L"Silver", L'I', makeColor(220,220,220), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 1.2f, 2.5f, TileType::EMPTY, L"Ag" };
+    TILE_DATA[TileType::TUNGSTEN_METAL] = { L"Tungsten", L'I', makeColor(80,90,100), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 1.5f, 2.8f, TileType::EMPTY, L"W" };
+    TILE_DATA[TileType::GOLD_METAL] = { L"Gold", L'I', makeColor(255,215,0), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 1.8f, 4.0f, TileType::EMPTY, L"Au" };
+    TILE_DATA[TileType::PLATINUM_METAL] = { L"Platinum", L'I', makeColor(230,230,230), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 2.0f, 4.5f, TileType::EMPTY, L"Pt" };
+    TILE_DATA[TileType::ALUMINUM_METAL] = { L"Aluminum", L'I', makeColor(180,190,200), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 1.1f, 2.2f, TileType::EMPTY, L"Al" };
+    TILE_DATA[TileType::CHROMIUM_METAL] = { L"Chromium", L'I', makeColor(110,120,130), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 1.3f, 2.4f, TileType::EMPTY, L"Cr" };
+    TILE_DATA[TileType::BISMUTH_METAL] = { L"Bismuth", L'I', makeColor(100,200,200), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 1.4f, 3.5f, TileType::EMPTY, L"Bi" };
+    TILE_DATA[TileType::RHODIUM_METAL] = { L"Rhodium", L'I', makeColor(200,100,150), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 2.5f, 5.5f, TileType::EMPTY, L"Rh" };
+    TILE_DATA[TileType::OSMIUM_METAL] = { L"Osmium", L'I', makeColor(80,80,80), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 2.7f, 6.0f, TileType::EMPTY, L"Os" };
+    TILE_DATA[TileType::IRIDIUM_METAL] = { L"Iridium", L'I', makeColor(120,120,120), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 2.8f, 6.5f, TileType::EMPTY, L"Ir" };
+    TILE_DATA[TileType::COBALT_METAL] = { L"Cobalt", L'I', makeColor(50,50,200), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 2.1f, 4.2f, TileType::EMPTY, L"Co" };
+    TILE_DATA[TileType::PALLADIUM_METAL] = { L"Palladium", L'I', makeColor(180,180,180), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 2.2f, 4.8f, TileType::EMPTY, L"Pd" };
+    TILE_DATA[TileType::MITHRIL_METAL] = { L"Mithril", L'I', makeColor(100,200,255), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 3.0f, 9.0f, TileType::EMPTY, L"M" };
+    TILE_DATA[TileType::ORICHALCUM_METAL] = { L"Orichalcum", L'I', makeColor(255,140,0), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 3.2f, 9.5f, TileType::EMPTY, L"Or" };
+    TILE_DATA[TileType::ADAMANTIUM_METAL] = { L"Adamantium", L'I', makeColor(255,0,0), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 4.0f, 12.0f, TileType::EMPTY, L"Ad" };
+    TILE_DATA[TileType::TITANIUM_METAL] = { L"Titanium", L'I', makeColor(150,150,160), {TileTag::ITEM, TileTag::METAL, TileTag::MINERAL}, TileType::EMPTY, 3.8f, 11.5f, TileType::EMPTY, L"Ti" };
+
+    // Ores
+
+    TILE_DATA[TileType::BISMUTHINITE_ORE] = { L"Bismuthinite", L'o', makeColor(70,160,160), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::BISMUTH_METAL, 3.0f, 1.7f };
+    TILE_DATA[TileType::CASSITERITE_ORE] = { L"Cassiterite", L'o', makeColor(150,120,90), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::TIN_METAL, 2.5f, 0.6f };
+    TILE_DATA[TileType::NATIVE_COPPER_ORE] = { L"Native Copper", L'o', makeColor(205,92,92), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::COPPER_METAL, 2.0f, 0.5f };
+    TILE_DATA[TileType::GALENA_ORE] = { L"Galena", L'o', makeColor(90,100,110), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::LEAD_METAL, 3.0f, 0.8f }; // Could drop silver too, but simplify for now
+    TILE_DATA[TileType::GARNIERITE_ORE] = { L"Garnierite", L'o', makeColor(100,140,100), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::NICKEL_METAL, 2.8f, 0.7f };
+    TILE_DATA[TileType::NATIVE_GOLD_ORE] = { L"Native Gold", L'o', makeColor(255,223,0), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::GOLD_METAL, 4.0f, 2.0f };
+    TILE_DATA[TileType::HEMATITE_ORE] = { L"Hematite", L'o', makeColor(100,50,50), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::IRON_METAL, 3.5f, 0.9f };
+    TILE_DATA[TileType::HORN_SILVER_ORE] = { L"Horn Silver", L'o', makeColor(200,200,200), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::SILVER_METAL, 3.0f, 1.2f };
+    TILE_DATA[TileType::LIMONITE_ORE] = { L"Limonite", L'o', makeColor(150,100,50), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::IRON_METAL, 3.2f, 0.8f };
+    TILE_DATA[TileType::MAGNETITE_ORE] = { L"Magnetite", L'o', makeColor(50,50,50), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::IRON_METAL, 3.8f, 1.0f };
+    TILE_DATA[TileType::MALACHITE_ORE] = { L"Malachite", L'o', makeColor(0,180,0), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::COPPER_METAL, 2.2f, 0.55f };
+    TILE_DATA[TileType::NATIVE_PLATINUM_ORE] = { L"Native Platinum", L'o', makeColor(200,200,200), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::PLATINUM_METAL, 4.5f, 2.2f };
+    TILE_DATA[TileType::NATIVE_SILVER_ORE] = { L"Native Silver", L'o', makeColor(230,230,230), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::SILVER_METAL, 3.0f, 1.0f };
+    TILE_DATA[TileType::SPHALERITE_ORE] = { L"Sphalerite", L'o', makeColor(180,140,80), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::ZINC_METAL, 2.7f, 0.75f };
+    TILE_DATA[TileType::TETRAHEDRITE_ORE] = { L"Tetrahedrite", L'o', makeColor(150,90,90), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::COPPER_METAL, 2.3f, 0.65f }; // Also drops copper, ignore silver for now
+    TILE_DATA[TileType::NATIVE_ALUMINUM_ORE] = { L"Native Aluminum", L'o', makeColor(200,210,220), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::ALUMINUM_METAL, 2.9f, 1.1f };
+    TILE_DATA[TileType::ADAMANTITE_ORE] = { L"Adamantite", L'o', makeColor(200,0,0), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::ADAMANTIUM_METAL, 7.0f, 6.0f };
+    TILE_DATA[TileType::WOLFRAMITE_ORE] = { L"Wolframite", L'o', makeColor(70,80,90), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::TUNGSTEN_METAL, 3.2f, 1.4f };
+    TILE_DATA[TileType::SPERRYLITE_ORE] = { L"Sperrylite", L'o', makeColor(180,180,180), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::PLATINUM_METAL, 4.8f, 2.4f };
+    TILE_DATA[TileType::IRIDOSMINE_ORE] = { L"Iridosmine", L'o', makeColor(100,100,100), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::IRIDIUM_METAL, 5.0f, 3.2f };
+    TILE_DATA[TileType::COBALTITE_ORE] = { L"Cobaltite", L'o', makeColor(30,30,150), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::COBALT_METAL, 4.0f, 2.1f };
+    TILE_DATA[TileType::PALLADINITE_ORE] = { L"Palladinite", L'o', makeColor(160,160,160), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::PALLADIUM_METAL, 4.2f, 2.4f };
+    TILE_DATA[TileType::MITHRITE_ORE] = { L"Mithrite", L'o', makeColor(50,150,200), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::MITHRIL_METAL, 6.5f, 4.5f };
+    TILE_DATA[TileType::ORICALCITE_ORE] = { L"Oricalcite", L'o', makeColor(200,100,0), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::ORICHALCUM_METAL, 6.8f, 4.7f };
+    TILE_DATA[TileType::RUTILE_ORE] = { L"Rutile", L'o', makeColor(120,120,130), {TileTag::ITEM, TileTag::ORE, TileTag::MINERAL}, TileType::TITANIUM_METAL, 6.0f, 5.5f };
+
+    // Architect Placeables
+    TILE_DATA[TileType::BLUEPRINT] = { L"Construction Site", L'x', makeColor(0, 200, 255), {TileTag::BLUEPRINT_TAG}, TileType::EMPTY };
+    TILE_DATA[TileType::WALL] = { L"Wall", L'█', makeColor(139,69,19), {TileTag::STRUCTURE}, TileType::EMPTY }; // MODIFIED: Color changed to imply wood
+    TILE_DATA[TileType::STAIR_UP] = { L"Stair Up", L'<', makeColor(200, 200, 200), {TileTag::STRUCTURE}, TileType::EMPTY };
+    TILE_DATA[TileType::STAIR_DOWN] = { L"Stair Down", L'>', makeColor(200, 200, 200), {TileTag::STRUCTURE}, TileType::EMPTY };
+    TILE_DATA[TileType::STONE_WALL] = { L"Stone Wall", L'█', makeColor(120, 120, 120), {TileTag::STRUCTURE}, TileType::EMPTY }; // NEW
+    TILE_DATA[TileType::CHAIR] = { L"Chair", L'h', makeColor(139,69,19), {TileTag::FURNITURE}, TileType::EMPTY };
+    TILE_DATA[TileType::TABLE] = { L"Table", L'π', makeColor(139,69,19), {TileTag::FURNITURE}, TileType::EMPTY };
+    TILE_DATA[TileType::TORCH] = { L"Torch", L'!', makeColor(255,165,0), {TileTag::LIGHTS}, TileType::EMPTY };
+    TILE_DATA[TileType::RESEARCH_BENCH] = { L"Research Bench", L'R', makeColor(180,180,220), {TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::CARPENTRY_WORKBENCH] = { L"Carpentry Workbench", L'b', makeColor(184, 115, 51), {TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::STONECUTTING_TABLE] = { L"Stonecutting Table", L'b', makeColor(150, 150, 150), {TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::SMITHY] = { L"Smithy", L'b', makeColor(100, 100, 100), {TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::BLAST_FURNACE] = { L"Blast Furnace", L'B', makeColor(255, 140, 0), {TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::ADVANCED_RESEARCH_BENCH] = { L"Adv. Research Bench", L'R', makeColor(150, 220, 255), {TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::GROWING_ZONE] = { L"Growing Zone", L'\"', makeColor(100, 150, 0), {TileTag::STRUCTURE}, TileType::EMPTY };
+    TILE_DATA[TileType::MINE_SHAFT] = { L"Mine Shaft", L'M', makeColor(80, 80, 80), {TileTag::STRUCTURE, TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::WINDMILL] = { L"Windmill", L'W', makeColor(150, 150, 100), {TileTag::STRUCTURE, TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::COINING_MILL] = { L"Coining Mill", L'C', makeColor(180, 180, 180), {TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::THEATRE_STAGE] = { L"Theatre Stage", L'§', makeColor(120, 80, 50), {TileTag::FURNITURE}, TileType::EMPTY };
+    TILE_DATA[TileType::DRUG_LAB] = { L"Drug Lab", L'L', makeColor(100, 200, 100), {TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::LIGHTHOUSE_BUILDING] = { L"Lighthouse", L'▲', makeColor(200, 200, 200), {TileTag::STRUCTURE, TileTag::LIGHTS}, TileType::EMPTY };
+    TILE_DATA[TileType::PRINTING_PRESS_FURNITURE] = { L"Printing Press", L'P', makeColor(100, 50, 20), {TileTag::FURNITURE, TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::TYPEWRITER] = { L"Typewriter", L't', makeColor(50, 50, 50), {TileTag::FURNITURE}, TileType::EMPTY };
+    TILE_DATA[TileType::ASSEMBLY_LINE] = { L"Assembly Line", L'=', makeColor(100, 100, 100), {TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::RADIO_FURNITURE] = { L"Radio", L'®', makeColor(70, 70, 70), {TileTag::FURNITURE, TileTag::LIGHTS}, TileType::EMPTY };
+    TILE_DATA[TileType::COMPUTER_FURNITURE] = { L"Computer", L'☺', makeColor(80, 80, 150), {TileTag::FURNITURE, TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::WIND_TURBINE] = { L"Wind Turbine", L'T', makeColor(150, 150, 150), {TileTag::STRUCTURE, TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::SERVER] = { L"Server", L'§', makeColor(60, 60, 60), {TileTag::STRUCTURE, TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::SWITCH] = { L"Switch", L'S', makeColor(60, 60, 60), {TileTag::STRUCTURE, TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::ROUTER] = { L"Router", L'R', makeColor(60, 60, 60), {TileTag::STRUCTURE, TileTag::PRODUCTION}, TileType::EMPTY };
+    TILE_DATA[TileType::HOSPITAL_BED] = { L"Hospital Bed", L'H', makeColor(200, 200, 255), {TileTag::FURNITURE}, TileType::EMPTY }; // NEW
+    TILE_DATA[TileType::HYDROPONICS_BASIN] = { L"Hydroponics Basin", L'~', makeColor(0, 150, 0), {TileTag::PRODUCTION}, TileType::EMPTY };
+
+
+
+
+
+
+
+    TILE_DATA[TileType::PICKAXE] = { L"Pickaxe", L'/', makeColor(150, 100, 50), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::RAFT] = { L"Raft", L'~', makeColor(139, 100, 19), {TileTag::ITEM}, TileType::EMPTY };
+    
+    TILE_DATA[TileType::WHEEL] = { L"Wheel", L'o', makeColor(100, 100, 100), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::COIN] = { L"Coin", L'$', makeColor(255, 215, 0), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::LENS] = { L"Lens", L'o', makeColor(173, 216, 230), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::GLASSES] = { L"Glasses", L'e', makeColor(100, 100, 100), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::BOW] = { L"Bow", L'\\', makeColor(139, 69, 19), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::ARROW] = { L"Arrow", L'|', makeColor(150, 150, 150), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::KNIGHT_ARMOR] = { L"Knight Armor", L'[', makeColor(120, 120, 120), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::KNIGHT_WEAPON] = { L"Knight Weapon", L'/', makeColor(100, 100, 100), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::COMPASS_ITEM] = { L"Compass", L'¤', makeColor(150, 150, 150), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::GUNPOWDER_ITEM] = { L"Gunpowder", L'/', makeColor(50, 50, 50), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::WIRE] = { L"Wire", L'-', makeColor(180, 0, 0), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::LIGHTBULB] = { L"Lightbulb", L'O', makeColor(255, 255, 150), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::CHEMICALS_ITEM] = { L"Chemicals", L'~', makeColor(100, 100, 200), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::DRUGS_ITEM] = { L"Drugs", L'?', makeColor(200, 50, 200), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::BOAT_ITEM] = { L"Boat", L'=', makeColor(100, 70, 40), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::SMARTPHONE] = { L"Smartphone", L'📱', makeColor(0,0,0), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::TABLET] = { L"Tablet", L'💻', makeColor(0,0,0), {TileTag::ITEM}, TileType::EMPTY };
+    TILE_DATA[TileType::SMARTWATCH] = { L"Smartwatch", L'⌚', makeColor(0,0,0), {TileTag::ITEM}, TileType::EMPTY };
+
+
+
+
+
+
+
+    TILE_DATA[TileType::SPIKE_TRAP] = { L"Spike Trap", L'^', makeColor(100, 50, 20), {TileTag::SECURITY, TileTag::STRUCTURE}, TileType::EMPTY };
+    TILE_DATA[TileType::COLUMN] = { L"Column", L'|', makeColor(150, 150, 150), {TileTag::STRUCTURE}, TileType::EMPTY };
+    TILE_DATA[TileType::TELESCOPE_FURNITURE] = { L"Telescope", L'T', makeColor(80, 80, 80), {TileTag::FURNITURE}, TileType::EMPTY };
+    TILE_DATA[TileType::BLACKBOARD_FURNITURE] = { L"Blackboard", L'#', makeColor(50, 50, 50), {TileTag::FURNITURE}, TileType::EMPTY };
+    TILE_DATA[TileType::SCHOOL_CHAIR_FURNITURE] = { L"School Chair", L'h', makeColor(100, 70, 40), {TileTag::FURNITURE}, TileType::EMPTY };
+    TILE_DATA[TileType::SCHOOL_DESK_FURNITURE] = { L"School Desk", L'π', makeColor(100, 70, 40), {TileTag::FURNITURE}, TileType::EMPTY };
+    TILE_DATA[TileType::ACOUSTIC_WALL_ITEM] = { L"Acoustic Wall", L'#', makeColor(80, 80, 80), {TileTag::STRUCTURE}, TileType::EMPTY };
+
+
+
+
+
+
+    // Unlocks for research
+    std::set<TileType> g_unlockedBuildings;
+
+    // Biome Data
+    BIOME_DATA[Biome::OCEAN] = { L"Ocean", makeColor(0,0,139) };
+    BIOME_DATA[Biome::TUNDRA] = { L"Tundra", makeColor(224,255,255) };
+    BIOME_DATA[Biome::BOREAL_FOREST] = { L"Boreal Forest", makeColor(0,100,0) };
+    BIOME_DATA[Biome::TEMPERATE_FOREST] = { L"Temperate Forest", makeColor(34,139,34) };
+    BIOME_DATA[Biome::JUNGLE] = { L"Jungle", makeColor(0,80,0) };
+    BIOME_DATA[Biome::DESERT] = { L"Desert", makeColor(244,164,96) };
+
+    initResearchData();
+    initPawnData();
+    initCritterData();
+    initBiomeCritterSpawns();
+
+    // NEW: Helper vectors for ore generation
+    std::vector<TileType> sedimentaryStones = { TileType::CHALK, TileType::CHERT, TileType::CLAYSTONE, TileType::CONGLOMERATE, TileType::DOLOMITE, TileType::LIMESTONE, TileType::MUDSTONE, TileType::ROCK_SALT, TileType::SANDSTONE, TileType::SHALE, TileType::SILTSTONE };
+    std::vector<TileType> igneousExtrusiveStones = { TileType::ANDESITE, TileType::BASALT, TileType::DACITE, TileType::OBSIDIAN, TileType::RHYOLITE };
+    std::vector<TileType> igneousIntrusiveStones = { TileType::DIORITE, TileType::GABBRO, TileType::GRANITE };
+    std::vector<TileType> metamorphicStones = { TileType::GNEISS, TileType::MARBLE, TileType::PHYLLITE, TileType::QUARTZITE, TileType::SCHIST, TileType::SLATE };
+
+    std::vector<TileType> allIgneousStones;
+    allIgneousStones.insert(allIgneousStones.end(), igneousExtrusiveStones.begin(), igneousExtrusiveStones.end());
+    allIgneousStones.insert(allIgneousStones.end(), igneousIntrusiveStones.begin(), igneousIntrusiveStones.end());
+
+    std::vector<TileType> allStones;
+    allStones.insert(allStones.end(), sedimentaryStones.begin(), sedimentaryStones.end());
+    allStones.insert(allStones.end(), igneousExtrusiveStones.begin(), igneousExtrusiveStones.end());
+    allStones.insert(allStones.end(), igneousIntrusiveStones.begin(), igneousIntrusiveStones.end());
+    allStones.insert(allStones.end(), metamorphicStones.begin(), metamorphicStones.end());
+
+    // NEW: Populate g_tagNames (for stockpile UI categories)
+    g_tagNames.clear();
+    g_tagNames[TileTag::WOOD] = L"Woods";
+    g_tagNames[TileTag::SEDIMENTARY] = L"Sedimentary Rocks";
+    g_tagNames[TileTag::IGNEOUS_INTRUSIVE] = L"Igneous Intrusive Rocks";
+    g_tagNames[TileTag::IGNEOUS_EXTRUSIVE] = L"Igneous Extrusive Rocks";
+    g_tagNames[TileTag::METAMORPHIC] = L"Metamorphic Rocks";
+    g_tagNames[TileTag::INNER_STONE] = L"Core Stones";
+    g_tagNames[TileTag::CHUNK] = L"Chunks (Generic)"; // Used for STONE_CHUNK specifically
+    g_tagNames[TileTag::MINERAL] = L"Minerals"; // For things like raw ores/gems if added
+    g_tagNames[TileTag::SOIL] = L"Soils"; // For loose dirt, sand if haulable
+    // NEW: Metals and Ores
+    g_tagNames[TileTag::METAL] = L"Metals (Refined)";
+    g_tagNames[TileTag::ORE] = L"Ores (Raw)";
+
+
+    TILE_WORLD_DEPTH = 0;
+    BIOSPHERE_Z_LEVEL = 0;
+    HYDROSPHERE_Z_LEVEL = 0;
+    ATMOSPHERE_TOP_Z = 0;
+    TROPOSPHERE_TOP_Z_LEVEL = 0;
+
+    // Z-Level Calculation
+    TILE_WORLD_DEPTH = 0; BIOSPHERE_Z_LEVEL = 0; ATMOSPHERE_TOP_Z = 0; HYDROSPHERE_Z_LEVEL = 0; // <-- Add reset here
+    
+    int z_accumulator = 0;
+    for (const auto& stratum : strataDefinition) {
+        if (stratum.type == Stratum::BIOSPHERE) BIOSPHERE_Z_LEVEL = z_accumulator;
+        if (stratum.type == Stratum::HYDROSPHERE) HYDROSPHERE_Z_LEVEL = z_accumulator;
+        if (stratum.type == Stratum::TROPOSPHERE) TROPOSPHERE_TOP_Z_LEVEL = z_accumulator + stratum.depth - 1; // Top *inclusive* Z-level of troposphere
+        // ATMOSPHERE_TOP_Z should be the very highest point, considering all atmospheric layers, which is typically the last stratum if it's atmospheric.
+        // Assuming Exosphere is the top-most defined atmospheric stratum for ATMOSPHERE_TOP_Z
+        if (stratum.type == Stratum::EXOSPHERE) ATMOSPHERE_TOP_Z = z_accumulator + stratum.depth; // Top *exclusive* bound of highest atmospheric layer
+        z_accumulator += stratum.depth;
+    }
+    TILE_WORLD_DEPTH = z_accumulator; // Total world depth
+
+
+
+
+
+    // NEW: Populate g_tagNames (for stockpile UI categories)
+    g_tagNames.clear();
+    g_tagNames[TileTag::WOOD] = L"Woods";
+    g_tagNames[TileTag::SEDIMENTARY] = L"Sedimentary Rocks";
+    g_tagNames[TileTag::IGNEOUS_INTRUSIVE] = L"Igneous Intrusive Rocks";
+    g_tagNames[TileTag::IGNEOUS_EXTRUSIVE] = L"Igneous Extrusive Rocks";
+    g_tagNames[TileTag::METAMORPHIC] = L"Metamorphic Rocks";
+    g_tagNames[TileTag::INNER_STONE] = L"Core Stones";
+    g_tagNames[TileTag::CHUNK] = L"Chunks (Generic)"; // Used for STONE_CHUNK specifically
+    g_tagNames[TileTag::MINERAL] = L"Minerals"; // For things like raw ores/gems if added
+    g_tagNames[TileTag::SOIL] = L"Soils"; // For loose dirt, sand if haulable
+    // Add more as needed, e.g., METALS, FOOD, etc.
+
+    // Populate g_haulableItemsGrouped
+    g_haulableItemsGrouped.clear();
+    for (const auto& pair : TILE_DATA) {
+        TileType type = pair.first;
+        const TileData& data = pair.second;
+
+        // An item is haulable if it has the ITEM tag, AND is not a blueprint/structure/furniture/light/production building.
+        bool isHaulableItem = false;
+        if (std::find(data.tags.begin(), data.tags.end(), TileTag::ITEM) != data.tags.end()) {
+            // Also ensure it's not a placed structure type that happens to have ITEM tag (e.g. if you mistakenly tagged WALL as ITEM)
+            if (std::find(data.tags.begin(), data.tags.end(), TileTag::STRUCTURE) == data.tags.end() &&
+                std::find(data.tags.begin(), data.tags.end(), TileTag::FURNITURE) == data.tags.end() &&
+                std::find(data.tags.begin(), data.tags.end(), TileTag::LIGHTS) == data.tags.end() &&
+                std::find(data.tags.begin(), data.tags.end(), TileTag::PRODUCTION) == data.tags.end() &&
+                std::find(data.tags.begin(), data.tags.end(), TileTag::BLUEPRINT_TAG) == data.tags.end() &&
+                std::find(data.tags.begin(), data.tags.end(), TileTag::STOCKPILE_ZONE) == data.tags.end())
+            {
+                isHaulableItem = true;
+            }
+        }
+
+        // Also if it's a "drop" from a minable/choppable object, it should be haulable even if its base type
+        // (e.g., OAK_WOOD) isn't explicitly tagged 'ITEM' (though it should be).
+        // This logic makes sure dropped resources are always considered haulable.
+        if (data.drops != TileType::EMPTY && data.drops != type) {
+            if (TILE_DATA.count(data.drops) && std::find(TILE_DATA.at(data.drops).tags.begin(), TILE_DATA.at(data.drops).tags.end(), TileTag::ITEM) != TILE_DATA.at(data.drops).tags.end()) {
+                isHaulableItem = true;
+            }
+        }
+
+        if (isHaulableItem) {
+            TileTag primaryTag = TileTag::NONE;
+            bool foundSpecificTag = false;
+
+            // Prioritize specific material tags
+            if (std::find(data.tags.begin(), data.tags.end(), TileTag::WOOD) != data.tags.end()) { primaryTag = TileTag::WOOD; foundSpecificTag = true; }
+            // NEW: Ores and Metals first for strong categorization
+            else if (std::find(data.tags.begin(), data.tags.end(), TileTag::ORE) != data.tags.end()) { primaryTag = TileTag::ORE; foundSpecificTag = true; }
+            else if (std::find(data.tags.begin(), data.tags.end(), TileTag::METAL) != data.tags.end()) { primaryTag = TileTag::METAL; foundSpecificTag = true; }
+            else if (std::find(data.tags.begin(), data.tags.end(), TileTag::SEDIMENTARY) != data.tags.end()) { primaryTag = TileTag::SEDIMENTARY; foundSpecificTag = true; }
+            else if (std::find(data.tags.begin(), data.tags.end(), TileTag::IGNEOUS_INTRUSIVE) != data.tags.end()) { primaryTag = TileTag::IGNEOUS_INTRUSIVE; foundSpecificTag = true; }
+            else if (std::find(data.tags.begin(), data.tags.end(), TileTag::IGNEOUS_EXTRUSIVE) != data.tags.end()) { primaryTag = TileTag::IGNEOUS_EXTRUSIVE; foundSpecificTag = true; }
+            else if (std::find(data.tags.begin(), data.tags.end(), TileTag::METAMORPHIC) != data.tags.end()) { primaryTag = TileTag::METAMORPHIC; foundSpecificTag = true; }
+            else if (std::find(data.tags.begin(), data.tags.end(), TileTag::INNER_STONE) != data.tags.end()) { primaryTag = TileTag::INNER_STONE; foundSpecificTag = true; }
+            else if (std::find(data.tags.begin(), data.tags.end(), TileTag::CHUNK) != data.tags.end()) { primaryTag = TileTag::CHUNK; foundSpecificTag = true; }
+            else if (std::find(data.tags.begin(), data.tags.end(), TileTag::MINERAL) != data.tags.end()) { primaryTag = TileTag::MINERAL; foundSpecificTag = true; }
+            else if (std::find(data.tags.begin(), data.tags.end(), TileTag::SOIL) != data.tags.end()) { primaryTag = TileTag::SOIL; foundSpecificTag = true; }
+
+            if (foundSpecificTag && g_tagNames.count(primaryTag)) {
+                g_haulableItemsGrouped[primaryTag].push_back(type);
+            }
+        }
+    }
+
+    // Sort items within each group by name
+    for (auto& pair : g_haulableItemsGrouped) {
+        std::sort(pair.second.begin(), pair.second.end(),
+            [](TileType a, TileType b) { return TILE_DATA.at(a).name < TILE_DATA.at(b).name; });
+    }
+
+}
+
+void initPawnData() {
+    g_Backstories.clear();
+    g_SkillDescriptions.clear();
+
+    g_Backstories[L"Survivor"] = { L"Survivor", L"{name} has endured hardships that would break most. This has made them resilient and resourceful, but also wary of others." };
+    g_Backstories[L"Cave Explorer"] = { L"Cave Explorer", L"Years spent navigating treacherous underground networks have made {name} nimble and an expert at seeing value in stone." };
+    g_Backstories[L"Starship Engineer"] = { L"Starship Engineer", L"{name} maintained the delicate systems of a void-faring vessel. Highly intelligent and a fast learner, {name} is not accustomed to manual labor." };
+    g_Backstories[L"Geneticist"] = { L"Geneticist", L"A brilliant scientist who unlocked the secrets of the genome. Research comes naturally to {name}, who also has a basic understanding of medicine." };
+    g_Backstories[L"Farmer"] = { L"Farmer", L"On a frontier world, {name} cultivated crops from dawn till dusk. A lifetime of hard work has made them industrious, though not particularly book-smart." };
+    g_Backstories[L"Soldier"] = { L"Soldier", L"{name} was trained for combat and survival in harsh environments. Tough and disciplined, but finds intellectual pursuits challenging." };
+    g_Backstories[L"Artisan"] = { L"Artisan", L"{name} was a celebrated creator, known for crafting beautiful and functional items. They are skilled with their hands but have little interest in heavy labor or academic pursuits." };
+    g_Backstories[L"Medic"] = { L"Medic", L"{name} served as a field medic, treating wounds under extreme pressure. They have a deep understanding of health but are squeamish about violence." };
+    g_Backstories[L"Prospector"] = { L"Prospector", L"Always chasing the next big find, {name} spent years surveying desolate asteroids. This lonely work honed {name}'s mining skills and resilience." };
+    g_Backstories[L"Bureaucrat"] = { L"Bureaucrat", L"{name} navigated the endless paperwork of a galactic empire. While not skilled in any practical sense, {name} is a surprisingly fast researcher and gets along with most people." };
+
+    g_SkillDescriptions[L"Mining"] = L"The ability to dig into rock and extract useful minerals and stone blocks. Higher skill levels yield more resources per rock.";
+    g_SkillDescriptions[L"Chopping"] = L"Felling trees and cacti to gather wood. A higher skill means faster chopping.";
+    g_SkillDescriptions[L"Farming"] = L"Sowing and harvesting crops. Skilled farmers have a greater chance to yield more food per plant.";
+    g_SkillDescriptions[L"Construction"] = L"The ability to build structures and furniture from blueprints. Skilled constructors build faster and occasionally produce higher quality items.";
+    g_SkillDescriptions[L"Hauling"] = L"The task of moving resources and items around the colony. Not a skill, but a labor priority.";
+    g_SkillDescriptions[L"Cooking"] = L"Preparing raw ingredients into meals. Higher skill produces better meals that provide more happiness.";
+    g_SkillDescriptions[L"Hunting"] = L"The art of tracking and killing wild animals for food and resources. Not yet implemented.";
+    g_SkillDescriptions[L"Research"] = L"The ability to perform scientific research at a research bench. Higher skill contributes more research points per day.";
+    g_SkillDescriptions[L"Deconstruction"] = L"Tearing down built structures and furniture. Uses the Construction skill. Higher skill works faster and may recover more resources.";
+}
+
+void initCritterData() {
+    g_CritterData.clear();
+
+    // The critter's tags
+
+    // Main Groups
+    g_CritterTagNames[CritterTag::NONE] = L"None";
+    g_CritterTagNames[CritterTag::MAMMAL] = L"Mammal";
+    g_CritterTagNames[CritterTag::MARINE_MAMMAL] = L"Marine Mammal";
+    g_CritterTagNames[CritterTag::BIRD] = L"Bird";
+    g_CritterTagNames[CritterTag::INSECT] = L"Insect";
+    g_CritterTagNames[CritterTag::RODENT] = L"Rodent";
+    g_CritterTagNames[CritterTag::REPTILE] = L"Reptile";
+    g_CritterTagNames[CritterTag::ARACHNID] = L"Arachnid";
+    g_CritterTagNames[CritterTag::CRUSTACEAN] = L"Crustacean";
+    g_CritterTagNames[CritterTag::CNIDARIAN] = L"Cnidarian";
+    g_CritterTagNames[CritterTag::AMPHIBIAN] = L"Amphibian";
+    g_CritterTagNames[CritterTag::FISH] = L"Fish";
+    g_CritterTagNames[CritterTag::CRYPTID] = L"Cryptid";
+    g_CritterTagNames[CritterTag::YOUKAI] = L"Youkai";
+    g_CritterTagNames[CritterTag::MYTHICAL] = L"Mythical";
+    g_CritterTagNames[CritterTag::BEAST] = L"Beast";
+    g_CritterTagNames[CritterTag::MEGAFAUNA] = L"Megafauna";
+    g_CritterTagNames[CritterTag::CELESTIAL] = L"Celestial";
+    g_CritterTagNames[CritterTag::DEMON] = L"Demon";
+    g_CritterTagNames[CritterTag::ABERRATION] = L"Aberration";
+    g_CritterTagNames[CritterTag::ENTITY] = L"Entity";
+    // Sub-Tags
+    g_CritterTagNames[CritterTag::LIVESTOCK] = L"Livestock";
+    g_CritterTagNames[CritterTag::DOMESTIC] = L"Domestic";
+    g_CritterTagNames[CritterTag::UNDEAD] = L"Undead";
+    g_CritterTagNames[CritterTag::PRIMATE] = L"Primate";
+    g_CritterTagNames[CritterTag::HUMANOID] = L"Humanoid";
+    g_CritterTagNames[CritterTag::MARSUPIAL] = L"Marsupial";
+    g_CritterTagNames[CritterTag::MOLLUSK] = L"Mollusk";
+    g_CritterTagNames[CritterTag::ANNELID] = L"Annelid";
+    g_CritterTagNames[CritterTag::DINOSAUR] = L"Dinosaur";
+    g_CritterTagNames[CritterTag::DRAGONOID] = L"Dragonoid";
+    g_CritterTagNames[CritterTag::FAE] = L"Fae";
+    g_CritterTagNames[CritterTag::CONSTRUCT] = L"Construct";
+    g_CritterTagNames[CritterTag::CHIMERA] = L"Chimera";
+    g_CritterTagNames[CritterTag::GIANT] = L"Giant";
+    g_CritterTagNames[CritterTag::PLANTFOLK] = L"Plantfolk";
+    g_CritterTagNames[CritterTag::CHIROPTERA] = L"Chiroptera";
+    g_CritterTagNames[CritterTag::CETACEAN] = L"Cetacean";
+    g_CritterTagNames[CritterTag::MUSTELID] = L"Mustelid";
+    g_CritterTagNames[CritterTag::PACHYDERM] = L"Pachyderm";
+    // Sub-Sub-Tags (Behavior/Attribute)
+    g_CritterTagNames[CritterTag::PREDATOR] = L"Predator";
+    g_CritterTagNames[CritterTag::VERMIN] = L"Vermin";
+    g_CritterTagNames[CritterTag::SCAVENGER] = L"Scavenger";
+    g_CritterTagNames[CritterTag::FLYING] = L"Flying";
+    g_CritterTagNames[CritterTag::AQUATIC] = L"Aquatic";
+    g_CritterTagNames[CritterTag::VENOMOUS] = L"Venomous";
+    g_CritterTagNames[CritterTag::NOCTURNAL] = L"Nocturnal";
+    g_CritterTagNames[CritterTag::MIGRATORY] = L"Migratory";
+    g_CritterTagNames[CritterTag::PARASITIC] = L"Parasitic";
+    g_CritterTagNames[CritterTag::PACK_ANIMAL] = L"Pack Animal";
+    g_CritterTagNames[CritterTag::BURROWING] = L"Burrowing";
+    g_CritterTagNames[CritterTag::DIURNAL] = L"Diurnal";
+    g_CritterTagNames[CritterTag::SWARMING] = L"Swarming";
+    g_CritterTagNames[CritterTag::PARTHENOGENIC] = L"Parthenogenic";
+    g_CritterTagNames[CritterTag::SYNTHETIC] = L"Synthetic";
+    g_CritterTagNames[CritterTag::MUTATED] = L"Mutated";
+    g_CritterTagNames[CritterTag::MOUNT] = L"Mount";
+
+    // The critters themselvew
+
+    // Mammals
+    g_CritterData[CritterType::DEER] = { L"Deer", L'd', makeColor(184, 134, 11), {CritterTag::MAMMAL, CritterTag::DIURNAL}, 80 };
+    g_CritterData[CritterType::WOLF] = { L"Wolf", L'w', makeColor(169, 169, 169), {CritterTag::MAMMAL, CritterTag::PREDATOR, CritterTag::NOCTURNAL, CritterTag::PACK_ANIMAL}, 60 };
+    g_CritterData[CritterType::PIG] = { L"Pig", L'p', makeColor(255, 182, 193), {CritterTag::MAMMAL, CritterTag::LIVESTOCK, CritterTag::SCAVENGER}, 100 };
+    g_CritterData[CritterType::COW] = { L"Cow", L'c', makeColor(245, 245, 220), {CritterTag::MAMMAL, CritterTag::LIVESTOCK, CritterTag::PACK_ANIMAL}, 120 };
+    g_CritterData[CritterType::SHEEP] = { L"Sheep", L's', makeColor(230, 230, 230), {CritterTag::MAMMAL, CritterTag::LIVESTOCK, CritterTag::PACK_ANIMAL}, 110 };
+    g_CritterData[CritterType::GOAT] = { L"Goat", L'g', makeColor(210, 180, 140), {CritterTag::MAMMAL, CritterTag::LIVESTOCK}, 90 };
+    g_CritterData[CritterType::CAT] = { L"Cat", L'c', makeColor(150, 75, 0), {CritterTag::MAMMAL, CritterTag::DOMESTIC, CritterTag::PREDATOR}, 70 };
+    g_CritterData[CritterType::DOG] = { L"Dog", L'd', makeColor(139, 69, 19), {CritterTag::MAMMAL, CritterTag::DOMESTIC, CritterTag::PACK_ANIMAL}, 75 };
+    g_CritterData[CritterType::MONKEY] = { L"Monkey", L'm', makeColor(160, 82, 45), {CritterTag::MAMMAL, CritterTag::PRIMATE}, 50 };
+    g_CritterData[CritterType::KANGAROO] = { L"Kangaroo", L'k', makeColor(205, 133, 63), {CritterTag::MAMMAL, CritterTag::MARSUPIAL}, 85 };
+    g_CritterData[CritterType::BEAR] = { L"Bear", L'B', makeColor(139, 69, 19), {CritterTag::MAMMAL, CritterTag::PREDATOR, CritterTag::MEGAFAUNA}, 130 };
+
+    // Rodents
+    g_CritterData[CritterType::RAT] = { L"Rat", L'r', makeColor(90, 90, 90), {CritterTag::RODENT, CritterTag::VERMIN, CritterTag::NOCTURNAL, CritterTag::SCAVENGER}, 50 };
+    g_CritterData[CritterType::SQUIRREL] = { L"Squirrel", L's', makeColor(150, 75, 0), {CritterTag::RODENT, CritterTag::DIURNAL}, 45 };
+
+    // Marine Mammals
+    g_CritterData[CritterType::DOLPHIN] = { L"Dolphin", L'd', makeColor(0, 191, 255), {CritterTag::MARINE_MAMMAL, CritterTag::AQUATIC, CritterTag::CETACEAN}, 50 };
+    g_CritterData[CritterType::WHALE] = { L"Whale", L'W', makeColor(70, 130, 180), {CritterTag::MARINE_MAMMAL, CritterTag::AQUATIC, CritterTag::MEGAFAUNA, CritterTag::CETACEAN}, 200 };
+
+    // Birds
+    g_CritterData[CritterType::PIGEON] = { L"Pigeon", L'p', makeColor(128, 128, 128), {CritterTag::BIRD, CritterTag::FLYING, CritterTag::VERMIN}, 40 };
+    g_CritterData[CritterType::HAWK] = { L"Hawk", L'h', makeColor(139, 69, 19), {CritterTag::BIRD, CritterTag::FLYING, CritterTag::PREDATOR}, 30 };
+
+    // Fish
+    g_CritterData[CritterType::TROUT] = { L"Trout", L'f', makeColor(192, 192, 192), {CritterTag::FISH, CritterTag::AQUATIC}, 60 };
+    g_CritterData[CritterType::TUNA] = { L"Tuna", L't', makeColor(0, 0, 139), {CritterTag::FISH, CritterTag::AQUATIC}, 55 };
+
+    // Reptiles
+    g_CritterData[CritterType::SNAKE] = { L"Snake", L's', makeColor(0, 100, 0), {CritterTag::REPTILE, CritterTag::PREDATOR, CritterTag::VENOMOUS}, 90 };
+    g_CritterData[CritterType::LIZARD] = { L"Lizard", L'l', makeColor(50, 205, 50), {CritterTag::REPTILE, CritterTag::DIURNAL}, 70 };
+
+    // Arachnids
+    g_CritterData[CritterType::SPIDER] = { L"Spider", L'x', makeColor(40, 40, 40), {CritterTag::ARACHNID, CritterTag::PREDATOR, CritterTag::NOCTURNAL}, 80 };
+
+    // Crustaceans
+    g_CritterData[CritterType::CRAB] = { L"Crab", L'c', makeColor(255, 69, 0), {CritterTag::CRUSTACEAN, CritterTag::AQUATIC, CritterTag::SCAVENGER}, 110 };
+
+    // Undead
+    g_CritterData[CritterType::ZOMBIE] = { L"Zombie", L'z', makeColor(0, 128, 0), {CritterTag::UNDEAD, CritterTag::CRYPTID, CritterTag::PREDATOR}, 150 };
+    g_CritterData[CritterType::SKELETON] = { L"Skeleton", L's', makeColor(240, 240, 240), {CritterTag::UNDEAD, CritterTag::CRYPTID, CritterTag::CONSTRUCT}, 100 };
+
+    // Mythical
+    g_CritterData[CritterType::GRIFFIN] = { L"Griffin", L'G', makeColor(218, 165, 32), {CritterTag::MYTHICAL, CritterTag::BEAST, CritterTag::PREDATOR, CritterTag::FLYING, CritterTag::MOUNT}, 40 };
+
+    // Dragonoids
+    g_CritterData[CritterType::WYVERN] = { L"Wyvern", L'W', makeColor(178, 34, 34), {CritterTag::DRAGONOID, CritterTag::REPTILE, CritterTag::PREDATOR, CritterTag::FLYING, CritterTag::MEGAFAUNA}, 35 };
+}
+
+void initBiomeCritterSpawns() {
+    g_BiomeCritters.clear();
+
+    // Land Critters
+    g_BiomeCritters[Biome::TUNDRA] = { CritterType::WOLF, CritterType::DEER };
+    g_BiomeCritters[Biome::BOREAL_FOREST] = { CritterType::WOLF, CritterType::DEER, CritterType::SQUIRREL, CritterType::HAWK, CritterType::BEAR };
+    g_BiomeCritters[Biome::TEMPERATE_FOREST] = { CritterType::DEER, CritterType::PIG, CritterType::SQUIRREL, CritterType::PIGEON, CritterType::SNAKE, CritterType::WOLF, CritterType::CAT };
+    g_BiomeCritters[Biome::JUNGLE] = { CritterType::MONKEY, CritterType::SNAKE, CritterType::WYVERN, CritterType::SPIDER };
+    g_BiomeCritters[Biome::DESERT] = { CritterType::KANGAROO, CritterType::SNAKE, CritterType::LIZARD, CritterType::SPIDER, CritterType::HAWK };
+
+    // Aquatic critters can spawn in any biome that has water.
+    g_BiomeCritters[Biome::OCEAN] = { CritterType::DOLPHIN, CritterType::WHALE, CritterType::TROUT, CritterType::TUNA, CritterType::CRAB };
+}
+
+bool isWalkable(int x, int y, int z) {
+    // Check if coordinates are within world boundaries
+    if (x < 0 || x >= WORLD_WIDTH || y < 0 || y >= WORLD_HEIGHT || z < 0 || z >= TILE_WORLD_DEPTH) {
+        return false; // Out of bounds
+    }
+
+    // Get the MapCell data for the given coordinates
+    const auto& cell = Z_LEVELS[z][y][x];
+    // Get the tags associated with the tile type in this cell
+    const auto& tags = TILE_DATA.at(cell.type).tags;
+
+    // A pawn cannot walk on fluid tiles (like water or molten core)
+    if (std::find(tags.begin(), tags.end(), TileTag::FLUID) != tags.end()) {
+        return false;
+    }
+
+    // A pawn cannot walk through solid structures like walls, or through a tree's occupied space
+    if (cell.type == TileType::WALL || cell.type == TileType::STONE_WALL || cell.tree != nullptr) {
+        return false;
+    }
+
+    // A pawn also cannot walk onto a blueprint if the blueprint is for a blocking structure
+    // (e.g., you can't walk onto a "blueprint for a wall", but you can walk onto a "blueprint for a floor")
+    if (cell.type == TileType::BLUEPRINT) {
+        // If the target type of the blueprint is a blocking structure, it's not walkable
+        const auto& target_tags = TILE_DATA.at(cell.target_type).tags;
+        if (std::find(target_tags.begin(), target_tags.end(), TileTag::STRUCTURE) != target_tags.end() &&
+            cell.target_type != TileType::WOOD_FLOOR && // Allow walking on floor blueprints
+            cell.target_type != TileType::DIRT_FLOOR && // Just in case, if these become blueprints
+            cell.target_type != TileType::GRASS // etc.
+            ) {
+            return false;
+        }
+    }
+
+    // Most other tile types (dirt, grass, stone floor, empty space, items on ground, furniture, stairs) are considered walkable.
+    return true;
+}
+
+// Function that should be defined before updateGame() if used there
+bool isDeconstructable(TileType type) {
+    if (TILE_DATA.count(type) == 0) return false;
+    const auto& tags = TILE_DATA.at(type).tags;
+    return (type == TileType::BLUEPRINT || // Allow deconstructing (canceling) blueprints
+        std::find(tags.begin(), tags.end(), TileTag::STRUCTURE) != tags.end() ||
+        std::find(tags.begin(), tags.end(), TileTag::FURNITURE) != tags.end() ||
+        std::find(tags.begin(), tags.end(), TileTag::LIGHTS) != tags.end() ||
+        std::find(tags.begin(), tags.end(), TileTag::PRODUCTION) != tags.end());
+}
+
+bool blocksLight(int x, int y, int z) {
+    const MapCell& cell = Z_LEVELS[z][y][x];
+    if (cell.type == TileType::WALL || cell.type == TileType::STONE_WALL) return true;
+    for (TileTag tag : TILE_DATA.at(cell.type).tags) {
+        if (tag == TileTag::STONE || tag == TileTag::MINERAL || tag == TileTag::TREE_TRUNK) return true;
+    }
+    return false;
+}
+
+void markLightRectStale(int z, int left, int top, int right, int bottom) {
+    if (z < 0 || z >= (int)g_lightMaps.size()) return;
+    CellRect rect = { std::max(left, 0), std::max(top, 0), std::min(right, WORLD_WIDTH - 1), std::min(bottom, WORLD_HEIGHT - 1) };
+    if (rect.left > rect.right || rect.top > rect.bottom) return;
+    std::vector<CellRect>& stale = g_lightMaps[z].stale;
+    for (const CellRect& r : stale) {
+        if (r.left <= rect.left && r.top <= rect.top && r.right >= rect.right && r.bottom >= rect.bottom) return; // Already covered
+    }
+    stale.push_back(rect);
+}
+
+void markLightStale(const LightSource& light) {
+    markLightRectStale(light.z, light.x - light.radius, light.y - light.radius, light.x + light.radius, light.y + light.radius);
+}
+
+void addLightSource(const LightSource& light) {
+    g_lightSources.push_back(light);
+    markLightStale(light);
+}
+
+void removeLightSourcesAt(int x, int y, int z) {
+    for (const LightSource& light : g_lightSources) {
+        if (light.x == x && light.y == y && light.z == z) markLightStale(light);
+    }
+    g_lightSources.erase(std::remove_if(g_lightSources.begin(), g_lightSources.end(),
+        [&](const LightSource& ls) { return ls.x == x && ls.y == y && ls.z == z; }),
+        g_lightSources.end());
+}
+
+// A changed cell can only move the shadows of lights that reach it, and only if it turned opaque or clear. Callers
+// mark cells both before and after editing them, so the opacity is compared in updateLightMaps, once the edit is
+// done. Cells no light has looked at are in full shadow, so changing them cannot let light through either.
+void markLightCellChanged(int x, int y, int z) {
+    if (!g_lightShadows || z < 0 || z >= (int)g_lightMaps.size()) return;
+    LightMapLevel& map = g_lightMaps[z];
+    if (map.seen.empty()) return;
+    uint8_t& seen = map.seen[y * WORLD_WIDTH + x];
+    if (seen == 0 || (seen & LIGHT_CELL_QUEUED)) return;
+    seen |= LIGHT_CELL_QUEUED;
+    map.changed.push_back(y * WORLD_WIDTH + x);
+}
+
+// Marks the lights around each queued cell stale if the cell's opacity no longer matches what they last saw.
+void checkChangedLightCells(int z, LightMapLevel& map) {
+    for (int index : map.changed) {
+        uint8_t& seen = map.seen[index];
+        seen = (uint8_t)(seen & ~LIGHT_CELL_QUEUED);
+        int x = index % WORLD_WIDTH, y = index / WORLD_WIDTH;
+        if ((seen == 2) == blocksLight(x, y, z)) continue;
+        for (const LightSource& light : g_lightSources) {
+            if (light.z == z && abs(x - light.x) <= light.radius && abs(y - light.y) <= light.radius) markLightStale(light);
+        }
+    }
+    map.changed.clear();
+}
+
+// Sizes the maps to the current world and marks every light stale.
+void invalidateLightMaps() {
+    g_lightMaps.assign(TILE_WORLD_DEPTH, LightMapLevel());
+    for (const LightSource& light : g_lightSources) markLightStale(light);
+}
+
+void addLightAt(const LightSource& light, const CellRect& clip, std::vector<float>& level, int x, int y) {
+    if (x < clip.left || x > clip.right || y < clip.top || y > clip.bottom) return;
+    float dist = sqrtf((float)((x - light.x) * (x - light.x) + (y - light.y) * (y - light.y)));
+    if (dist >= light.radius) return;
+    float& cell = level[y * WORLD_WIDTH + x];
+    cell = std::max(cell, 1.0f - (dist / light.radius));
+}
+
+// Recursive shadowcasting over one octant: rows step away from the light, and every opaque cell narrows the
+// range of slopes the next rows can still see. The multipliers map the octant's (dx, dy) onto the map.
+void castLightOctant(const LightSource& light, const CellRect& clip, LightMapLevel& map, int row, float startSlope, float endSlope, int xx, int xy, int yx, int yy) {
+    if (startSlope < endSlope) return;
+    float nextStartSlope = startSlope;
+    for (int i = row; i <= light.radius; ++i) {
+        bool blocked = false;
+        for (int dx = -i, dy = -i; dx <= 0; ++dx) {
+            float leftSlope = (dx - 0.5f) / (dy + 0.5f);
+            float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+            if (startSlope < rightSlope) continue;
+            if (endSlope > leftSlope) break;
+
+            int x = light.x + dx * xx + dy * xy;
+            int y = light.y + dx * yx + dy * yy;
+            bool inWorld = x >= 0 && x < WORLD_WIDTH && y >= 0 && y < WORLD_HEIGHT;
+            bool opaque = !inWorld || blocksLight(x, y, light.z);
+            if (inWorld) {
+                addLightAt(light, clip, map.level, x, y);
+                map.seen[y * WORLD_WIDTH + x] = opaque ? 2 : 1;
+            }
+            if (blocked) {
+                if (opaque) {
+                    nextStartSlope = rightSlope;
+                }
+                else {
+                    blocked = false;
+                    startSlope = nextStartSlope;
+                }
+            }
+            else if (opaque && i < light.radius) {
+                blocked = true;
+                castLightOctant(light, clip, map, i + 1, startSlope, leftSlope, xx, xy, yx, yy);
+                nextStartSlope = rightSlope;
+            }
+        }
+        if (blocked) break;
+    }
+}
+
+// Adds one light's contribution to the cells of the map inside clip.
+void castLight(const LightSource& light, const CellRect& clip, LightMapLevel& map) {
+    if (light.x < 0 || light.x >= WORLD_WIDTH || light.y < 0 || light.y >= WORLD_HEIGHT) return;
+    if (!g_lightShadows) {
+        for (int y = std::max((int)clip.top, light.y - light.radius); y <= std::min((int)clip.bottom, light.y + light.radius); ++y) {
+            for (int x = std::max((int)clip.left, light.x - light.radius); x <= std::min((int)clip.right, light.x + light.radius); ++x) {
+                addLightAt(light, clip, map.level, x, y);
+            }
+        }
+        return;
+    }
+    static const int OCTANTS[8][4] = {
+        { 1, 0, 0, 1 }, { 0, 1, 1, 0 }, { 0, -1, 1, 0 }, { -1, 0, 0, 1 },
+        { -1, 0, 0, -1 }, { 0, -1, -1, 0 }, { 0, 1, -1, 0 }, { 1, 0, 0, -1 }
+    };
+    addLightAt(light, clip, map.level, light.x, light.y);
+    for (const auto& m : OCTANTS) castLightOctant(light, clip, map, 1, 1.0f, 0.0f, m[0], m[1], m[2], m[3]);
+}
+
+// Recomputes every stale square: clear it, then let each light that reaches it shine in again.
+void updateLightMaps() {
+    PROFILE_SCOPE(ProfileCategory::RENDER, __func__);
+    for (int z = 0; z < (int)g_lightMaps.size(); ++z) {
+        LightMapLevel& map = g_lightMaps[z];
+        checkChangedLightCells(z, map);
+        if (map.stale.empty()) continue;
+        if (map.level.empty()) {
+            map.level.assign(WORLD_WIDTH * WORLD_HEIGHT, 0.0f);
+            map.seen.assign(WORLD_WIDTH * WORLD_HEIGHT, 0);
+        }
+        for (const CellRect& rect : map.stale) {
+            for (int y = rect.top; y <= rect.bottom; ++y) {
+                std::fill(map.level.begin() + y * WORLD_WIDTH + rect.left, map.level.begin() + y * WORLD_WIDTH + rect.right + 1, 0.0f);
+            }
+            for (const LightSource& light : g_lightSources) {
+                if (light.z != z || light.x + light.radius < rect.left || light.x - light.radius > rect.right ||
+                    light.y + light.radius < rect.top || light.y - light.radius > rect.bottom) continue;
+                castLight(light, rect, map);
+            }
+        }
+        map.stale.clear();
+    }
+}
+
+float lightMapAt(int x, int y, int z) {
+    if (z < 0 || z >= (int)g_lightMaps.size() || g_lightMaps[z].level.empty()) return 0.0f;
+    if (x < 0 || x >= WORLD_WIDTH || y < 0 || y >= WORLD_HEIGHT) return 0.0f;
+    return g_lightMaps[z].level[y * WORLD_WIDTH + x];
+}
+
+// --- Solid Column Index ---
+void invalidateSolidColumns() {
+    g_solidColumns.valid = false;
+}
+
+void markSolidColumnDirty(int x, int y) {
+    SolidColumnIndex& index = g_solidColumns;
+    if (!index.valid) return; // The next update rebuilds every column anyway
+    int column = y * WORLD_WIDTH + x;
+    if (index.dirty[column]) return;
+    index.dirty[column] = 1;
+    index.dirtyColumns.push_back(column);
+}
+
+void rebuildSolidColumn(int column) {
+    SolidColumnIndex& index = g_solidColumns;
+    uint64_t* bits = &index.bits[(size_t)column * index.words];
+    std::fill(bits, bits + index.words, 0);
+    int x = column % WORLD_WIDTH, y = column / WORLD_WIDTH;
+    for (int z = 0; z < TILE_WORLD_DEPTH; ++z) {
+        if (Z_LEVELS[z][y][x].type != TileType::EMPTY) bits[z / 64] |= 1ULL << (z % 64);
+    }
+}
+
+void updateSolidColumns() {
+    PROFILE_SCOPE(ProfileCategory::RENDER, __func__);
+    SolidColumnIndex& index = g_solidColumns;
+    if ((int)Z_LEVELS.size() != TILE_WORLD_DEPTH || TILE_WORLD_DEPTH == 0) return;
+    if (!index.valid) {
+        int columns = WORLD_WIDTH * WORLD_HEIGHT;
+        index.words = (TILE_WORLD_DEPTH + 63) / 64;
+        index.bits.assign((size_t)columns * index.words, 0);
+        index.dirty.assign(columns, 0);
+        index.dirtyColumns.clear();
+        for (int column = 0; column < columns; ++column) rebuildSolidColumn(column);
+        index.valid = true;
+        return;
+    }
+    for (int column : index.dirtyColumns) {
+        rebuildSolidColumn(column);
+        index.dirty[column] = 0;
+    }
+    index.dirtyColumns.clear();
+}
+
+int highestSetBit(uint64_t value) {
+    int bit = 0;
+    for (int shift = 32; shift > 0; shift /= 2) {
+        if (value >> shift) { value >>= shift; bit += shift; }
+    }
+    return bit;
+}
+
+// The highest Z at or below z whose cell is not EMPTY, or -1 if the column is empty down to the core.
+int solidCellAtOrBelow(int x, int y, int z) {
+    const SolidColumnIndex& index = g_solidColumns;
+    if (!index.valid || z < 0) return -1;
+    z = std::min(z, TILE_WORLD_DEPTH - 1);
+    const uint64_t* bits = &index.bits[(size_t)(y * WORLD_WIDTH + x) * index.words];
+    int word = z / 64;
+    uint64_t mask = (z % 64 == 63) ? ~0ULL : ((1ULL << (z % 64 + 1)) - 1);
+    for (; word >= 0; --word, mask = ~0ULL) {
+        uint64_t solid = bits[word] & mask;
+        if (solid) return word * 64 + highestSetBit(solid);
+    }
+    return -1;
+}
+
+float seeThroughShade(int depth) {
+    return std::max(SEE_THROUGH_MIN_SHADE, powf(SEE_THROUGH_SHADE_PER_LEVEL, (float)depth));
+}
+
+
+// The new pathfinding function, should be defined before updateGame()
+std::vector<Point3D> findPath(Point3D start, Point3D end) {
+    if (start.x == end.x && start.y == end.y && start.z == end.z) {
+        return { start }; // Already at destination
+    }
+
+    std::queue<Point3D> q;
+    std::map<Point3D, Point3D> came_from; // To reconstruct the path
+    std::set<Point3D> visited;           // To avoid cycles and redundant checks
+
+    q.push(start);
+    visited.insert(start);
+
+    bool path_found = false;
+
+    while (!q.empty()) {
+        Point3D current = q.front();
+        q.pop();
+
+        if (current.x == end.x && current.y == end.y && current.z == end.z) {
+            path_found = true;
+            break;
+        }
+
+        // Neighbors on the same Z-level (8 directions)
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dy == 0) continue;
+
+                Point3D neighbor = { current.x + dx, current.y + dy, current.z };
+
+                if (isWalkable(neighbor.x, neighbor.y, neighbor.z) && visited.find(neighbor) == visited.end()) {
+                    visited.insert(neighbor);
+                    came_from[neighbor] = current;
+                    q.push(neighbor);
+                }
+            }
+        }
+
+        // Check for stairs to move between Z-levels
+        TileType currentTile = Z_LEVELS[current.z][current.y][current.x].type;
+
+        // Try to go DOWN
+        if (currentTile == TileType::STAIR_DOWN && current.z > 0) {
+            Point3D neighbor = { current.x, current.y, current.z - 1 };
+            // Check if the tile below is a STAIR_UP AND is walkable (the stair itself is walkable)
+            if (Z_LEVELS[neighbor.z][neighbor.y][neighbor.x].type == TileType::STAIR_UP &&
+                isWalkable(neighbor.x, neighbor.y, neighbor.z) && visited.find(neighbor) == visited.end()) {
+                visited.insert(neighbor);
+                came_from[neighbor] = current;
+                q.push(neighbor);
+            }
+        }
+
+        // Try to go UP
+        if (currentTile == TileType::STAIR_UP && current.z < TILE_WORLD_DEPTH - 1) {
+            Point3D neighbor = { current.x, current.y, current.z + 1 };
+            // Check if the tile above is a STAIR_DOWN AND is walkable (the stair itself is walkable)
+            if (Z_LEVELS[neighbor.z][neighbor.y][neighbor.x].type == TileType::STAIR_DOWN &&
+                isWalkable(neighbor.x, neighbor.y, neighbor.z) && visited.find(neighbor) == visited.end()) {
+                visited.insert(neighbor);
+                came_from[neighbor] = current;
+                q.push(neighbor);
+            }
+        }
+    }
+
+    std::vector<Point3D> path;
+    if (path_found) {
+        Point3D current = end;
+        while (!(current.x == start.x && current.y == start.y && current.z == start.z)) {
+            path.push_back(current);
+            current = came_from[current];
+        }
+        path.push_back(start);
+        std::reverse(path.begin(), path.end());
+    }
+    return path;
+}
+
+
+
+bool isCritterWalkable(int x, int y, int z) {
+    if (x < 0 || x >= WORLD_WIDTH || y < 0 || y >= WORLD_HEIGHT || z < 0 || z >= TILE_WORLD_DEPTH) {
+        return false; // Out of bounds
+    }
+    const auto& cell = Z_LEVELS[z][y][x];
+    const auto& tags = TILE_DATA.at(cell.type).tags;
+
+    // Critters cannot walk on fluid tiles
+    if (std::find(tags.begin(), tags.end(), TileTag::FLUID) != tags.end()) {
+        return false;
+    }
+
+    // Unwalkable if it's a solid structure (like a wall)
+    if (cell.type == TileType::WALL || cell.type == TileType::STONE_WALL) {
+        return false;
+    }
+
+    // Unlike pawns, critters can move through tiles with trees.
+    // Most other tile types are walkable (ground, floor, blueprints, furniture, stairs etc.)
+    return true;
+}
+
+// NEW: Pre-computes a map of all tiles reachable by any colonist.
+// This is called once when entering build mode to prevent lag during preview.
+void computeGlobalReachability() {
+    // 1. Initialize the map to be all false.
+    g_isTileReachable.assign(TILE_WORLD_DEPTH, std::vector<std::vector<bool>>(WORLD_HEIGHT, std::vector<bool>(WORLD_WIDTH, false)));
+    if (colonists.empty()) {
+        return; // If there are no colonists, nothing is reachable.
+    }
+
+    // 2. Setup a queue for a multi-source Breadth-First Search (BFS).
+    std::queue<Point3D> q;
+
+    // 3. Add all colonist positions as the starting sources for the search.
+    for (const auto& pawn : colonists) {
+        if (pawn.x >= 0 && pawn.y >= 0 && pawn.z >= 0) { // Safety check
+            if (!g_isTileReachable[pawn.z][pawn.y][pawn.x]) {
+                q.push({ pawn.x, pawn.y, pawn.z });
+                g_isTileReachable[pawn.z][pawn.y][pawn.x] = true;
+            }
+        }
+    }
+
+    // 4. Run the BFS to find all reachable tiles.
+    while (!q.empty()) {
+        Point3D current = q.front();
+        q.pop();
+
+        // Explore neighbors on the same z-level.
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dy == 0) continue;
+
+                Point3D neighbor = { current.x + dx, current.y + dy, current.z };
+                if (isWalkable(neighbor.x, neighbor.y, neighbor.z) && !g_isTileReachable[neighbor.z][neighbor.y][neighbor.x]) {
+                    g_isTileReachable[neighbor.z][neighbor.y][neighbor.x] = true;
+                    q.push(neighbor);
+                }
+            }
+        }
+
+        // Explore neighbors on different z-levels via stairs.
+        TileType currentTile = Z_LEVELS[current.z][current.y][current.x].type;
+        // Check for going down
+        if (currentTile == TileType::STAIR_DOWN && current.z > 0 && Z_LEVELS[current.z - 1][current.y][current.x].type == TileType::STAIR_UP) {
+            Point3D neighbor = { current.x, current.y, current.z - 1 };
+            if (!g_isTileReachable[neighbor.z][neighbor.y][neighbor.x]) {
+                g_isTileReachable[neighbor.z][neighbor.y][neighbor.x] = true;
+                q.push(neighbor);
+            }
+        }
+        // Check for going up
+        if (currentTile == TileType::STAIR_UP && current.z < TILE_WORLD_DEPTH - 1 && Z_LEVELS[current.z + 1][current.y][current.x].type == TileType::STAIR_DOWN) {
+            Point3D neighbor = { current.x, current.y, current.z + 1 };
+            if (!g_isTileReachable[neighbor.z][neighbor.y][neighbor.x]) {
+                g_isTileReachable[neighbor.z][neighbor.y][neighbor.x] = true;
+                q.push(neighbor);
+            }
+        }
+    }
+}
+
+bool isReachable(Point3D start, Point3D end) {
+    // If start and end are the same, it's reachable.
+    if (start.x == end.x && start.y == end.y && start.z == end.z) {
+        return true;
+    }
+
+    // --- 3D Breadth-First Search (BFS) for Pathfinding ---
+
+    std::queue<Point3D> q;
+    // Visited set prevents us from checking the same tile multiple times.
+    std::set<Point3D> visited;
+
+    // The maximum number of tiles to check. This is a safety break
+    // to prevent the game from freezing if a path is extremely long or complex.
+    const int MAX_SEARCH_NODES = 20000;
+    int nodesProcessed = 0;
+
+    // Start the search from the pawn's current position.
+    q.push(start);
+    visited.insert(start);
+
+    while (!q.empty()) {
+        nodesProcessed++;
+        if (nodesProcessed > MAX_SEARCH_NODES) {
+            return false; // Path is too long or complex, assume unreachable.
+        }
+
+        Point3D current = q.front();
+        q.pop();
+
+        // Check if we have reached the destination.
+        if (current.x == end.x && current.y == end.y && current.z == end.z) {
+            return true;
+        }
+
+        // --- Explore Neighbors ---
+
+        // 1. Check adjacent tiles on the SAME Z-level (x, y movement)
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dy == 0) continue;
+
+                Point3D neighbor = { current.x + dx, current.y + dy, current.z };
+
+                if (isWalkable(neighbor.x, neighbor.y, neighbor.z) && visited.find(neighbor) == visited.end()) {
+                    visited.insert(neighbor);
+                    q.push(neighbor);
+                }
+            }
+        }
+
+        // 2. Check for stairs to move between Z-levels
+        TileType currentTile = Z_LEVELS[current.z][current.y][current.x].type;
+
+        // Check for STAIRS DOWN
+        if (currentTile == TileType::STAIR_DOWN && current.z > 0) {
+            // The tile below must be a corresponding STAIR_UP to be usable.
+            if (Z_LEVELS[current.z - 1][current.y][current.x].type == TileType::STAIR_UP) {
+                Point3D neighbor = { current.x, current.y, current.z - 1 };
+                if (visited.find(neighbor) == visited.end()) {
+                    visited.insert(neighbor);
+                    q.push(neighbor);
+                }
+            }
+        }
+
+        // Check for STAIRS UP
+        if (currentTile == TileType::STAIR_UP && current.z < TILE_WORLD_DEPTH - 1) {
+            // The tile above must be a corresponding STAIR_DOWN to be usable.
+            if (Z_LEVELS[current.z + 1][current.y][current.x].type == TileType::STAIR_DOWN) {
+                Point3D neighbor = { current.x, current.y, current.z + 1 };
+                if (visited.find(neighbor) == visited.end()) {
+                    visited.insert(neighbor);
+                    q.push(neighbor);
+                }
+            }
+        }
+    }
+
+    return false; // The queue is empty but we never found the destination, so no path exists.
+}
+
+bool isReachableByAnyColonist(Point3D target) {
+    if (colonists.empty()) {
+        return false; // No one can reach it if there's no one to try
+    }
+    for (const auto& pawn : colonists) {
+        if (isReachable({ pawn.x, pawn.y, pawn.z }, target)) {
+            return true; // Found at least one pawn that can reach the target
+        }
+    }
+    return false; // No pawns can reach the target
+}
+
+bool CanBuildOn(int x, int y, int z, TileType toBuild) {
+    if (x < 0 || x >= WORLD_WIDTH || y < 0 || y >= WORLD_HEIGHT || z < 0 || z >= TILE_WORLD_DEPTH) {
+        return false;
+    }
+
+    const MapCell& cell = Z_LEVELS[z][y][x];
+    const auto& tags = TILE_DATA.at(cell.type).tags;
+
+    // Special case: Allow building wood floors directly on water tiles
+    if (toBuild == TileType::WOOD_FLOOR && cell.type == TileType::WATER) {
+        return true;
+    }
+
+    // Check for explicit blocking conditions first
+    if (cell.tree != nullptr ||
+        cell.type == TileType::BLUEPRINT ||
+        std::find(tags.begin(), tags.end(), TileTag::STRUCTURE) != tags.end() ||
+        std::find(tags.begin(), tags.end(), TileTag::FURNITURE) != tags.end() ||
+        std::find(tags.begin(), tags.end(), TileTag::LIGHTS) != tags.end() ||
+        std::find(tags.begin(), tags.end(), TileTag::PRODUCTION) != tags.end() ||
+        std::find(tags.begin(), tags.end(), TileTag::FLUID) != tags.end() ||
+        std::find(tags.begin(), tags.end(), TileTag::STONE) != tags.end() ||
+        std::find(tags.begin(), tags.end(), TileTag::MINERAL) != tags.end() ||
+        std::find(tags.begin(), tags.end(), TileTag::ORE) != tags.end())
+    {
+        return false;
+    }
+
+    // Allow building on any other tile that isn't explicitly blocked (e.g., floors, empty space)
+    return true;
+}
+
+std::vector<Point2D> BresenhamLine(int x1, int y1, int x2, int y2) {
+    std::vector<Point2D> points;
+    int dx = abs(x2 - x1);
+    int dy = -abs(y2 - y1);
+    int sx = (x1 < x2) ? 1 : -1;
+    int sy = (y1 < y2) ? 1 : -1;
+    int err = dx + dy;
+    int e2;
+
+    while (true) {
+        points.push_back({ x1, y1 });
+        if (x1 == x2 && y1 == y2) break;
+        e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+    return points;
+}
+
+// Clears the world back to what initGameData left: no map, colony, research or stockpiles, and the clock at noon
+// on day one. The world seed is left alone; callers set the one the new world should use.
+void resetWorld() {
+    g_homeSystemStarIndex = -1; colonists.clear(); rerollablePawns.clear(); jobQueue.clear(); resources.clear(); solarSystem.clear(); distantStars.clear(); a_trees.clear(); a_fallingTrees.clear(); nextTreeId = 0; clearItemIndex(); markStairGraphDirty(); invalidateMapHash(); g_critters.clear();
+    Z_LEVELS.clear();
+    for (int y = 0; y < WORLD_HEIGHT; ++y) { designations[y].assign(WORLD_WIDTH, L' '); }
+    landingSiteX = -1; landingSiteY = -1;
+    gameSpeed = 1; g_fastForwardMode = FastForwardMode::OFF; g_fastForwardStopReason = L"";
+    currentLightLevel = 1.0f; isFullMoon = false; currentWeather = Weather::CLEAR; temperature = 15; // updateTime() lerps from these
+    gameTicks = 3600 * 12; updateTime(); resetTimerWheel(gameTicks); resetAiScheduler();
+    g_lightSources.clear();
+    invalidateLightMaps();
+    invalidateSolidColumns();
+    if (g_simHooks.mapReplaced) g_simHooks.mapReplaced();
+
+    // Reset Research
+    g_allResearch.clear(); g_researchDataVersion++; g_completedResearch.clear(); g_currentResearchProject = L""; g_researchProgress = 0;
+
+    // NEW: Reset and initialize unlocked content
+    g_unlockedBuildings.clear();
+    g_unlockedContentVersion++;
+    g_unlockedBuildings.insert(TileType::TORCH); // Torches are available from the start
+    g_unlockedBuildings.insert(TileType::RESEARCH_BENCH); // The basic research bench is available from the start
+
+    // --- START OF FIX ---
+    // Repopulate the research and pawn data after clearing it.
+    initResearchData();
+    initPawnData();
+    // --- END OF FIX ---
+
+    // NEW: Reset Stockpile Data
+    g_stockpiles.clear();
+    g_stockpileSlotById.clear();
+    nextStockpileId = 0;
+    g_unreachableStockpileCache.clear();
+}
+
+Pawn generatePawn() {
+    static std::vector<std::wstring> firstNamesMale;
+    static std::vector<std::wstring> firstNamesFemale;
+
+    // Load names from files on the first call only.
+    if (firstNamesMale.empty()) {
+        firstNamesMale = readNamesFromFile("Data/firstname_male.txt");
+        // If the file is missing or empty, use a fallback list.
+        if (firstNamesMale.empty()) {
+            firstNamesMale = { L"Ronald", L"James", L"William", L"Ken", L"Marcus", L"David" };
+        }
+    }
+    if (firstNamesFemale.empty()) {
+        firstNamesFemale = readNamesFromFile("Data/firstname_female.txt");
+        // If the file is missing or empty, use a fallback list.
+        if (firstNamesFemale.empty()) {
+            firstNamesFemale = { L"Amy", L"Ashley", L"Maria", L"Sarah", L"Jessica", L"Anya" };
+        }
+    }
+
+
+    static std::vector<std::wstring> lastNames;
+
+    // Load last names from file on the first call only.
+    if (lastNames.empty()) {
+        lastNames = readNamesFromFile("Data/lastname.txt");
+        // If the file is missing or empty, use a fallback list.
+        if (lastNames.empty()) {
+            lastNames = { L"Harris", L"Thompson", L"Perez", L"Smith", L"Jones", L"Miller" };
+        }
+    }
+
+
+    // New: Create a temporary list of backstory keys
+    std::vector<std::wstring> backstoryKeys;
+    for (const auto& pair : g_Backstories) backstoryKeys.push_back(pair.first);
+
+    const std::vector<std::wstring> traitList = { L"Industrious", L"Lazy", L"Optimist", L"Pessimist", L"Tough", L"Quick-sleeper", L"Greedy" };
+    Pawn pawn; pawn.gender = (randomInt(g_rngPawns) % 2 == 0) ? L"Male" : L"Female";
+    pawn.name = (pawn.gender == L"Male" ? firstNamesMale[randomInt(g_rngPawns) % firstNamesMale.size()] : firstNamesFemale[randomInt(g_rngPawns) % firstNamesFemale.size()]);
+    pawn.name += L" " + lastNames[randomInt(g_rngPawns) % lastNames.size()];
+    pawn.age = randomInt(g_rngPawns) % 50 + 18;
+    // New: Assign backstory from map keys
+    if (!backstoryKeys.empty()) {
+        pawn.backstory = backstoryKeys[randomInt(g_rngPawns) % backstoryKeys.size()];
+    }
+    else {
+        pawn.backstory = L"Survivor"; // A safe default if data isn't loaded
+    }
+
+    int numTraits = randomInt(g_rngPawns) % 3 + 1; std::vector<std::wstring> availableTraits = traitList;
+    for (int i = 0; i < numTraits && !availableTraits.empty(); ++i) {
+        int traitIndex = randomInt(g_rngPawns) % availableTraits.size();
+        pawn.traits.push_back(availableTraits[traitIndex]);
+        availableTraits.erase(availableTraits.begin() + traitIndex);
+    }
+    for (const auto& jobName : JobTypeNames) { pawn.skills[jobName] = randomInt(g_rngPawns) % 11; }
+    pawn.priorities[JobType::Haul] = 2;
+    for (int i = 0; i < static_cast<int>(JobTypeNames.size()); ++i) { pawn.priorities[(JobType)i] = 2; }
+    return pawn;
+}
+StratumInfo getStratumInfoForZ(int z) {
+    if (z >= TILE_WORLD_DEPTH) {
+        int space_z = z - TILE_WORLD_DEPTH;
+        if (space_z == 0) return { L"Planet View", Stratum::OUTER_SPACE_PLANET_VIEW, 1 };
+        if (space_z == 1) return { L"System View", Stratum::OUTER_SPACE_SYSTEM_VIEW, 1 };
+        return { L"The Beyond", Stratum::OUTER_SPACE_BEYOND, 1 };
+    }
+    int z_accumulator = 0;
+    for (const auto& stratum : strataDefinition) {
+        z_accumulator += stratum.depth;
+        if (z < z_accumulator) return stratum;
+    }
+    return strataDefinition.back();
+}
+std::wstring getDaySuffix(int day) {
+    if (day % 10 == 1 && day != 11) return L"st";
+    if (day % 10 == 2 && day != 12) return L"nd";
+    if (day % 10 == 3 && day != 13) return L"rd";
+    return L"th";
+}
+void spawnTree(int x, int y, TileType type, RandomStream& rng) {
+    Tree tree;
+    tree.id = nextTreeId++;
+    tree.rootX = x;
+    tree.rootY = y;
+    tree.rootZ = BIOSPHERE_Z_LEVEL;
+    tree.type = type;
+
+    int height = 3 + randomInt(rng) % 8; // Height from 3 to 10 z-levels (total)
+    int maxZ = BIOSPHERE_Z_LEVEL + height - 1;
+    if (maxZ >= ATMOSPHERE_TOP_Z) maxZ = ATMOSPHERE_TOP_Z - 1;
+
+    struct TreeGenParams { TileType trunk, branch, leaf; };
+    TreeGenParams params;
+
+    switch (type) {
+    case TileType::OAK: params = { TileType::OAK_TRUNK, TileType::OAK_BRANCH, TileType::OAK_LEAF }; break;
+    case TileType::ACACIA: params = { TileType::ACACIA_TRUNK, TileType::ACACIA_BRANCH, TileType::ACACIA_LEAF }; break;
+    case TileType::SPRUCE: params = { TileType::SPRUCE_TRUNK, TileType::SPRUCE_BRANCH, TileType::SPRUCE_NEEDLE }; break;
+    case TileType::BIRCH: params = { TileType::BIRCH_TRUNK, TileType::BIRCH_BRANCH, TileType::BIRCH_LEAF }; break;
+    case TileType::PINE: params = { TileType::PINE_TRUNK, TileType::PINE_BRANCH, TileType::PINE_NEEDLE }; break;
+    case TileType::POPLAR: params = { TileType::POPLAR_TRUNK, TileType::POPLAR_BRANCH, TileType::POPLAR_LEAF }; break;
+    case TileType::CECROPIA: params = { TileType::CECROPIA_TRUNK, TileType::CECROPIA_BRANCH, TileType::CECROPIA_LEAF }; break;
+    case TileType::COCOA: params = { TileType::COCOA_TRUNK, TileType::COCOA_BRANCH, TileType::COCOA_LEAF }; break;
+    case TileType::CYPRESS: params = { TileType::CYPRESS_TRUNK, TileType::CYPRESS_BRANCH, TileType::CYPRESS_FOLIAGE }; break;
+    case TileType::MAPLE: params = { TileType::MAPLE_TRUNK, TileType::MAPLE_BRANCH, TileType::MAPLE_LEAF }; break;
+    case TileType::TEAK: params = { TileType::TEAK_TRUNK, TileType::TEAK_BRANCH, TileType::TEAK_LEAF }; break;
+
+    case TileType::PALM: {
+        for (int z = BIOSPHERE_Z_LEVEL; z <= maxZ; ++z) tree.parts.push_back({ x, y, z, TileType::PALM_TRUNK });
+        int canopyZ = maxZ;
+        for (int ly = -2; ly <= 2; ++ly) for (int lx = -2; lx <= 2; ++lx) {
+            if (lx == 0 && ly == 0) continue;
+            int px = x + lx, py = y + ly;
+            if (px < 0 || px >= WORLD_WIDTH || py < 0 || py >= WORLD_HEIGHT) continue; // Boundary check
+            if (abs(lx) == abs(ly) || abs(lx) + abs(ly) > 3) continue;
+            if (randomInt(rng) % 2 == 0) tree.parts.push_back({ px, py, canopyZ, TileType::PALM_FROND });
+        }
+        goto finished_generation;
+    }
+    case TileType::SAGUARO: {
+        for (int z = BIOSPHERE_Z_LEVEL; z <= maxZ; ++z) {
+            tree.parts.push_back({ x, y, z, TileType::SAGUARO_TRUNK });
+            if (z > BIOSPHERE_Z_LEVEL + 2 && randomInt(rng) % 4 == 0) { // Add an arm
+                int armDir = (randomInt(rng) % 2 == 0) ? -1 : 1;
+                int armX = x + armDir;
+                if (armX < 0 || armX >= WORLD_WIDTH) continue; // Boundary check
+                int armHeight = z + (randomInt(rng) % 3) + 1;
+                for (int az = z; az < armHeight && az <= maxZ; ++az) tree.parts.push_back({ armX, y, az, TileType::SAGUARO_ARM });
+            }
+        }
+        goto finished_generation;
+    }
+    case TileType::PRICKLYPEAR: {
+        for (int i = 0; i < (height / 2) + 1; ++i) {
+            int px = x + (randomInt(rng) % 3 - 1); int py = y + (randomInt(rng) % 3 - 1);
+            if (px < 0 || px >= WORLD_WIDTH || py < 0 || py >= WORLD_HEIGHT) continue; // Boundary check
+            if (Z_LEVELS[BIOSPHERE_Z_LEVEL][py][px].tree == nullptr) { // Avoid overlap
+                tree.parts.push_back({ px, py, BIOSPHERE_Z_LEVEL, TileType::PRICKLYPEAR_PAD });
+                if (randomInt(rng) % 4 == 0) tree.parts.push_back({ px, py, BIOSPHERE_Z_LEVEL + 1, TileType::PRICKLYPEAR_TUNA });
+            }
+        }
+        goto finished_generation;
+    }
+    case TileType::CHOLLA: {
+        for (int z = BIOSPHERE_Z_LEVEL; z < maxZ; ++z) {
+            tree.parts.push_back({ x, y, z, TileType::CHOLLA_TRUNK });
+            if (randomInt(rng) % 2 == 0) {
+                int jx = x + (randomInt(rng) % 3 - 1); int jy = y + (randomInt(rng) % 3 - 1);
+                if (jx < 0 || jx >= WORLD_WIDTH || jy < 0 || jy >= WORLD_HEIGHT) continue; // Boundary check
+                if ((jx != x || jy != y) && Z_LEVELS[z][jy][jx].tree == nullptr) tree.parts.push_back({ jx, jy, z, TileType::CHOLLA_JOINT });
+            }
+        }
+        goto finished_generation;
+    }
+    default: params = { TileType::TRUNK, TileType::BRANCH, TileType::LEAF }; break;
+    }
+
+    // Generic procedural generation for standard trees
+    for (int z = BIOSPHERE_Z_LEVEL; z <= maxZ; ++z) {
+        int z_offset = z - BIOSPHERE_Z_LEVEL;
+        float height_ratio = (float)z_offset / height;
+
+        // Trunk
+        tree.parts.push_back({ x, y, z, params.trunk });
+        if (height_ratio < 0.3 && randomInt(rng) % 2 == 0) { // Thicker base
+            int tx = x + ((randomInt(rng) % 2 == 0) ? 1 : -1);
+            if (tx >= 0 && tx < WORLD_WIDTH) tree.parts.push_back({ tx, y, z, params.trunk }); // Boundary check
+        }
+
+        // Branches
+        if (height_ratio > 0.2 && height_ratio < 0.9) {
+            if (randomInt(rng) % 100 < 40) { // Chance to grow a branch at this level
+                int branch_len = 1 + randomInt(rng) % 3;
+                int bdx = (randomInt(rng) % 3) - 1; int bdy = (randomInt(rng) % 3) - 1;
+                if (bdx == 0 && bdy == 0) bdx = 1; // Must go somewhere
+                for (int l = 1; l <= branch_len; ++l) {
+                    int bx = x + l * bdx; int by = y + l * bdy;
+                    if (bx < 0 || bx >= WORLD_WIDTH || by < 0 || by >= WORLD_HEIGHT) break; // Boundary check
+                    tree.parts.push_back({ bx, by, z, params.branch });
+                }
+            }
+        }
+        // Leaves/Canopy
+        if (height_ratio > 0.5) {
+            int canopy_radius = (int)(3 * (height_ratio - 0.4));
+            for (int ly = -canopy_radius; ly <= canopy_radius; ++ly) for (int lx = -canopy_radius; lx <= canopy_radius; ++lx) {
+                if (abs(lx) + abs(ly) > canopy_radius) continue; // Roughly circular canopy
+                int px = x + lx; int py = y + ly;
+                if (px < 0 || px >= WORLD_WIDTH || py < 0 || py >= WORLD_HEIGHT) continue; // Boundary check
+                if (randomInt(rng) % 100 < 35) tree.parts.push_back({ px, py, z, params.leaf });
+            }
+        }
+    }
+
+finished_generation:
+    a_trees[tree.id] = tree;
+    for (const auto& part : a_trees[tree.id].parts) {
+        if (part.x >= 0 && part.x < WORLD_WIDTH && part.y >= 0 && part.y < WORLD_HEIGHT && part.z >= 0 && part.z < TILE_WORLD_DEPTH) {
+            MapCell& cell = Z_LEVELS[part.z][part.y][part.x];
+            if (cell.tree == nullptr || TILE_DATA.at(cell.type).tags.empty()) {
+                cell.type = part.type;
+                cell.tree = &a_trees[tree.id];
+                markCellDirty(part.x, part.y, part.z);
+            }
+        }
+    }
+}
+
+void generateFullWorld(Biome biome) {
+    Z_LEVELS.assign(TILE_WORLD_DEPTH, std::vector<std::vector<MapCell>>(WORLD_HEIGHT, std::vector<MapCell>(WORLD_WIDTH)));
+    clearItemIndex(); // Fresh cells hold no items
+    invalidateMapHash();
+    invalidateLightMaps();
+    invalidateSolidColumns();
+    markStairGraphDirty();
+    if (g_simHooks.mapReplaced) g_simHooks.mapReplaced();
+
+    // Each landing site gets its own map seed; every level then draws from its own stream,
+    // so regenerating or reordering one level never shifts the layout of another.
+    uint64_t mapSeed = mixRandomSeed(g_worldSeed, static_cast<uint64_t>(landingSiteY) * PLANET_MAP_WIDTH + static_cast<uint64_t>(landingSiteX));
+    RandomStream surfaceRng = deriveRandomStream(mapSeed, RandomStreamId::SURFACE);
+
+    // --- STEP 1: Define generation parameters ---
+    std::map<Stratum, std::vector<TileType>> stratumStones;
+    stratumStones[Stratum::CRUST] = { TileType::SANDSTONE, TileType::SHALE, TileType::LIMESTONE, TileType::CHALK, TileType::CHERT, TileType::CLAYSTONE, TileType::CONGLOMERATE, TileType::DOLOMITE, TileType::MUDSTONE, TileType::ROCK_SALT, TileType::SANDSTONE, TileType::SHALE, TileType::SILTSTONE };
+    stratumStones[Stratum::LITHOSPHERE] = { TileType::GRANITE, TileType::BASALT, TileType::GABBRO, TileType::SCHIST, TileType::ANDESITE, TileType::DACITE, TileType::RHYOLITE };
+    stratumStones[Stratum::ASTHENOSPHERE] = { TileType::GNEISS, TileType::PHYLLITE, TileType::OBSIDIAN };
+    stratumStones[Stratum::UPPER_MANTLE] = { TileType::DIORITE, TileType::GABBRO, TileType::GNEISS, TileType::MARBLE, TileType::QUARTZITE, TileType::SLATE };
+    stratumStones[Stratum::LOWER_MANTLE] = { TileType::BASALT, TileType::DIORITE };
+    stratumStones[Stratum::OUTER_CORE] = { TileType::MOLTEN_CORE };
+    stratumStones[Stratum::INNER_CORE] = { TileType::CORESTONE };
+
+    std::map<Biome, TileType> biomeGround;
+    biomeGround[Biome::TUNDRA] = TileType::SNOW;
+    biomeGround[Biome::BOREAL_FOREST] = TileType::GRASS;
+    biomeGround[Biome::TEMPERATE_FOREST] = TileType::GRASS; // Still grass for temperate
+    biomeGround[Biome::JUNGLE] = TileType::JUNGLE_GRASS;     // <--- NEW: Use Jungle Grass
+    biomeGround[Biome::DESERT] = TileType::SAND;
+
+    std::map<Biome, std::vector<TileType>> biomeTrees;
+    biomeTrees[Biome::TUNDRA] = { TileType::SPRUCE, TileType::PINE };
+    biomeTrees[Biome::BOREAL_FOREST] = { TileType::SPRUCE, TileType::PINE, TileType::BIRCH };
+    biomeTrees[Biome::TEMPERATE_FOREST] = { TileType::OAK, TileType::MAPLE, TileType::PINE, TileType::CYPRESS };
+    biomeTrees[Biome::JUNGLE] = { TileType::TEAK, TileType::CECROPIA, TileType::COCOA, TileType::PALM };
+    biomeTrees[Biome::DESERT] = { TileType::SAGUARO, TileType::ACACIA, TileType::PRICKLYPEAR, TileType::CHOLLA };
+
+    // --- STEP 2: Initial Strata and Rock Generation ---
+    for (int z = 0; z < TILE_WORLD_DEPTH; ++z) {
+        RandomStream levelRng = deriveRandomStream(mapSeed, RandomStreamId::LEVEL_STRATA, static_cast<uint64_t>(z));
+        for (int y = 0; y < WORLD_HEIGHT; ++y) {
+            for (int x = 0; x < WORLD_WIDTH; ++x) {
+                TileType base_rock_type;
+                StratumInfo sInfo = getStratumInfoForZ(z);
+                if (sInfo.type == Stratum::BIOSPHERE) {
+                    base_rock_type = (randomInt(levelRng) % 5 == 0) ? TileType::DIRT_FLOOR : biomeGround[biome];
+                }
+                else if (sInfo.type == Stratum::HYDROSPHERE) {
+                    base_rock_type = TileType::DIRT_FLOOR;
+                }
+                else if (sInfo.type >= Stratum::ATMOSPHERE) {
+                    base_rock_type = TileType::EMPTY;
+                }
+                else {
+                    if (!stratumStones[sInfo.type].empty()) {
+                        base_rock_type = stratumStones[sInfo.type][randomInt(levelRng) % stratumStones[sInfo.type].size()];
+                    }
+                    else {
+                        base_rock_type = TileType::EMPTY;
+                    }
+                }
+                Z_LEVELS[z][y][x].underlying_type = base_rock_type;
+                Z_LEVELS[z][y][x].type = base_rock_type;
+            }
+        }
+    }
+
+    // --- STEP 3: Generate Caves and fill deep underground with Stone Floors ---
+    for (int z = 0; z < BIOSPHERE_Z_LEVEL; ++z) {
+        if (z == HYDROSPHERE_Z_LEVEL) continue;
+        StratumInfo sInfo = getStratumInfoForZ(z);
+        if (sInfo.type == Stratum::OUTER_CORE || sInfo.type == Stratum::INNER_CORE) continue;
+        RandomStream levelRng = deriveRandomStream(mapSeed, RandomStreamId::LEVEL_CAVES, static_cast<uint64_t>(z));
+
+        std::vector<std::vector<int>> noiseMap(WORLD_HEIGHT, std::vector<int>(WORLD_WIDTH));
+        for (int y = 0; y < WORLD_HEIGHT; ++y) for (int x = 0; x < WORLD_WIDTH; ++x) noiseMap[y][x] = (randomInt(levelRng) % 100 < 45) ? 1 : 0;
+
+        for (int i = 0; i < 4; ++i) {
+            std::vector<std::vector<int>> newNoiseMap = noiseMap;
+            // --- START OF FIX 1 ---
+            for (int y = 0; y < WORLD_HEIGHT; ++y) {
+                for (int x = 0; x < WORLD_WIDTH; ++x) {
+                    int wallCount = 0;
+                    for (int ny = -1; ny <= 1; ++ny) {
+                        for (int nx = -1; nx <= 1; ++nx) {
+                            int checkX = x + nx;
+                            int checkY = y + ny;
+                            if (checkX >= 0 && checkX < WORLD_WIDTH && checkY >= 0 && checkY < WORLD_HEIGHT) {
+                                if (noiseMap[checkY][checkX] == 1) wallCount++;
+                            }
+                            else {
+                                wallCount++; // Count borders as walls to keep map edges solid
+                            }
+                        }
+                    }
+                    if (noiseMap[y][x] == 1) {
+                        newNoiseMap[y][x] = (wallCount >= 5) ? 1 : 0; // A wall needs 4+ neighbors to survive (5 including itself)
+                    }
+                    else {
+                        newNoiseMap[y][x] = (wallCount >= 5) ? 1 : 0; // An empty space needs 5 neighbors to become a wall
+                    }
+                }
+            }
+            // --- END OF FIX 1 ---
+            noiseMap = newNoiseMap;
+        }
+
+        for (int y = 0; y < WORLD_HEIGHT; ++y) for (int x = 0; x < WORLD_WIDTH; ++x) {
+            if (noiseMap[y][x] == 0) {
+                if (z < HYDROSPHERE_Z_LEVEL) {
+                    Z_LEVELS[z][y][x].type = TileType::STONE_FLOOR;
+                }
+                else {
+                    Z_LEVELS[z][y][x].type = TileType::EMPTY;
+                }
+            }
+        }
+    }
+
+    // --- STEP 4: Generate Surface Water ---
+    bool isForestBiome = (biome == Biome::BOREAL_FOREST || biome == Biome::TEMPERATE_FOREST || biome == Biome::JUNGLE);
+    if (isForestBiome) {
+        std::vector<std::vector<int>> waterMap(WORLD_HEIGHT, std::vector<int>(WORLD_WIDTH, 0));
+        for (int y = 0; y < WORLD_HEIGHT; ++y) for (int x = 0; x < WORLD_WIDTH; ++x) waterMap[y][x] = (randomInt(surfaceRng) % 100 < 35) ? 1 : 0;
+
+        for (int i = 0; i < 5; ++i) {
+            auto newWaterMap = waterMap;
+            // --- START OF FIX 2 ---
+            for (int y = 0; y < WORLD_HEIGHT; ++y) {
+                for (int x = 0; x < WORLD_WIDTH; ++x) {
+                    int waterNeighbors = 0;
+                    for (int ny = -1; ny <= 1; ++ny) {
+                        for (int nx = -1; nx <= 1; ++nx) {
+                            int checkX = x + nx;
+                            int checkY = y + ny;
+                            if (checkX >= 0 && checkX < WORLD_WIDTH && checkY >= 0 && checkY < WORLD_HEIGHT) {
+                                if (waterMap[checkY][checkX] == 1) waterNeighbors++;
+                            }
+                            else {
+                                waterNeighbors++; // Count borders as water to prevent lakes touching the edge
+                            }
+                        }
+                    }
+                    if (waterNeighbors >= 5) newWaterMap[y][x] = 1; else newWaterMap[y][x] = 0;
+                }
+            }
+            // --- END OF FIX 2 ---
+            waterMap = newWaterMap;
+        }
+
+        for (int y = 0; y < WORLD_HEIGHT; ++y) for (int x = 0; x < WORLD_WIDTH; ++x) {
+            if (waterMap[y][x] == 1) Z_LEVELS[BIOSPHERE_Z_LEVEL][y][x].type = TileType::WATER;
+        }
+
+        int numRivers = 2 + randomInt(surfaceRng) % 3;
+        for (int i = 0; i < numRivers; ++i) {
+            int currentX = randomInt(surfaceRng) % WORLD_WIDTH;
+            int currentY = 0;
+            while (currentY < WORLD_HEIGHT) {
+                for (int wy = -1; wy <= 1; ++wy) for (int wx = -1; wx <= 1; ++wx) {
+                    int carveX = currentX + wx, carveY = currentY + wy;
+                    if (carveX >= 0 && carveX < WORLD_WIDTH && carveY >= 0 && carveY < WORLD_HEIGHT) {
+                        if (Z_LEVELS[BIOSPHERE_Z_LEVEL][carveY][carveX].type != TileType::WATER) {
+                            Z_LEVELS[BIOSPHERE_Z_LEVEL][carveY][carveX].type = TileType::WATER;
+                        }
+                    }
+                }
+                currentY += 1;
+                currentX += (randomInt(surfaceRng) % 3) - 1;
+                currentX = std::max(0, std::min(WORLD_WIDTH - 1, currentX));
+            }
+        }
+    }
+
+    // --- STEP 5: Mirror Surface Water onto the Hydrosphere Level ---
+    for (int y = 0; y < WORLD_HEIGHT; ++y) {
+        for (int x = 0; x < WORLD_WIDTH; ++x) {
+            if (Z_LEVELS[BIOSPHERE_Z_LEVEL][y][x].type == TileType::WATER) {
+                Z_LEVELS[HYDROSPHERE_Z_LEVEL][y][x].type = TileType::WATER;
+            }
+        }
+    }
+
+    // --- STEP 6: Ore Generation ---
+    std::set<TileType> sedimentaryStones_s = { TileType::CHALK, TileType::CHERT, TileType::CLAYSTONE, TileType::CONGLOMERATE, TileType::DOLOMITE, TileType::LIMESTONE, TileType::MUDSTONE, TileType::ROCK_SALT, TileType::SANDSTONE, TileType::SHALE, TileType::SILTSTONE };
+    std::set<TileType> igneousExtrusiveStones_s = { TileType::ANDESITE, TileType::BASALT, TileType::DACITE, TileType::OBSIDIAN, TileType::RHYOLITE };
+    std::set<TileType> igneousIntrusiveStones_s = { TileType::DIORITE, TileType::GABBRO, TileType::GRANITE };
+    std::set<TileType> metamorphicStones_s = { TileType::GNEISS, TileType::MARBLE, TileType::PHYLLITE, TileType::QUARTZITE, TileType::SCHIST, TileType::SLATE };
+    std::set<TileType> allIgneousStones_s;
+    allIgneousStones_s.insert(igneousExtrusiveStones_s.begin(), igneousExtrusiveStones_s.end());
+    allIgneousStones_s.insert(igneousIntrusiveStones_s.begin(), igneousIntrusiveStones_s.end());
+    std::set<TileType> allStones_s;
+    allStones_s.insert(sedimentaryStones_s.begin(), sedimentaryStones_s.end());
+    allStones_s.insert(allIgneousStones_s.begin(), allIgneousStones_s.end());
+    allStones_s.insert(metamorphicStones_s.begin(), metamorphicStones_s.end());
+
+    for (int z = 0; z < BIOSPHERE_Z_LEVEL; ++z) {
+        StratumInfo sInfo = getStratumInfoForZ(z);
+        if (sInfo.type != Stratum::OUTER_CORE && sInfo.type != Stratum::INNER_CORE && sInfo.type != Stratum::HYDROSPHERE) {
+            generateOresInStratum(z, sInfo, sedimentaryStones_s, igneousExtrusiveStones_s, igneousIntrusiveStones_s, metamorphicStones_s, allIgneousStones_s, allStones_s, mapSeed);
+        }
+    }
+
+    // --- STEP 7: Tree Generation (must be last) ---
+    if (biomeTrees.count(biome)) {
+        std::vector<TileType> possibleTrees = biomeTrees.at(biome);
+        if (!possibleTrees.empty()) {
+            for (int y = 0; y < WORLD_HEIGHT; ++y) for (int x = 0; x < WORLD_WIDTH; ++x) {
+                const auto& cell = Z_LEVELS[BIOSPHERE_Z_LEVEL][y][x];
+                const auto& tile_tags = TILE_DATA.at(cell.type).tags;
+                // Check for SOIL tag and ensure it's not water or already occupied by a tree
+                if (std::find(tile_tags.begin(), tile_tags.end(), TileTag::SOIL) != tile_tags.end() && cell.type != TileType::WATER && cell.tree == nullptr) {
+                    // Increased chance for trees to appear
+                    if (randomInt(surfaceRng) % 100 < 15) { // <--- MODIFIED: Increased from 5 to 15 for more trees
+                        spawnTree(x, y, possibleTrees[randomInt(surfaceRng) % possibleTrees.size()], surfaceRng);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void updateUnlockedContent(const ResearchProject& project) {
+    // This map translates the unlock string to the actual TileType enum
+    // In updateUnlockedContent(), modify the static const std::map<std::wstring, TileType> unlockMap:
+    // In updateUnlockedContent(), modify the static const std::map<std::wstring, TileType> unlockMap:
+    static const std::map<std::wstring, TileType> unlockMap = {
+        {L"Wall", TileType::WALL},
+        {L"Carpentry Workbench", TileType::CARPENTRY_WORKBENCH},
+        {L"Chair", TileType::CHAIR},
+        {L"Table", TileType::TABLE},
+        {L"Torch", TileType::TORCH},
+        {L"Stonecutting Table", TileType::STONECUTTING_TABLE},
+        {L"Smithy", TileType::SMITHY},
+        {L"Blast Furnace", TileType::BLAST_FURNACE},
+        {L"Advanced Research Bench", TileType::ADVANCED_RESEARCH_BENCH},
+        {L"Stone Wall", TileType::STONE_WALL},
+        {L"Growing Zone", TileType::GROWING_ZONE},
+        {L"Mine Shaft", TileType::MINE_SHAFT},
+        {L"Pickaxe", TileType::PICKAXE},
+        {L"Raft", TileType::RAFT},
+        {L"Spike Trap", TileType::SPIKE_TRAP},
+        {L"Wheel", TileType::WHEEL},
+        {L"Windmill", TileType::WINDMILL},
+        {L"Coining Mill", TileType::COINING_MILL},
+        {L"Coin", TileType::COIN},
+        {L"Theatre Stage", TileType::THEATRE_STAGE},
+        {L"Lens", TileType::LENS},
+        {L"Glasses", TileType::GLASSES},
+        {L"Blackboard", TileType::BLACKBOARD_FURNITURE},
+        {L"School Chair", TileType::SCHOOL_CHAIR_FURNITURE},
+        {L"School Desk", TileType::SCHOOL_DESK_FURNITURE},
+        {L"Acoustic Wall", TileType::ACOUSTIC_WALL_ITEM},
+        {L"Column", TileType::COLUMN},
+        {L"Telescope", TileType::TELESCOPE_FURNITURE},
+        {L"Drug Lab", TileType::DRUG_LAB},
+        {L"Various Drugs", TileType::DRUGS_ITEM},
+        {L"Chemical Equipment", TileType::CHEMICALS_ITEM},
+        {L"Boat", TileType::BOAT_ITEM},
+        {L"Lighthouse", TileType::LIGHTHOUSE_BUILDING},
+        {L"Gunpowder", TileType::GUNPOWDER_ITEM},
+        {L"Printing Press", TileType::PRINTING_PRESS_FURNITURE},
+        {L"Typewriter", TileType::TYPEWRITER},
+        {L"Hospital Bed", TileType::HOSPITAL_BED},
+        {L"Hydroponics Basin", TileType::HYDROPONICS_BASIN},
+        {L"Wire", TileType::WIRE},
+        {L"Lightbulb", TileType::LIGHTBULB},
+        {L"Electric Lamp", TileType::ELECTRIC_LAMP},
+        {L"Assembly Line", TileType::ASSEMBLY_LINE},
+        {L"Radio", TileType::RADIO_FURNITURE},
+        {L"Computer", TileType::COMPUTER_FURNITURE},
+        {L"Mouse", TileType::MOUSE},
+        {L"Screen", TileType::SCREEN},
+        {L"Keyboard", TileType::KEYBOARD},
+        {L"Wind Turbine", TileType::WIND_TURBINE},
+        {L"Server", TileType::SERVER},
+        {L"Switch", TileType::SWITCH},
+        {L"Router", TileType::ROUTER},
+        {L"Smartphone", TileType::SMARTPHONE},
+        {L"Tablet", TileType::TABLET},
+        {L"Smartwatch", TileType::SMARTWATCH},
+        {L"Recipe: Bow", TileType::BOW},
+        {L"Recipe: Arrow", TileType::ARROW},
+        {L"Recipe: Knight Armor", TileType::KNIGHT_ARMOR},
+        {L"Recipe: Knight Weapons", TileType::KNIGHT_WEAPON}
+    };
+
+    for (const auto& unlockStr : project.unlocks) {
+        if (unlockStr.rfind(L"Building: ", 0) == 0) { // Check if it starts with "Building: "
+            std::wstring buildingName = unlockStr.substr(10); // Get the name after "Building: "
+            if (unlockMap.count(buildingName)) {
+                g_unlockedBuildings.insert(unlockMap.at(buildingName));
+                g_unlockedContentVersion++;
+            }
+        }
+        // You can add more checks here for "Recipe: ", "Work: ", etc. in the future
+    }
+}
+
+// NEW: Ore Generation Function
+// Updated generateOresInStratum Function Definition
+void generateOresInStratum(int z, const StratumInfo& sInfo,
+    const std::set<TileType>& sedimentaryStones,
+    const std::set<TileType>& igneousExtrusiveStones,
+    const std::set<TileType>& igneousIntrusiveStones,
+    const std::set<TileType>& metamorphicStones,
+    const std::set<TileType>& allIgneousStones,
+    const std::set<TileType>& allStones,
+    uint64_t mapSeed) {
+    RandomStream rng = deriveRandomStream(mapSeed, RandomStreamId::LEVEL_ORES, static_cast<uint64_t>(z));
+
+    // Lambda to check if a TileType is in a given set of host stones (O(logN) complexity)
+    auto is_stone_type = [&](TileType type, const std::set<TileType>& group) {
+        return group.count(type) > 0;
+        };
+
+    // Helper for spreading veins/clusters (remains largely the same, but uses std::set for host stones)
+    auto spread_ore = [&](int startX, int startY, int startZ, TileType oreType, const std::set<TileType>& allowedHostStones, int density, int max_spread, bool linear = false) {
+        if (startX < 0 || startX >= WORLD_WIDTH || startY < 0 || startY >= WORLD_HEIGHT || startZ < 0 || startZ >= TILE_WORLD_DEPTH) return;
+
+        // Use a 2D array for visited flags for speed and direct indexing
+        std::vector<std::vector<bool>> visited_map(WORLD_HEIGHT, std::vector<bool>(WORLD_WIDTH, false));
+        std::queue<Point2D> q;
+
+        q.push({ startX, startY });
+        visited_map[startY][startX] = true;
+
+        int tiles_placed = 0;
+        int dx_linear = (randomInt(rng) % 3) - 1;
+        int dy_linear = (randomInt(rng) % 3) - 1;
+        if (dx_linear == 0 && dy_linear == 0) dx_linear = 1;
+
+        while (!q.empty() && tiles_placed < max_spread) {
+            Point2D current = q.front();
+            q.pop();
+
+            if (current.x < 0 || current.x >= WORLD_WIDTH || current.y < 0 || current.y >= WORLD_HEIGHT) continue;
+
+            MapCell& current_cell = Z_LEVELS[startZ][current.y][current.x];
+            // Check underlying_type against allowed host stones using the optimized is_stone_type
+            bool isHostType = is_stone_type(current_cell.underlying_type, allowedHostStones);
+
+            // Only place ore if it's a suitable host stone, not already an ore, and not an empty cave
+            if (isHostType &&
+                std::find(TILE_DATA.at(current_cell.type).tags.begin(), TILE_DATA.at(current_cell.type).tags.end(), TileTag::ORE) == TILE_DATA.at(current_cell.type).tags.end() &&
+                current_cell.type != TileType::EMPTY)
+            {
+                current_cell.type = oreType;
+                tiles_placed++;
+            }
+
+            if (linear) {
+                int nx = current.x + dx_linear, ny = current.y + dy_linear;
+                if (nx >= 0 && nx < WORLD_WIDTH && ny >= 0 && ny < WORLD_HEIGHT && !visited_map[ny][nx]) {
+                    visited_map[ny][nx] = true;
+                    q.push({ nx, ny });
+                }
+            }
+            else { // Cluster spreading
+                for (int cy = -1; cy <= 1; ++cy) {
+                    for (int cx = -1; cx <= 1; ++cx) {
+                        if (cx == 0 && cy == 0) continue;
+                        if (randomInt(rng) % 100 < density) { // Density based spread
+                            int nx = current.x + cx, ny = current.y + cy;
+                            if (nx >= 0 && nx < WORLD_WIDTH && ny >= 0 && ny < WORLD_HEIGHT && !visited_map[ny][nx]) {
+                                visited_map[ny][nx] = true;
+                                q.push({ nx, ny });
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        }; // End of spread_ore lambda
+
+
+    // Define specific ores and their host stone types (these are now std::set<TileType>)
+    // Removed ore types from host lists where they appeared as their own hosts.
+
+    TileType oreIron = TileType::HEMATITE_ORE;
+    std::set<TileType> iron_host_types = allStones; // Iron can appear in all stones for simplicity
+
+    TileType oreCopper = TileType::NATIVE_COPPER_ORE;
+    std::set<TileType> copper_host_types = { TileType::BASALT, TileType::ANDESITE, TileType::GABBRO, TileType::SCHIST };
+
+    TileType oreTin = TileType::CASSITERITE_ORE;
+    std::set<TileType> tin_host_types = { TileType::GRANITE, TileType::QUARTZITE, TileType::DIORITE };
+
+    TileType oreZinc = TileType::SPHALERITE_ORE;
+    std::set<TileType> zinc_host_types = { TileType::LIMESTONE, TileType::DOLOMITE, TileType::CHERT };
+
+    TileType oreLead = TileType::GALENA_ORE;
+    std::set<TileType> lead_host_types = { TileType::LIMESTONE, TileType::DOLOMITE, TileType::SHALE };
+
+    TileType oreSilver = TileType::NATIVE_SILVER_ORE;
+    std::set<TileType> silver_host_types = { TileType::QUARTZITE, TileType::SLATE };
+
+    TileType oreGold = TileType::NATIVE_GOLD_ORE;
+    std::set<TileType> gold_host_types = { TileType::QUARTZITE, TileType::GRANITE, TileType::SCHIST };
+
+    TileType oreTungsten = TileType::WOLFRAMITE_ORE;
+    std::set<TileType> tungsten_host_types = { TileType::GNEISS, TileType::MARBLE, TileType::GRANITE };
+
+    TileType orePlatinum = TileType::NATIVE_PLATINUM_ORE;
+    std::set<TileType> platinum_host_types = { TileType::GABBRO, TileType::BASALT };
+
+    TileType oreAluminum = TileType::NATIVE_ALUMINUM_ORE;
+    std::set<TileType> aluminum_host_types = { TileType::CLAYSTONE, TileType::MUDSTONE, TileType::SHALE };
+
+    TileType oreBismuth = TileType::BISMUTHINITE_ORE;
+    std::set<TileType> bismuth_host_types = { TileType::GRANITE, TileType::QUARTZITE };
+
+    TileType oreOsmium = TileType::OSMIUM_METAL;
+    std::set<TileType> osmium_host_types = { TileType::GABBRO, TileType::GNEISS };
+
+    TileType oreIridium = TileType::IRIDIUM_METAL;
+    std::set<TileType> iridium_host_types = { TileType::GABBRO, TileType::BASALT };
+
+    TileType oreCobalt = TileType::COBALTITE_ORE;
+    std::set<TileType> cobalt_host_types = { TileType::SCHIST, TileType::GNEISS };
+
+    TileType orePalladium = TileType::PALLADINITE_ORE;
+    std::set<TileType> palladium_host_types = { TileType::BASALT, TileType::GABBRO };
+
+    TileType oreMithril = TileType::MITHRITE_ORE;
+    std::set<TileType> mithril_host_types = { TileType::MARBLE, TileType::QUARTZITE, TileType::GNEISS };
+
+    TileType oreOrichalcum = TileType::ORICALCITE_ORE;
+    std::set<TileType> orichalcum_host_types = { TileType::DIORITE, TileType::GRANITE, TileType::GABBRO };
+
+    TileType oreAdamantium = TileType::ADAMANTITE_ORE;
+    std::set<TileType> adamantite_host_types = { TileType::CORESTONE };
+
+    TileType oreTitanium = TileType::RUTILE_ORE;
+    std::set<TileType> titanium_host_types = { TileType::SCHIST, TileType::GNEISS };
+
+
+    // New Generation Logic: Generate a fixed number of ore veins (this part is efficient now)
+    if (sInfo.type == Stratum::CRUST || sInfo.type == Stratum::LITHOSPHERE) { // Superficial ores
+        int numVeins = 5 + randomInt(rng) % 5; // Generate 5 to 9 veins of each common ore per layer
+        for (int i = 0; i < numVeins; ++i) {
+            int startX = randomInt(rng) % WORLD_WIDTH;
+            int startY = randomInt(rng) % WORLD_HEIGHT;
+
+            // Check if underlying tile is a valid host stone and not an empty cave
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, iron_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreIron, iron_host_types, 60, 20, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, copper_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreCopper, copper_host_types, 55, 18, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, tin_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreTin, tin_host_types, 50, 15, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, zinc_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreZinc, zinc_host_types, 45, 15, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, lead_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreLead, lead_host_types, 40, 12, false);
+        }
+    }
+    else if (sInfo.type == Stratum::ASTHENOSPHERE) { // Deeper ores
+        int numVeins = 3 + randomInt(rng) % 4; // Generate 3 to 6 veins of each deeper ore
+        for (int i = 0; i < numVeins; ++i) {
+            int startX = randomInt(rng) % WORLD_WIDTH;
+            int startY = randomInt(rng) % WORLD_HEIGHT;
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, gold_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreGold, gold_host_types, 70, 25, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, silver_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreSilver, silver_host_types, 65, 22, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, tungsten_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreTungsten, tungsten_host_types, 80, 30, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, platinum_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, orePlatinum, platinum_host_types, 75, 28, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, aluminum_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreAluminum, aluminum_host_types, 60, 20, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, bismuth_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreBismuth, bismuth_host_types, 60, 20, false);
+        }
+    }
+    else if (sInfo.type == Stratum::UPPER_MANTLE || sInfo.type == Stratum::LOWER_MANTLE) {
+        int numVeins = 2 + randomInt(rng) % 3; // Generate 2 to 4 veins
+        for (int i = 0; i < numVeins; ++i) {
+            int startX = randomInt(rng) % WORLD_WIDTH;
+            int startY = randomInt(rng) % WORLD_HEIGHT;
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, cobalt_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreCobalt, cobalt_host_types, 85, 35, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, palladium_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, orePalladium, palladium_host_types, 80, 30, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, titanium_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreTitanium, titanium_host_types, 90, 40, false);
+        }
+    }
+    else if (sInfo.type == Stratum::INNER_CORE) { // Fictional super rare ores
+        int numVeins = 1 + randomInt(rng) % 2; // Generate 1 to 2 veins
+        for (int i = 0; i < numVeins; ++i) {
+            int startX = randomInt(rng) % WORLD_WIDTH;
+            int startY = randomInt(rng) % WORLD_HEIGHT;
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, adamantite_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreAdamantium, adamantite_host_types, 95, 50, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, mithril_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreMithril, mithril_host_types, 90, 45, false);
+
+            if (is_stone_type(Z_LEVELS[z][startY][startX].underlying_type, orichalcum_host_types) && Z_LEVELS[z][startY][startX].type != TileType::EMPTY)
+                spread_ore(startX, startY, z, oreOrichalcum, orichalcum_host_types, 90, 45, false);
+        }
+    }
+}
+
+
+void FindAllContinents(std::vector<std::vector<Biome>>& pmap, std::vector<std::vector<Point2D>>& outContinents) {
+    std::vector<std::vector<bool>> visited(PLANET_MAP_HEIGHT, std::vector<bool>(PLANET_MAP_WIDTH, false));
+
+    for (int y = 0; y < PLANET_MAP_HEIGHT; ++y) {
+        for (int x = 0; x < PLANET_MAP_WIDTH; ++x) {
+            if (pmap[y][x] != Biome::OCEAN && !visited[y][x]) {
+                std::vector<Point2D> currentContinent;
+                std::queue<Point2D> q;
+                q.push({ x, y });
+                visited[y][x] = true;
+                while (!q.empty()) {
+                    Point2D p = q.front(); q.pop();
+                    currentContinent.push_back(p);
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            if (dx == 0 && dy == 0) continue;
+                            int nx = p.x + dx, ny = p.y + dy;
+                            if (nx >= 0 && nx < PLANET_MAP_WIDTH && ny >= 0 && ny < PLANET_MAP_HEIGHT && !visited[ny][nx] && pmap[ny][nx] != Biome::OCEAN) {
+                                visited[ny][nx] = true;
+                                q.push({ nx, ny });
+                            }
+                        }
+                    }
+                }
+                outContinents.push_back(currentContinent);
+            }
+        }
+    }
+}
+void generatePlanetMap(Planet& planet) {
+    RandomStream rng = deriveRandomStream(g_worldSeed, RandomStreamId::PLANET_MAP, static_cast<uint64_t>(planet.type));
+    planet.biomeMap.assign(PLANET_MAP_HEIGHT, std::vector<Biome>(PLANET_MAP_WIDTH, Biome::OCEAN));
+    std::vector<std::vector<Biome>>& pmap = planet.biomeMap;
+
+    if (planet.type == WorldType::SINGLE_CONTINENT) {
+        float centerX = PLANET_MAP_WIDTH / 2.0f;
+        float centerY = PLANET_MAP_HEIGHT / 2.0f;
+        float radius = (PLANET_MAP_HEIGHT / 2.0f) * 0.9f;
+        float beachWidth = 5.0f;
+
+        for (int y = 0; y < PLANET_MAP_HEIGHT; ++y) {
+            for (int x = 0; x < PLANET_MAP_WIDTH; ++x) {
+                float dx = x - centerX, dy = y - centerY;
+                float dist = sqrt(dx * dx + dy * dy);
+                if (dist < radius) { // It's land
+                    if (dist > radius - beachWidth) { // It's a beach
+                        pmap[y][x] = Biome::DESERT; // Uses sand tiles
+                    }
+                    else { // It's inland
+                        float latitude_percent = (float)y / PLANET_MAP_HEIGHT;
+                        if (latitude_percent < 0.15 || latitude_percent > 0.85) pmap[y][x] = Biome::TUNDRA;
+                        else if (latitude_percent < 0.3 || latitude_percent > 0.7) pmap[y][x] = Biome::BOREAL_FOREST;
+                        else if (latitude_percent < 0.4 || latitude_percent > 0.6) pmap[y][x] = Biome::TEMPERATE_FOREST;
+                        else pmap[y][x] = (randomInt(rng) % 3 == 0) ? Biome::DESERT : Biome::JUNGLE;
+                    }
+                }
+            }
+        }
+    }
+    else { // Handle Earth-Like and Archipelago with a more advanced method
+
+        // Step 1: Cellular Automata to create natural landmasses
+        std::vector<std::vector<int>> noiseMap(PLANET_MAP_HEIGHT, std::vector<int>(PLANET_MAP_WIDTH));
+        for (int y = 0; y < PLANET_MAP_HEIGHT; ++y) for (int x = 0; x < PLANET_MAP_WIDTH; ++x) noiseMap[y][x] = (randomInt(rng) % 100 < 45) ? 1 : 0;
+
+        for (int i = 0; i < 4; ++i) { // 4 smoothing iterations
+            std::vector<std::vector<int>> newNoiseMap = noiseMap;
+            for (int y = 0; y < PLANET_MAP_HEIGHT; ++y) for (int x = 0; x < PLANET_MAP_WIDTH; ++x) {
+                int wallCount = 0;
+                for (int ny = -1; ny <= 1; ++ny) for (int nx = -1; nx <= 1; ++nx) {
+                    if (ny == 0 && nx == 0) continue;
+                    int checkX = x + nx, checkY = y + ny;
+                    if (checkX >= 0 && checkX < PLANET_MAP_WIDTH && checkY >= 0 && checkY < PLANET_MAP_HEIGHT) {
+                        if (noiseMap[checkY][checkX] == 1) wallCount++;
+                    }
+                    else { wallCount++; } // Count borders as walls
+                }
+                if (noiseMap[y][x] == 1) newNoiseMap[y][x] = (wallCount >= 4) ? 1 : 0;
+                else newNoiseMap[y][x] = (wallCount >= 5) ? 1 : 0;
+            }
+            noiseMap = newNoiseMap;
+        }
+
+        // Step 2: Set preliminary biome map from noise
+        for (int y = 0; y < PLANET_MAP_HEIGHT; ++y) for (int x = 0; x < PLANET_MAP_WIDTH; ++x) {
+            if (noiseMap[y][x] == 1) {
+                float latitude_percent = (float)y / PLANET_MAP_HEIGHT;
+                if (latitude_percent < 0.1 || latitude_percent > 0.9) pmap[y][x] = Biome::TUNDRA;
+                else if (latitude_percent < 0.2 || latitude_percent > 0.8) pmap[y][x] = Biome::BOREAL_FOREST;
+                else if (latitude_percent < 0.4 || latitude_percent > 0.6) pmap[y][x] = Biome::TEMPERATE_FOREST;
+                else { pmap[y][x] = (randomInt(rng) % 2 == 0) ? Biome::DESERT : Biome::JUNGLE; }
+            }
+            else { pmap[y][x] = Biome::OCEAN; }
+        }
+
+        // Step 3: Prune smaller continents for "Earth-like" worlds
+        if (planet.type == WorldType::EARTH_LIKE) {
+            std::vector<std::vector<Point2D>> allContinents;
+            FindAllContinents(pmap, allContinents);
+
+            std::sort(allContinents.begin(), allContinents.end(), [](const auto& a, const auto& b) { return a.size() > b.size(); });
+
+            int continentsToKeep = 5; // A good number for "Earth-like"
+            for (size_t i = continentsToKeep; i < allContinents.size(); ++i) {
+                for (const auto& p : allContinents[i]) { pmap[p.y][p.x] = Biome::OCEAN; }
+            }
+        }
+    }
+}
+void generateSolarSystem(int numPlanets, bool preserveNames) {
+    RandomStream rng = deriveRandomStream(g_worldSeed, RandomStreamId::SOLAR_SYSTEM);
+    std::vector<std::wstring> oldNames;
+    if (preserveNames && !solarSystem.empty()) { for (const auto& p : solarSystem) oldNames.push_back(p.name); }
+    solarSystem.clear();
+    for (int i = 0; i < numPlanets; ++i) {
+        Planet p;
+        if (preserveNames && i < oldNames.size()) p.name = oldNames[i];
+        else p.name = L"Planet " + std::to_wstring(i + 1);
+        p.type = static_cast<WorldType>(randomInt(rng) % 3);
+        p.orbitalRadius = 50.0 + i * 40.0 + (randomInt(rng) % 20); p.currentAngle = (randomInt(rng) % 360) * 3.14159 / 180.0;
+        p.orbitalSpeed = 0.001 + (randomInt(rng) % 5) * 0.0005 / (i + 1); p.color = makeColor(randomInt(rng) % 200 + 55, randomInt(rng) % 200 + 55, randomInt(rng) % 200 + 55);
+        p.size = 5 + randomInt(rng) % 6; solarSystem.push_back(p);
+    }
+    homeMoon.orbitalRadius = 15.0; homeMoon.currentAngle = (randomInt(rng) % 360) * 3.14159 / 180.0;
+    homeMoon.orbitalSpeed = 0.01; homeMoon.color = makeColor(200, 200, 200); homeMoon.size = 2;
+}
+void generateDistantStars() {
+    RandomStream rng = deriveRandomStream(g_worldSeed, RandomStreamId::DISTANT_STARS);
+    distantStars.clear();
+    g_homeSystemStarIndex = -1;
+
+    // First, create the player's home system star
+    Star homeStar;
+    homeStar.x = 0.5f; // Start it in the horizontal center
+    homeStar.y = 0.5f; // Start it in the vertical center
+    homeStar.dx = -((randomInt(rng) % 50) / 10000.0f) - 0.0001f; // Give it a standard speed
+    homeStar.size = 2; // Make it slightly larger so it's noticeable
+    homeStar.color = makeColor(255, 255, 0); // Make it distinctly yellow
+    distantStars.push_back(homeStar);
+    g_homeSystemStarIndex = 0; // It's the first star in the vector
+
+    // Now, generate the rest of the random stars
+    for (int i = 0; i < 399; ++i) { // One less because we already made the home star
+        Star s;
+        s.x = static_cast<float>(randomNext(rng) / 4294967295.0);
+        s.y = static_cast<float>(randomNext(rng) / 4294967295.0);
+        s.dx = -((randomInt(rng) % 50) / 10000.0f) - 0.0001f;
+        s.size = 1 + (randomInt(rng) % 100 < 5);
+
+        int colorChance = randomInt(rng) % 100;
+        if (colorChance < 5) {
+            s.color = makeColor(200, 200, 255);
+        }
+        else if (colorChance < 10) {
+            s.color = makeColor(255, 255, 200);
+        }
+        else {
+            s.color = makeColor(220, 220, 220);
+        }
+
+        distantStars.push_back(s);
+    }
+}
+void preparePawnSelection() { rerollablePawns.clear(); for (int i = 0; i < 3; ++i) rerollablePawns.push_back(generatePawn()); }
+// Helper functions for landing site selection
+std::wstring generateContinentName(RandomStream& rng) {
+    const std::vector<std::wstring> prefixes = { L"Aka", L"Bora", L"Cor", L"Dra", L"El", L"Fen", L"Gor", L"Hel", L"Ish", L"Jen", L"Kel", L"Lumar" };
+    const std::vector<std::wstring> middles = { L"ma", L"to", L"lan", L"gar", L"the", L"ni", L"si", L"lo", L"ra", L"goth", L"shen" };
+    const std::vector<std::wstring> suffixes = { L"ia", L"os", L"a", L"dor", L"eth", L" Prime", L" Minor", L" Major", L"a-kar", L"a-sul" };
+    return prefixes[randomInt(rng) % prefixes.size()] + middles[randomInt(rng) % middles.size()] + suffixes[randomInt(rng) % suffixes.size()];
+}
+ContinentInfo findContinentInfo(int startX, int startY) {
+    ContinentInfo info;
+    if (solarSystem.empty() || solarSystem[0].biomeMap[startY][startX] == Biome::OCEAN) {
+        return info; // Return empty info with found=false
+    }
+
+    std::queue<Point2D> q;
+    std::vector<std::vector<bool>> visited(PLANET_MAP_HEIGHT, std::vector<bool>(PLANET_MAP_WIDTH, false));
+
+    q.push({ startX, startY });
+    visited[startY][startX] = true;
+
+    long long sumX = 0;
+    double sumTemp = 0.0;
+    std::map<Biome, int> biomeBaseTemp = { {Biome::TUNDRA, -15}, {Biome::BOREAL_FOREST, 5}, {Biome::TEMPERATE_FOREST, 15}, {Biome::JUNGLE, 25}, {Biome::DESERT, 30} };
+
+
+    while (!q.empty()) {
+        Point2D p = q.front();
+        q.pop();
+
+        info.tiles.push_back(p);
+        Biome currentBiome = solarSystem[0].biomeMap[p.y][p.x];
+        info.biomes.insert(currentBiome);
+        sumX += p.x;
+        sumTemp += biomeBaseTemp.count(currentBiome) ? biomeBaseTemp.at(currentBiome) : 10;
+
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dy == 0) continue;
+                int nx = p.x + dx, ny = p.y + dy;
+                if (nx >= 0 && nx < PLANET_MAP_WIDTH && ny >= 0 && ny < PLANET_MAP_HEIGHT && !visited[ny][nx]) {
+                    visited[ny][nx] = true;
+                    if (solarSystem[0].biomeMap[ny][nx] != Biome::OCEAN) {
+                        q.push({ nx, ny });
+                    }
+                }
+            }
+        }
+    }
+
+    if (!info.tiles.empty()) {
+        info.found = true;
+        std::sort(info.tiles.begin(), info.tiles.end(), [](const Point2D& a, const Point2D& b) {
+            if (a.y != b.y) return a.y < b.y;
+            return a.x < b.x;
+            });
+        // Names are keyed on the continent's top-left tile so they stay stable while browsing.
+        RandomStream nameRng = deriveRandomStream(g_worldSeed, RandomStreamId::CONTINENT_NAME, static_cast<uint64_t>(info.tiles[0].y) * PLANET_MAP_WIDTH + info.tiles[0].x);
+        info.name = generateContinentName(nameRng);
+
+        info.avgTemp = sumTemp / info.tiles.size();
+        float avgX = static_cast<float>(sumX) / info.tiles.size();
+        info.timezoneOffset = ((avgX / PLANET_MAP_WIDTH) * 24.0f) - 12.0f;
+    }
+
+    return info;
+}
+bool isOceanOrOutOfBounds(int x, int y) {
+    if (x < 0 || x >= PLANET_MAP_WIDTH || y < 0 || y >= PLANET_MAP_HEIGHT) return true;
+    return solarSystem[0].biomeMap[y][x] == Biome::OCEAN;
+}
+// --- Item Spatial Index ---
+int itemIndexChunkKey(int x, int y, int z) {
+    return (z * ITEM_INDEX_CHUNKS_Y + y / ITEM_INDEX_CHUNK_SIZE) * ITEM_INDEX_CHUNKS_X + x / ITEM_INDEX_CHUNK_SIZE;
+}
+
+void addItemToCell(int x, int y, int z, TileType item) {
+    MapCell& cell = Z_LEVELS[z][y][x];
+    markCellDirty(x, y, z);
+    bool firstOfType = std::find(cell.itemsOnGround.begin(), cell.itemsOnGround.end(), item) == cell.itemsOnGround.end();
+    cell.itemsOnGround.push_back(item);
+
+    ItemTypeIndex& index = g_itemIndex[item];
+    if (firstOfType) index.chunks[itemIndexChunkKey(x, y, z)].push_back({ x, y, z });
+    index.countOnMap++;
+    if (cell.stockpileId != -1) {
+        index.countInStockpiles++;
+        g_stockpiledResources[item]++;
+        g_stockpileContentsVersion++;
+    }
+}
+
+// Removes the item at itemIndex from the cell's stack and returns its type.
+TileType removeItemFromCell(int x, int y, int z, size_t itemIndex) {
+    MapCell& cell = Z_LEVELS[z][y][x];
+    if (itemIndex >= cell.itemsOnGround.size()) return TileType::EMPTY;
+    markCellDirty(x, y, z);
+    TileType item = cell.itemsOnGround[itemIndex];
+    cell.itemsOnGround.erase(cell.itemsOnGround.begin() + itemIndex);
+
+    ItemTypeIndex& index = g_itemIndex[item];
+    index.countOnMap--;
+    if (cell.stockpileId != -1) {
+        index.countInStockpiles--;
+        g_stockpiledResources[item]--;
+        g_stockpileContentsVersion++;
+    }
+
+    // Last item of this type left the cell: drop the cell from its chunk bucket.
+    if (std::find(cell.itemsOnGround.begin(), cell.itemsOnGround.end(), item) == cell.itemsOnGround.end()) {
+        auto chunkIt = index.chunks.find(itemIndexChunkKey(x, y, z));
+        if (chunkIt != index.chunks.end()) {
+            std::vector<Point3D>& cells = chunkIt->second;
+            for (size_t i = 0; i < cells.size(); ++i) {
+                if (cells[i].x == x && cells[i].y == y && cells[i].z == z) {
+                    cells[i] = cells.back();
+                    cells.pop_back();
+                    break;
+                }
+            }
+            if (cells.empty()) index.chunks.erase(chunkIt);
+        }
+    }
+    return item;
+}
+
+// Moves the cell's items in or out of the stockpiled totals when it joins or leaves a stockpile.
+void setCellStockpileId(int x, int y, int z, int stockpileId) {
+    MapCell& cell = Z_LEVELS[z][y][x];
+    bool wasStockpile = (cell.stockpileId != -1);
+    bool isStockpile = (stockpileId != -1);
+    cell.stockpileId = stockpileId;
+    markCellDirty(x, y, z);
+    if (wasStockpile == isStockpile) return;
+
+    int delta = isStockpile ? 1 : -1;
+    for (TileType item : cell.itemsOnGround) {
+        g_itemIndex[item].countInStockpiles += delta;
+        g_stockpiledResources[item] += delta;
+    }
+    if (!cell.itemsOnGround.empty()) g_stockpileContentsVersion++;
+}
+
+void clearItemIndex() {
+    g_itemIndex.clear();
+    g_stockpiledResources.clear();
+    g_stockpileContentsVersion++;
+}
+
+// Returns up to maxResults cells holding `type` within `radius` (Chebyshev, XY) and `zRange` levels of origin,
+// nearest first by Manhattan distance. Ties keep the (z, y, x) scan order the old box search used.
+std::vector<Point3D> findNearestItemStacks(TileType type, Point3D origin, int radius, int zRange, int maxResults) {
+    std::vector<std::pair<int, Point3D>> matches;
+    auto typeIt = g_itemIndex.find(type);
+    if (typeIt == g_itemIndex.end() || maxResults <= 0) return {};
+    const ItemTypeIndex& index = typeIt->second;
+
+    int minCX = std::max(0, origin.x - radius) / ITEM_INDEX_CHUNK_SIZE, maxCX = std::min(WORLD_WIDTH - 1, origin.x + radius) / ITEM_INDEX_CHUNK_SIZE;
+    int minCY = std::max(0, origin.y - radius) / ITEM_INDEX_CHUNK_SIZE, maxCY = std::min(WORLD_HEIGHT - 1, origin.y + radius) / ITEM_INDEX_CHUNK_SIZE;
+    for (int z = std::max(0, origin.z - zRange); z <= std::min(TILE_WORLD_DEPTH - 1, origin.z + zRange); ++z) {
+        for (int cy = minCY; cy <= maxCY; ++cy) {
+            for (int cx = minCX; cx <= maxCX; ++cx) {
+                auto chunkIt = index.chunks.find((z * ITEM_INDEX_CHUNKS_Y + cy) * ITEM_INDEX_CHUNKS_X + cx);
+                if (chunkIt == index.chunks.end()) continue;
+                for (const Point3D& p : chunkIt->second) {
+                    if (abs(p.x - origin.x) > radius || abs(p.y - origin.y) > radius) continue;
+                    matches.push_back({ abs(p.x - origin.x) + abs(p.y - origin.y) + abs(p.z - origin.z), p });
+                }
+            }
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const std::pair<int, Point3D>& a, const std::pair<int, Point3D>& b) {
+        if (a.first != b.first) return a.first < b.first;
+        if (a.second.z != b.second.z) return a.second.z < b.second.z;
+        if (a.second.y != b.second.y) return a.second.y < b.second.y;
+        return a.second.x < b.second.x;
+        });
+
+    std::vector<Point3D> result;
+    for (size_t i = 0; i < matches.size() && (int)result.size() < maxResults; ++i) result.push_back(matches[i].second);
+    return result;
+}
+
+int getItemCountOnMap(TileType type) {
+    auto it = g_itemIndex.find(type);
+    return (it != g_itemIndex.end()) ? it->second.countOnMap : 0;
+}
+
+int getItemCountInStockpiles(TileType type) {
+    auto it = g_itemIndex.find(type);
+    return (it != g_itemIndex.end()) ? it->second.countInStockpiles : 0;
+}
+
+// --- Stair Graph ---
+void markStairGraphDirty() {
+    g_stairGraphDirty = true;
+}
+
+void rebuildStairGraph() {
+    g_stairLinks.clear();
+    g_stairNodesByLevel.assign(TILE_WORLD_DEPTH, {});
+    for (int z = 0; z + 1 < TILE_WORLD_DEPTH; ++z) {
+        for (int y = 0; y < WORLD_HEIGHT; ++y) {
+            for (int x = 0; x < WORLD_WIDTH; ++x) {
+                if (Z_LEVELS[z][y][x].type == TileType::STAIR_UP && Z_LEVELS[z + 1][y][x].type == TileType::STAIR_DOWN) {
+                    int link = (int)g_stairLinks.size();
+                    g_stairLinks.push_back({ x, y, z });
+                    g_stairNodesByLevel[z].push_back(link * 2);
+                    g_stairNodesByLevel[z + 1].push_back(link * 2 + 1);
+                }
+            }
+        }
+    }
+    g_stairGraphDirty = false;
+}
+
+// Estimated walking cost between two tiles: Chebyshev distance on one level (pawns move in 8 directions),
+// shortest stair-to-stair route otherwise. Walls are ignored, so callers still confirm with isReachable;
+// HAUL_COST_UNREACHABLE means no chain of stairs joins the two levels at all.
+int estimateHaulCost(Point3D from, Point3D to) {
+    if (from.z == to.z) return std::max(abs(from.x - to.x), abs(from.y - to.y));
+    if (g_stairGraphDirty) rebuildStairGraph();
+    if (from.z < 0 || from.z >= (int)g_stairNodesByLevel.size() || to.z < 0 || to.z >= (int)g_stairNodesByLevel.size()) return HAUL_COST_UNREACHABLE;
+
+    auto nodePos = [](int node) {
+        const StairLink& link = g_stairLinks[node / 2];
+        return Point3D{ link.x, link.y, link.zLower + node % 2 };
+    };
+    auto flatDist = [](const Point3D& a, const Point3D& b) { return std::max(abs(a.x - b.x), abs(a.y - b.y)); };
+
+    // Dijkstra over stair endpoints: walk to any endpoint on the same level, or climb to the partner endpoint.
+    std::vector<int> dist(g_stairLinks.size() * 2, HAUL_COST_UNREACHABLE);
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> open;
+    for (int node : g_stairNodesByLevel[from.z]) {
+        dist[node] = flatDist(from, nodePos(node));
+        open.push({ dist[node], node });
+    }
+
+    int best = HAUL_COST_UNREACHABLE;
+    while (!open.empty()) {
+        std::pair<int, int> top = open.top(); open.pop();
+        int cost = top.first, node = top.second;
+        if (cost > dist[node] || cost >= best) continue;
+        Point3D pos = nodePos(node);
+        if (pos.z == to.z) best = std::min(best, cost + flatDist(pos, to));
+
+        int partner = node ^ 1;
+        if (cost + 1 < dist[partner]) {
+            dist[partner] = cost + 1;
+            open.push({ dist[partner], partner });
+        }
+        for (int other : g_stairNodesByLevel[pos.z]) {
+            int otherCost = cost + flatDist(pos, nodePos(other));
+            if (otherCost < dist[other]) {
+                dist[other] = otherCost;
+                open.push({ otherCost, other });
+            }
+        }
+    }
+    return best;
+}
+
+// --- Stockpile Management ---
+int getStockpileSlot(int id) {
+    if (id < 0 || id >= (int)g_stockpileSlotById.size()) return -1;
+    return g_stockpileSlotById[id];
+}
+
+Stockpile* findStockpileById(int id) {
+    int slot = getStockpileSlot(id);
+    return (slot != -1) ? &g_stockpiles[slot] : nullptr;
+}
+
+// Creates a stockpile over the eligible cells of the rectangle and returns its id (-1 if no cell qualified).
+// Cells taken over from an existing stockpile are cut out of it; a stockpile left without cells is removed.
+int createStockpile(int x1, int y1, int x2, int y2, int z) {
+    x1 = std::max(0, x1); y1 = std::max(0, y1); x2 = std::min(WORLD_WIDTH - 1, x2); y2 = std::min(WORLD_HEIGHT - 1, y2);
+    Stockpile sp; sp.id = nextStockpileId++; sp.z = z;
+    sp.rect = { x1, y1, x2, y2 };
+    for (const auto& group : g_haulableItemsGrouped) for (TileType item : group.second) sp.acceptedResources.insert(item);
+
+    std::set<int> shrunkStockpileIDs;
+    for (int y = y1; y <= y2; ++y) {
+        for (int x = x1; x <= x2; ++x) {
+            MapCell& cell = Z_LEVELS[z][y][x];
+            const auto& tags = TILE_DATA.at(cell.type).tags;
+            if (cell.tree != nullptr || std::find(tags.begin(), tags.end(), TileTag::STRUCTURE) != tags.end() || std::find(tags.begin(), tags.end(), TileTag::FURNITURE) != tags.end()) continue;
+            if (cell.stockpileId != -1) shrunkStockpileIDs.insert(cell.stockpileId);
+            setCellStockpileId(x, y, z, sp.id);
+            sp.cells.push_back({ x, y, z });
+        }
+    }
+
+    // Drop the overwritten cells from their previous owners, touching only those owners' cells.
+    for (int shrunkId : shrunkStockpileIDs) {
+        Stockpile* other = findStockpileById(shrunkId);
+        if (!other) continue;
+        other->cells.erase(std::remove_if(other->cells.begin(), other->cells.end(), [shrunkId](const Point3D& c) {
+            return Z_LEVELS[c.z][c.y][c.x].stockpileId != shrunkId;
+            }), other->cells.end());
+        if (other->cells.empty()) {
+            removeStockpile(shrunkId);
+            continue;
+        }
+        CellRect bounds = { WORLD_WIDTH, WORLD_HEIGHT, -1, -1 };
+        for (const Point3D& c : other->cells) {
+            bounds.left = std::min(bounds.left, c.x); bounds.top = std::min(bounds.top, c.y);
+            bounds.right = std::max(bounds.right, c.x); bounds.bottom = std::max(bounds.bottom, c.y);
+        }
+        other->rect = bounds;
+    }
+
+    if (sp.cells.empty()) return -1;
+    if ((int)g_stockpileSlotById.size() <= sp.id) g_stockpileSlotById.resize(sp.id + 1, -1);
+    g_stockpileSlotById[sp.id] = (int)g_stockpiles.size();
+    g_stockpiles.push_back(sp);
+    return sp.id;
+}
+
+void removeStockpile(int id) {
+    int slot = getStockpileSlot(id);
+    if (slot == -1) return;
+    for (const Point3D& c : g_stockpiles[slot].cells) {
+        if (Z_LEVELS[c.z][c.y][c.x].stockpileId == id) setCellStockpileId(c.x, c.y, c.z, -1);
+    }
+    g_stockpiles.erase(g_stockpiles.begin() + slot);
+    g_stockpileSlotById[id] = -1;
+    for (size_t i = slot; i < g_stockpiles.size(); ++i) g_stockpileSlotById[g_stockpiles[i].id] = (int)i;
+    g_unreachableStockpileCache.erase(id);
+    if (g_simHooks.stockpileRemoved) g_simHooks.stockpileRemoved(slot);
+}
+
+// --- Game Logic ---
+float targetLightLevel() {
+    switch (currentTimeOfDay) {
+    case TimeOfDay::DAWN:      return 0.6f;
+    case TimeOfDay::MORNING:   return 0.9f;
+    case TimeOfDay::MIDDAY:    return 1.0f;
+    case TimeOfDay::AFTERNOON: return 0.9f;
+    case TimeOfDay::EVENING:   return 0.7f;
+    case TimeOfDay::DUSK:      return 0.4f;
+    case TimeOfDay::NIGHT:     return isFullMoon ? 0.25f : 0.15f;
+    default:                   return 1.0f;
+    }
+}
+
+// Smoothly interpolates the ambient light one updateTime() towards the time of day's level.
+void stepLightLevel() {
+    if (gameSpeed > 0) {
+        currentLightLevel += (targetLightLevel() - currentLightLevel) * 0.005f * gameSpeed;
+    }
+}
+
+void updateTime() {
+    PROFILE_SCOPE(ProfileCategory::SIM, "updateTime");
+    gameTicks += gameSpeed;
+
+    const int DAYS_PER_MONTH = 28;
+    const int MONTHS_PER_YEAR = 12;
+
+    long long currentTotalDays = gameTicks / TICKS_PER_DAY;
+    gameYear = 1 + (currentTotalDays / (DAYS_PER_MONTH * MONTHS_PER_YEAR));
+    gameMonth = (currentTotalDays / DAYS_PER_MONTH) % MONTHS_PER_YEAR;
+    gameDay = 1 + (currentTotalDays % DAYS_PER_MONTH);
+
+    long long ticksIntoDay = gameTicks % TICKS_PER_DAY;
+    gameHour = (ticksIntoDay * 24) / TICKS_PER_DAY;
+    gameMinute = (ticksIntoDay * 1440 / TICKS_PER_DAY) % 60;
+    gameSecond = (ticksIntoDay * 86400 / TICKS_PER_DAY) % 60;
+
+    // Update Time of Day
+    if (gameHour >= 5 && gameHour < 7) currentTimeOfDay = TimeOfDay::DAWN;
+    else if (gameHour >= 7 && gameHour < 12) currentTimeOfDay = TimeOfDay::MORNING;
+    else if (gameHour >= 12 && gameHour < 16) currentTimeOfDay = TimeOfDay::MIDDAY;
+    else if (gameHour >= 16 && gameHour < 18) currentTimeOfDay = TimeOfDay::AFTERNOON;
+    else if (gameHour >= 18 && gameHour < 20) currentTimeOfDay = TimeOfDay::EVENING;
+    else if (gameHour >= 20 && gameHour < 22) currentTimeOfDay = TimeOfDay::DUSK;
+    else if (gameHour >= 22 || gameHour < 5) currentTimeOfDay = TimeOfDay::NIGHT;
+
+    stepLightLevel();
+
+    if (gameMonth >= 0 && gameMonth <= 2) currentSeason = Season::SPRING;
+    else if (gameMonth >= 3 && gameMonth <= 5) currentSeason = Season::SUMMER;
+    else if (gameMonth >= 6 && gameMonth <= 8) currentSeason = Season::AUTUMN;
+    else currentSeason = Season::WINTER;
+
+    const std::vector<int> fullMoonDays = { 2, 4, 6, 8, 10, 13, 15, 17, 19, 21, 23, 25, 28 };
+    isFullMoon = std::find(fullMoonDays.begin(), fullMoonDays.end(), gameDay) != fullMoonDays.end();
+}
+
+// Rolls new weather for the season and returns how many ticks it lasts.
+int changeWeather() {
+    int baseTemp = 15;
+    switch (currentSeason) {
+    case Season::SPRING: baseTemp = 15; if (randomInt(g_rngWeather) % 100 < 10) currentWeather = Weather::RAINING; else currentWeather = Weather::CLEAR; break;
+    case Season::SUMMER: baseTemp = 25; currentWeather = Weather::CLEAR; break;
+    case Season::AUTUMN: baseTemp = 10; if (randomInt(g_rngWeather) % 100 < 15) currentWeather = Weather::RAINING; else currentWeather = Weather::CLEAR; break;
+    case Season::WINTER: baseTemp = -5; if (randomInt(g_rngWeather) % 100 < 20) currentWeather = Weather::SNOWING; else currentWeather = Weather::CLEAR; break;
+    }
+    if (landingBiome == Biome::DESERT) baseTemp += 15;
+    if (landingBiome == Biome::TUNDRA) baseTemp -= 20;
+    if (landingBiome == Biome::JUNGLE) baseTemp += 10;
+    temperature = baseTemp;
+    return 20000 + (randomInt(g_rngWeather) % 40000);
+}
+// Advances orbits and the star field by the given number of ticks; an idle skip passes thousands at once.
+void updateSolarSystem(long long ticks) {
+    PROFILE_SCOPE(ProfileCategory::SIM, "updateSolarSystem");
+    for (auto& planet : solarSystem) { planet.currentAngle = fmod(planet.currentAngle + planet.orbitalSpeed * ticks * 0.1, 2 * 3.14159); }
+    homeMoon.currentAngle = fmod(homeMoon.currentAngle + homeMoon.orbitalSpeed * ticks * 0.1, 2 * 3.14159);
+
+    // This logic now creates a seamless carousel effect
+    for (auto& star : distantStars) {
+        star.x = fmod(star.x + star.dx * ticks * 0.05f, 1.0f);
+        // If star goes off the left edge...
+        if (star.x < 0.0f) {
+            // ...wrap it to the right edge with a little extra to prevent pop-in
+            star.x += 1.0f;
+        }
+    }
+}
+
+// NEW: Helper function to get the total number of items a pawn is carrying.
+int getTotalItemCount(const Pawn& pawn) {
+    int total = 0;
+    for (const auto& pair : pawn.inventory) {
+        total += pair.second; // Add the count of each stack
+    }
+    return total;
+}
+
+// Rolls the periodic critter spawns (one land, one aquatic chance) while below the population cap.
+void trySpawnCritters() {
+    PROFILE_SCOPE(ProfileCategory::SIM, "Critter Spawn");
+    if (g_critters.size() >= MAX_CRITTERS) return;
+
+    // Spawn Land Critter (5% chance per check)
+    if (randomInt(g_rngCritters) % 100 < 5) {
+        if (g_BiomeCritters.count(landingBiome) && !g_BiomeCritters.at(landingBiome).empty()) {
+            const auto& possible_critters = g_BiomeCritters.at(landingBiome);
+            CritterType type_to_spawn = possible_critters[randomInt(g_rngCritters) % possible_critters.size()];
+
+            // Find a valid spawn location anywhere on the map, not just the edge
+            int spawn_x = -1, spawn_y = -1;
+            int attempts = 50;
+            while (attempts > 0) {
+                int try_x = randomInt(g_rngCritters) % WORLD_WIDTH;
+                int try_y = randomInt(g_rngCritters) % WORLD_HEIGHT;
+                if (isCritterWalkable(try_x, try_y, BIOSPHERE_Z_LEVEL)) {
+                    spawn_x = try_x;
+                    spawn_y = try_y;
+                    break;
+                }
+                attempts--;
+            }
+
+            if (spawn_x != -1) {
+                Critter new_critter;
+                new_critter.type = type_to_spawn;
+                new_critter.x = spawn_x;
+                new_critter.y = spawn_y;
+                new_critter.z = BIOSPHERE_Z_LEVEL;
+                new_critter.wanderCooldown = g_CritterData.at(type_to_spawn).wander_speed + (randomInt(g_rngCritters) % 20 - 10);
+                addCritter(new_critter);
+            }
+        }
+    }
+
+    // Spawn Aquatic Critter (2% chance per check, independent of land spawns)
+    if (randomInt(g_rngCritters) % 100 < 2) {
+        const auto& aquatic_critters = g_BiomeCritters.at(Biome::OCEAN);
+        if (!aquatic_critters.empty()) {
+            CritterType type_to_spawn = aquatic_critters[randomInt(g_rngCritters) % aquatic_critters.size()];
+
+            int spawn_x = -1, spawn_y = -1;
+            int attempts = 50;
+            while (attempts > 0) {
+                int try_x = randomInt(g_rngCritters) % WORLD_WIDTH;
+                int try_y = randomInt(g_rngCritters) % WORLD_HEIGHT;
+
+                if (Z_LEVELS[BIOSPHERE_Z_LEVEL][try_y][try_x].type == TileType::WATER) {
+                    spawn_x = try_x;
+                    spawn_y = try_y;
+                    break;
+                }
+                attempts--;
+            }
+
+            if (spawn_x != -1) {
+                Critter new_critter;
+                new_critter.type = type_to_spawn;
+                new_critter.x = spawn_x;
+                new_critter.y = spawn_y;
+                new_critter.z = BIOSPHERE_Z_LEVEL;
+                new_critter.wanderCooldown = g_CritterData.at(type_to_spawn).wander_speed + (randomInt(g_rngCritters) % 20 - 10);
+                addCritter(new_critter);
+            }
+        }
+    }
+}
+
+void trySpawnUndead() {
+    PROFILE_SCOPE(ProfileCategory::SIM, "Undead Spawn");
+    if ((randomInt(g_rngEvents) % 1000) < UNDEAD_SPAWN_CHANCE_PER_1000) {
+        int numUndead = 1 + (randomInt(g_rngEvents) % 3); // Spawn 1 to 3 undead
+        for (int i = 0; i < numUndead; ++i) {
+            int edge = randomInt(g_rngEvents) % 4; // 0: top, 1: bottom, 2: left, 3: right
+            int spawnX = 0, spawnY = 0;
+
+            if (edge == 0) { spawnX = randomInt(g_rngEvents) % WORLD_WIDTH; spawnY = 0; }
+            else if (edge == 1) { spawnX = randomInt(g_rngEvents) % WORLD_WIDTH; spawnY = WORLD_HEIGHT - 1; }
+            else if (edge == 2) { spawnX = 0; spawnY = randomInt(g_rngEvents) % WORLD_HEIGHT; }
+            else { spawnX = WORLD_WIDTH - 1; spawnY = randomInt(g_rngEvents) % WORLD_HEIGHT; }
+
+            if (isCritterWalkable(spawnX, spawnY, BIOSPHERE_Z_LEVEL)) {
+                Critter new_undead;
+                new_undead.type = (randomInt(g_rngEvents) % 2 == 0) ? CritterType::ZOMBIE : CritterType::SKELETON;
+                new_undead.x = spawnX;
+                new_undead.y = spawnY;
+                new_undead.z = BIOSPHERE_Z_LEVEL;
+                new_undead.wanderCooldown = g_CritterData.at(new_undead.type).wander_speed + (randomInt(g_rngEvents) % 50);
+                addCritter(new_undead);
+                stopFastForward(L"Undead sighted");
+            }
+        }
+    }
+}
+
+// One move of a critter: zombies close in on a nearby pawn, everything else wanders.
+// Works out one move for a critter from the map, the colonists and its own state. It reads nothing another
+// critter's move can change, so every due critter can be decided at once on any thread, in any order.
+CritterStep decideCritterStep(Critter critter, int critterIndex, long long tick) {
+    CounterRandom rng = counterRandom(RandomStreamId::CRITTERS, static_cast<uint64_t>(critterIndex), tick);
+    const auto& data = g_CritterData.at(critter.type);
+    // --- MODIFIED: Declaration of is_aquatic moved here for wider scope ---
+    bool is_aquatic = std::find(data.tags.begin(), data.tags.end(), CritterTag::AQUATIC) != data.tags.end();
+
+    bool moved = false;
+    // --- NEW: ZOMBIE AI ---
+    if (critter.type == CritterType::ZOMBIE) { // Check for zombie-like critter behavior
+        // 1. Check if current target is still valid
+        if (critter.targetPawnIndex != -1) {
+            if (critter.targetPawnIndex >= colonists.size()) {
+                critter.targetPawnIndex = -1; // Target is gone
+            }
+        }
+
+        // 2. If no target, try to find one
+        if (critter.targetPawnIndex == -1) {
+            for (int i = 0; i < colonists.size(); ++i) {
+                const auto& pawn = colonists[i];
+                int distSq = (pawn.x - critter.x) * (pawn.x - critter.x) + (pawn.y - critter.y) * (pawn.y - critter.y);
+                if (distSq < ZOMBIE_SENSE_RADIUS * ZOMBIE_SENSE_RADIUS) {
+                    critter.targetPawnIndex = i;
+                    break;
+                }
+            }
+        }
+
+        // 3. Move towards target if one exists
+        if (critter.targetPawnIndex != -1) {
+            const auto& targetPawn = colonists[critter.targetPawnIndex];
+            int dx = targetPawn.x - critter.x;
+            int dy = targetPawn.y - critter.y;
+
+            // Simple step-wise movement
+            int moveX = (dx > 0) ? 1 : ((dx < 0) ? -1 : 0);
+            int moveY = (dy > 0) ? 1 : ((dy < 0) ? -1 : 0);
+
+            int newX = critter.x + moveX;
+            int newY = critter.y + moveY;
+
+            // Zombies only move on their current Z-level
+            if (isCritterWalkable(newX, newY, critter.z)) {
+                critter.x = newX;
+                critter.y = newY;
+                moved = true;
+            }
+        }
+    }
+    // --- END: ZOMBIE AI ---
+
+    // If not moved by special AI, do normal wandering
+    if (!moved) {
+        int dx = (randomInt(rng) % 3) - 1;
+        int dy = (randomInt(rng) % 3) - 1;
+
+        if (is_aquatic) {
+            std::vector<Point3D> validNextPositions;
+
+            // Option 1: Try a purely vertical move (up or down) at current (x,y)
+            // Only try to change Z if currently at a water tile and there's a 20% chance
+            if (Z_LEVELS[critter.z][critter.y][critter.x].type == TileType::WATER && (randomInt(rng) % 100 < 20)) {
+                int dz_try = (randomInt(rng) % 2 == 0) ? -1 : 1; // Try to go up (-1) or down (+1)
+                int proposedZ_vertical = critter.z + dz_try;
+
+                // Check if purely vertical move is valid (within bounds and target tile is water)
+                if (proposedZ_vertical >= 0 && proposedZ_vertical < TILE_WORLD_DEPTH &&
+                    Z_LEVELS[proposedZ_vertical][critter.y][critter.x].type == TileType::WATER) {
+                    validNextPositions.push_back({ critter.x, critter.y, proposedZ_vertical });
+                }
+            }
+
+            // Option 2: Try a 2D horizontal move on the current Z-level
+            int newX_horiz = critter.x + dx;
+            int newY_horiz = critter.y + dy;
+
+            // Check if horizontal move is valid (within bounds and target tile is water)
+            if (newX_horiz >= 0 && newX_horiz < WORLD_WIDTH &&
+                newY_horiz >= 0 && newY_horiz < WORLD_HEIGHT &&
+                Z_LEVELS[critter.z][newY_horiz][newX_horiz].type == TileType::WATER) {
+                validNextPositions.push_back({ newX_horiz, newY_horiz, critter.z });
+            }
+
+            // If there are valid moves, pick one randomly and move there
+            if (!validNextPositions.empty()) {
+                Point3D chosenMove = validNextPositions[randomInt(rng) % validNextPositions.size()];
+                critter.x = chosenMove.x;
+                critter.y = chosenMove.y;
+                critter.z = chosenMove.z;
+                moved = true;
+            }
+        }
+        else { // Non-aquatic critter: use isCritterWalkable
+            int newX = critter.x + dx;
+            int newY = critter.y + dy;
+
+            if (newX >= 0 && newX < WORLD_WIDTH && newY >= 0 && newY < WORLD_HEIGHT) {
+                if (isCritterWalkable(newX, newY, critter.z)) {
+                    critter.x = newX;
+                    critter.y = newY;
+                }
+            }
+        }
+    }
+    return { critter, std::max(1, data.wander_speed + (randomInt(rng) % 20 - 10)) };
+}
+
+// Starts a haul scan: snapshots every loose stack as a source for the AI scheduler to work through
+// under its per-tick budget. A scan still in progress is left to finish first.
+void startHaulScan() {
+    PROFILE_SCOPE(ProfileCategory::SIM, "Haul Scan");
+    if (g_haulScan.active) return;
+
+    // Tick down cooldowns for unreachable stockpiles in the cache.
+    for (auto it = g_unreachableStockpileCache.begin(); it != g_unreachableStockpileCache.end(); ) {
+        it->second--; // Decrement cooldown timer
+        if (it->second <= 0) {
+            it = g_unreachableStockpileCache.erase(it); // Remove from cache if cooldown expires
+        }
+        else {
+            ++it;
+        }
+    }
+
+    // Loose stacks come straight from the item index, so every Z-level is covered without scanning the grid.
+    // A cell is visited once, under the type on top of its stack.
+    std::vector<Point3D>& haulSources = g_haulScan.sources;
+    haulSources.clear();
+    for (const auto& typeEntry : g_itemIndex) {
+        for (const auto& chunk : typeEntry.second.chunks) {
+            for (const Point3D& p : chunk.second) {
+                const MapCell& cell = Z_LEVELS[p.z][p.y][p.x];
+                if (!cell.itemsOnGround.empty() && cell.itemsOnGround.front() == typeEntry.first) haulSources.push_back(p);
+            }
+        }
+    }
+    std::sort(haulSources.begin(), haulSources.end());
+    g_haulScan.next = 0;
+    g_haulScan.active = !haulSources.empty();
+}
+
+// Queues a haul job for one source stack, if it still needs moving and a reachable stockpile spot is free.
+void scanHaulSource(const Point3D& sourcePoint) {
+    PROFILE_SCOPE(ProfileCategory::SIM, "Haul Scan");
+    int x = sourcePoint.x, y = sourcePoint.y, z = sourcePoint.z;
+    MapCell& cell = Z_LEVELS[z][y][x];
+    if (cell.itemsOnGround.empty()) return; // Picked up since the scan started
+
+    bool itemNeedsHauling = true;
+    if (cell.stockpileId != -1) {
+        const Stockpile* sp = findStockpileById(cell.stockpileId);
+        if (sp && sp->acceptedResources.count(cell.itemsOnGround.front())) {
+            itemNeedsHauling = false;
+        }
+    }
+
+    for (const auto& job : jobQueue) {
+        if (job.type == JobType::Haul && job.itemSourceX == x && job.itemSourceY == y && job.itemSourceZ == z) {
+            itemNeedsHauling = false;
+            break;
+        }
+    }
+
+    if (!itemNeedsHauling) return;
+
+    TileType itemToHaul = cell.itemsOnGround.front();
+
+    // Pick one spot per accepting stockpile, then rank the stockpiles by estimated trip cost through stairs.
+    // Stable sort keeps id order (older stockpiles first) between equally distant candidates.
+    std::vector<std::pair<int, std::pair<int, Point3D>>> candidates; // cost -> (stockpile id, spot)
+    for (const auto& sp : g_stockpiles) {
+        // If this stockpile is in the unreachable cache, skip it entirely.
+        if (g_unreachableStockpileCache.count(sp.id) || !sp.acceptedResources.count(itemToHaul)) {
+            continue;
+        }
+
+        Point3D potentialDest = { -1, -1, -1 };
+        bool foundSpotInThisSP = false;
+
+        // Pass 1: Look for existing stacks
+        for (size_t c = 0; c < sp.cells.size() && !foundSpotInThisSP; ++c) {
+            const MapCell& destCell = Z_LEVELS[sp.cells[c].z][sp.cells[c].y][sp.cells[c].x];
+            if (!destCell.itemsOnGround.empty() && destCell.itemsOnGround.front() == itemToHaul && destCell.itemsOnGround.size() < MAX_STACK_SIZE) {
+                potentialDest = sp.cells[c];
+                foundSpotInThisSP = true;
+            }
+        }
+        // Pass 2: Look for empty spots
+        for (size_t c = 0; c < sp.cells.size() && !foundSpotInThisSP; ++c) {
+            const Point3D& p = sp.cells[c];
+            if (Z_LEVELS[p.z][p.y][p.x].itemsOnGround.empty() && isWalkable(p.x, p.y, p.z)) {
+                potentialDest = p;
+                foundSpotInThisSP = true;
+            }
+        }
+        if (!foundSpotInThisSP) continue;
+
+        // No stair chain joins the two levels: nothing to path-check, and no reason to blacklist the stockpile.
+        int cost = estimateHaulCost(sourcePoint, potentialDest);
+        if (cost == HAUL_COST_UNREACHABLE) continue;
+        candidates.push_back({ cost, { sp.id, potentialDest } });
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [](const std::pair<int, std::pair<int, Point3D>>& a, const std::pair<int, std::pair<int, Point3D>>& b) {
+        return a.first < b.first;
+        });
+
+    for (const auto& candidate : candidates) {
+        int stockpileId = candidate.second.first;
+        const Point3D& potentialDest = candidate.second.second;
+
+        // The estimate ignores walls, so confirm with the real search before committing a job.
+        if (!isReachable(sourcePoint, potentialDest)) {
+            g_unreachableStockpileCache[stockpileId] = 20; // Cooldown for 20 scan cycles (~2000 ticks)
+            continue;
+        }
+
+        // Check if this spot is already targeted by another haul job
+        bool isTargeted = false;
+        for (const auto& job : jobQueue) {
+            if (job.type == JobType::Haul && job.x == potentialDest.x && job.y == potentialDest.y && job.z == potentialDest.z) {
+                isTargeted = true;
+                break;
+            }
+        }
+
+        if (!isTargeted) {
+            jobQueue.push_back({ JobType::Haul, potentialDest.x, potentialDest.y, potentialDest.z, -1, itemToHaul, x, y, z });
+            break; // Found a valid, reachable, untargeted spot. Stop searching.
+        }
+    }
+}
+
+// Picks the best reachable job for an idle pawn (queued jobs by priority, then nearby chop designations)
+// and sets it on its way. Runs from the AI scheduler, not inline in the pawn update.
+int pawnSkill(const Pawn& pawn, const std::wstring& skill) {
+    auto it = pawn.skills.find(skill);
+    return (it != pawn.skills.end()) ? it->second : 0;
+}
+
+// Where a pawn runs to from a threat: well away along the line from the threat, on the pawn's own level.
+Point3D fleeTargetFor(const Pawn& pawn, const Critter& threat) {
+    int fleeVecX = pawn.x - threat.x;
+    int fleeVecY = pawn.y - threat.y;
+    int targetX = std::max(0, std::min(WORLD_WIDTH - 1, pawn.x + fleeVecX * 5));
+    int targetY = std::max(0, std::min(WORLD_HEIGHT - 1, pawn.y + fleeVecY * 5));
+    return { targetX, targetY, pawn.z };
+}
+
+// The read-only part of a pawn's tick: spotting the closest undead and, for a pawn that is about to start
+// fleeing, the path away from it. Runs for all pawns at once, before any of them acts.
+PawnThought thinkPawn(const Pawn& pawn) {
+    const int PAWN_SIGHT_RADIUS = 10;
+    PawnThought thought;
+    int closestThreatDistSq = PAWN_SIGHT_RADIUS * PAWN_SIGHT_RADIUS + 1;
+    for (size_t i = 0; i < g_critters.size(); ++i) {
+        const Critter& critter = g_critters[i];
+        if (critter.type == CritterType::ZOMBIE || critter.type == CritterType::SKELETON) {
+            int distSq = (pawn.x - critter.x) * (pawn.x - critter.x) + (pawn.y - critter.y) * (pawn.y - critter.y);
+            if (distSq < closestThreatDistSq) {
+                closestThreatDistSq = distSq;
+                thought.threatIndex = (int)i;
+            }
+        }
+    }
+    if (thought.threatIndex != -1 && pawn.currentTask != L"Fleeing") {
+        thought.fleePath = findPath({ pawn.x, pawn.y, pawn.z }, fleeTargetFor(pawn, g_critters[thought.threatIndex]));
+    }
+    return thought;
+}
+
+// Picks the job an idle pawn should take and finds the path to it. Only reads the world, so job searches for
+// many pawns can run side by side; nothing is claimed until claimJobChoice().
+JobChoice chooseJobForPawn(const Pawn& pawn) {
+    Job bestJob = {};
+    int bestPriority = -1;
+    int bestJobIndex = -1;
+    Point3D finalDestinationForJob = { -1, -1, -1 }; // The actual tile to path to
+
+    // 1. First, check the central job queue for non-chopping jobs.
+    for (size_t i = 0; i < jobQueue.size(); ++i) {
+        const Job& currentJob = jobQueue[i];
+        if (currentJob.type == JobType::Chop) continue; // Pawns find chop jobs themselves now.
+        if (currentJob.type == JobType::Haul && gameTicks < pawn.haulBlockedUntilTick) continue;
+
+        int currentPawnSkill = 0;
+        switch (currentJob.type) {
+        case JobType::Build: currentPawnSkill = pawnSkill(pawn, L"Construction"); break;
+        case JobType::Research: currentPawnSkill = pawnSkill(pawn, L"Research"); break;
+        case JobType::Mine: currentPawnSkill = pawnSkill(pawn, L"Mining"); break;
+        case JobType::Haul: currentPawnSkill = pawnSkill(pawn, L"Hauling"); break; // Hauling now uses skill
+        case JobType::Deconstruct: currentPawnSkill = pawnSkill(pawn, L"Construction"); break; // Deconstruct uses Construction
+        default: currentPawnSkill = 1; // Default minimum skill for other jobs
+        }
+        if (currentPawnSkill == 0) continue; // Pawn cannot perform this job
+
+        Point3D jobCoreLocation;
+        if (currentJob.type == JobType::Haul) {
+            jobCoreLocation = { currentJob.itemSourceX, currentJob.itemSourceY, currentJob.itemSourceZ };
+        }
+        else {
+            jobCoreLocation = { currentJob.x, currentJob.y, currentJob.z };
+        }
+
+        // Determine the actual tile the pawn needs to path to (adjacent or direct)
+        Point3D tempTargetDestination;
+        bool targetRequiresAdjacent = (currentJob.type != JobType::Haul); // Mining, Build, Research, Deconstruct require adjacent
+
+        if (targetRequiresAdjacent) {
+            // Find an adjacent walkable tile that can be reached
+            bool foundAdjacentReachable = false;
+            for (int dz_adj = -1; dz_adj <= 1; ++dz_adj) {
+                for (int dy_adj = -1; dy_adj <= 1; ++dy_adj) {
+                    for (int dx_adj = -1; dx_adj <= 1; ++dx_adj) {
+                        if (dx_adj == 0 && dy_adj == 0 && dz_adj == 0) continue;
+                        tempTargetDestination = { jobCoreLocation.x + dx_adj, jobCoreLocation.y + dy_adj, jobCoreLocation.z + dz_adj };
+                        if (isWalkable(tempTargetDestination.x, tempTargetDestination.y, tempTargetDestination.z)) {
+                            // Only check path existence, not generate it yet
+                            if (isReachable({ pawn.x, pawn.y, pawn.z }, tempTargetDestination)) {
+                                foundAdjacentReachable = true;
+                                goto foundAdjacentForJob; // Exit nested loops
+                            }
+                        }
+                    }
+                }
+            }
+        foundAdjacentForJob:;
+            if (!foundAdjacentReachable) continue; // Skip job if no reachable adjacent tile found
+        }
+        else { // Hauling, path directly to the item
+            tempTargetDestination = jobCoreLocation;
+            if (!isReachable({ pawn.x, pawn.y, pawn.z }, tempTargetDestination)) { // Check path existence
+                continue; // Skip job if source is unreachable
+            }
+        }
+
+        int priority = pawn.priorities.at(currentJob.type);
+        if (priority > bestPriority) {
+            bestPriority = priority;
+            bestJob = currentJob;
+            bestJobIndex = static_cast<int>(i);
+            finalDestinationForJob = tempTargetDestination; // Store the actual point to path to
+        }
+    }
+
+    // 2. If no better non-chop job was found, check for nearby designated trees.
+    int chopPriority = pawn.priorities.at(JobType::Chop);
+    if (chopPriority > bestPriority) {
+        const int searchRadius = 30; // Pawns will only look for trees within this radius.
+        int bestTreeId = -1;
+        int bestTreeDistSq = searchRadius * searchRadius + 1;
+        Point3D treeJobTarget = { -1, -1, -1 }; // Target adjacent to tree root
+
+        for (int dy = -searchRadius; dy <= searchRadius; ++dy) {
+            for (int dx = -searchRadius; dx <= searchRadius; ++dx) {
+                int checkX = pawn.x + dx;
+                int checkY = pawn.y + dy;
+
+                if (checkX >= 0 && checkX < WORLD_WIDTH && checkY >= 0 && checkY < WORLD_HEIGHT) {
+                    if (designations[checkY][checkX] == L'C') { // Check for chop designation
+                        MapCell& cell = Z_LEVELS[BIOSPHERE_Z_LEVEL][checkY][checkX];
+                        if (cell.tree != nullptr) {
+                            int distSq = dx * dx + dy * dy; // Distance to designated *part*
+                            if (distSq < bestTreeDistSq) {
+                                // Find a walkable spot adjacent to the *tree root*
+                                int treeRootX = cell.tree->rootX;
+                                int treeRootY = cell.tree->rootY;
+                                bool foundSpot = false;
+                                for (int sdy = -1; sdy <= 1 && !foundSpot; ++sdy) {
+                                    for (int sdx = -1; sdx <= 1 && !foundSpot; ++sdx) {
+                                        if (sdx == 0 && sdy == 0) continue;
+                                        Point3D standSpot = { treeRootX + sdx, treeRootY + sdy, BIOSPHERE_Z_LEVEL };
+                                        if (isWalkable(standSpot.x, standSpot.y, standSpot.z)) {
+                                            // Check if pawn can path to this adjacent spot
+                                            if (isReachable({ pawn.x, pawn.y, pawn.z }, standSpot)) {
+                                                bestTreeId = cell.tree->id;
+                                                bestTreeDistSq = distSq; // Update with dist to designated part, not root
+                                                treeJobTarget = standSpot;
+                                                foundSpot = true;
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // If a reachable tree was found, it's the best job.
+        if (bestTreeId != -1) {
+            bestPriority = chopPriority;
+            bestJob.type = JobType::Chop;
+            bestJob.treeId = bestTreeId;
+            bestJob.x = treeJobTarget.x; // Store the adjacent spot as job target
+            bestJob.y = treeJobTarget.y;
+            bestJob.z = treeJobTarget.z;
+            finalDestinationForJob = treeJobTarget;
+            bestJobIndex = -1; // Indicate it's not from jobQueue
+        }
+    }
+
+    // 3. If a valid job was found, calculate the path. The job is only worth taking if a path exists.
+    JobChoice choice;
+    if (bestPriority >= 0) {
+        choice.path = findPath({ pawn.x, pawn.y, pawn.z }, finalDestinationForJob);
+        choice.found = !choice.path.empty();
+        choice.job = bestJob;
+        choice.queueIndex = bestJobIndex;
+        if (bestJob.type == JobType::Chop) choice.treeRootMark = designations[a_trees.at(bestJob.treeId).rootY][a_trees.at(bestJob.treeId).rootX];
+    }
+    return choice;
+}
+
+// Takes the chosen job if nobody claimed it since it was chosen. Returns false if it is gone.
+bool claimJobChoice(Pawn& pawn, JobChoice& choice) {
+    if (!choice.found) return true; // Nothing to claim; the pawn stays idle and retries on its next search
+    const Job& bestJob = choice.job;
+    int bestJobIndex = choice.queueIndex;
+    if (bestJobIndex != -1) {
+        // Earlier claims may have shifted the queue; find the job again by what it is.
+        auto sameJob = [&](const Job& job) {
+            return job.type == bestJob.type && job.x == bestJob.x && job.y == bestJob.y && job.z == bestJob.z && job.itemType == bestJob.itemType &&
+                job.itemSourceX == bestJob.itemSourceX && job.itemSourceY == bestJob.itemSourceY && job.itemSourceZ == bestJob.itemSourceZ;
+            };
+        if (bestJobIndex >= (int)jobQueue.size() || !sameJob(jobQueue[bestJobIndex])) {
+            auto it = std::find_if(jobQueue.begin(), jobQueue.end(), sameJob);
+            if (it == jobQueue.end()) return false;
+            bestJobIndex = static_cast<int>(it - jobQueue.begin());
+        }
+    }
+    else if (bestJob.type == JobType::Chop) {
+        auto tree = a_trees.find(bestJob.treeId);
+        if (tree == a_trees.end() || designations[tree->second.rootY][tree->second.rootX] != choice.treeRootMark) return false;
+    }
+
+    pawn.currentPath.swap(choice.path);
+    pawn.currentPathIndex = 0;
+    pawn.ticksStuck = 0; // Reset stuck counter for new path
+
+    if (bestJob.type == JobType::Haul) {
+        pawn.currentTask = L"Gathering Items"; // Hauling has two phases
+        pawn.haulSourceX = bestJob.itemSourceX; pawn.haulSourceY = bestJob.itemSourceY; pawn.haulSourceZ = bestJob.itemSourceZ;
+        pawn.haulDestX = bestJob.x; pawn.haulDestY = bestJob.y; pawn.haulDestZ = bestJob.z;
+    }
+    else {
+        pawn.currentTask = JobTypeNames[static_cast<int>(bestJob.type)];
+        pawn.jobTreeId = bestJob.treeId; // Only relevant for chop jobs
+    }
+
+    // If job was from queue, remove it. Chop jobs are marked via designation.
+    if (bestJobIndex != -1) {
+        jobQueue.erase(jobQueue.begin() + bestJobIndex);
+    }
+    else if (bestJob.type == JobType::Chop) {
+        // Mark this specific tree's root as "in progress" by changing the designation.
+        designations[a_trees[bestJob.treeId].rootY][a_trees[bestJob.treeId].rootX] = L'c';
+    }
+    return true;
+}
+
+void searchJobForPawn(Pawn& pawn) {
+    JobChoice choice = chooseJobForPawn(pawn);
+    claimJobChoice(pawn, choice);
+}
+
+// --- AI Scheduler ---
+void resetAiScheduler() {
+    g_aiDeferredTasks.clear();
+    g_haulScan = HaulScanState();
+    g_aiStats = AiSchedulerStats();
+}
+
+// The read-only half of a deferred task: searching for a job or a path. Safe to run on any thread.
+AiTaskResult thinkAiTask(const AiTask& task) {
+    AiTaskResult result;
+    if (task.pawnIndex < 0 || task.pawnIndex >= (int)colonists.size()) return result;
+    const Pawn& pawn = colonists[task.pawnIndex];
+    if (task.type == AiTaskType::JOB_SEARCH) {
+        if (pawn.currentTask == L"Idle" && !pawn.isDrafted) result.choice = chooseJobForPawn(pawn);
+    }
+    else if (task.type == AiTaskType::REPLAN) {
+        if (pawn.currentTask == L"Fleeing" && pawn.targetX != -1) {
+            result.path = findPath({ pawn.x, pawn.y, pawn.z }, { pawn.targetX, pawn.targetY, pawn.targetZ });
+        }
+    }
+    return result;
+}
+
+// Applies a thought-out task. A job another pawn claimed first in the same batch is searched for again.
+void commitAiTask(const AiTask& task, AiTaskResult& result) {
+    if (task.pawnIndex < 0 || task.pawnIndex >= (int)colonists.size()) return;
+    Pawn& pawn = colonists[task.pawnIndex];
+    if (task.type == AiTaskType::JOB_SEARCH) {
+        pawn.jobSearchQueued = false;
+        pawn.nextJobSearchTick = gameTicks + 15 + (randomInt(g_rngPawns) % 10);
+        if (pawn.currentTask == L"Idle" && !pawn.isDrafted && !claimJobChoice(pawn, result.choice)) searchJobForPawn(pawn);
+    }
+    else if (task.type == AiTaskType::REPLAN) {
+        pawn.replanQueued = false;
+        if (pawn.currentTask == L"Fleeing" && pawn.targetX != -1) {
+            pawn.currentPath.swap(result.path);
+            pawn.currentPathIndex = 0;
+        }
+    }
+}
+
+// Thinks a batch of tasks through side by side on the worker pool, then commits them in pawn order.
+void runAiTaskBatch(std::vector<AiTask>& batch) {
+    std::stable_sort(batch.begin(), batch.end(), [](const AiTask& a, const AiTask& b) { return a.pawnIndex < b.pawnIndex; });
+    std::vector<AiTaskResult> results(batch.size());
+    {
+        PROFILE_SCOPE(ProfileCategory::SIM, "Pawn Job Search");
+        parallelFor(batch.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) results[i] = thinkAiTask(batch[i]);
+            });
+    }
+    for (size_t i = 0; i < batch.size(); ++i) commitAiTask(batch[i], results[i]);
+}
+
+// Works through deferred pawn requests, then the running haul scan, until this tick's budget is spent.
+// Each gets at least one step per tick so neither can starve.
+void runAiScheduler() {
+    PROFILE_SCOPE(ProfileCategory::SIM, "AI Scheduler");
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::microseconds(g_aiBudgetMicros);
+    // A time budget makes how much gets done depend on the machine; determinism runs use a fixed quota instead.
+    auto withinBudget = [&](int done) {
+        if (g_aiTaskQuota > 0) return done < g_aiTaskQuota;
+        return done == 0 || std::chrono::steady_clock::now() < deadline;
+    };
+
+    int tasksRun = 0;
+    while (!g_aiDeferredTasks.empty() && withinBudget(tasksRun)) {
+        std::vector<AiTask> batch;
+        while (!g_aiDeferredTasks.empty() && batch.size() < AI_TASK_BATCH) {
+            batch.push_back(g_aiDeferredTasks.front());
+            g_aiDeferredTasks.pop_front();
+        }
+        runAiTaskBatch(batch);
+        tasksRun += (int)batch.size();
+    }
+
+    int sourcesScanned = 0;
+    while (g_haulScan.active && withinBudget(sourcesScanned)) {
+        scanHaulSource(g_haulScan.sources[g_haulScan.next++]);
+        sourcesScanned++;
+        if (g_haulScan.next >= g_haulScan.sources.size()) g_haulScan.active = false;
+    }
+
+    g_aiStats.tasksRun = tasksRun;
+    g_aiStats.haulSourcesScanned = sourcesScanned;
+    g_aiStats.lastTickMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// --- Timer Wheel ---
+void resetTimerWheel(long long tick) {
+    for (auto& level : g_timerWheel.slots) for (auto& slot : level) slot.clear();
+    g_timerWheel.overflow.clear();
+    g_timerWheel.currentTick = tick;
+}
+
+// Files the event under the coarsest slot that still comes around before it is due.
+void placeTimerEvent(const TimerEvent& event) {
+    long long delta = event.dueTick - g_timerWheel.currentTick;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+        if (delta < (1LL << (TIMER_WHEEL_SLOT_BITS * (level + 1)))) {
+            g_timerWheel.slots[level][(event.dueTick >> (TIMER_WHEEL_SLOT_BITS * level)) & (TIMER_WHEEL_SLOTS - 1)].push_back(event);
+            return;
+        }
+    }
+    g_timerWheel.overflow.push_back(event);
+}
+
+// Anything due now or in the past fires on the next tick, never in a tick that has already run.
+void scheduleTimer(long long dueTick, TimerKind kind, int target) {
+    placeTimerEvent({ std::max(dueTick, g_timerWheel.currentTick + 1), kind, target });
+}
+
+void addCritter(const Critter& critter) {
+    g_critters.push_back(critter);
+    scheduleTimer(gameTicks + std::max(1, critter.wanderCooldown), TimerKind::CRITTER_MOVE, (int)g_critters.size() - 1);
+}
+
+// Repeating events book their next run from their own due tick, so running several ticks per update
+// (gameSpeed > 1) neither drops nor delays any of them.
+void runTimerEvent(const TimerEvent& event) {
+    switch (event.kind) {
+    case TimerKind::WEATHER_CHANGE:
+        scheduleTimer(event.dueTick + changeWeather(), TimerKind::WEATHER_CHANGE);
+        break;
+    case TimerKind::CRITTER_SPAWN:
+        trySpawnCritters();
+        scheduleTimer(event.dueTick + CRITTER_SPAWN_INTERVAL, TimerKind::CRITTER_SPAWN);
+        break;
+    case TimerKind::UNDEAD_SPAWN:
+        trySpawnUndead();
+        scheduleTimer(event.dueTick + UNDEAD_SPAWN_INTERVAL, TimerKind::UNDEAD_SPAWN);
+        break;
+    case TimerKind::HAUL_SCAN:
+        startHaulScan();
+        scheduleTimer(event.dueTick + HAUL_SCAN_INTERVAL, TimerKind::HAUL_SCAN);
+        break;
+    case TimerKind::CRITTER_MOVE:
+        break; // Batched by runCritterMoves
+    }
+}
+
+// Moves every critter due this tick: decides all of them in parallel, then commits in critter order. Critters
+// are never removed, so an index is a stable ID for the per-critter random numbers.
+void runCritterMoves(const std::vector<TimerEvent>& due, size_t first, long long tick) {
+    PROFILE_SCOPE(ProfileCategory::SIM, "Critter Update");
+    std::vector<int> movers;
+    for (size_t i = first; i < due.size(); ++i) {
+        if (due[i].target >= 0 && due[i].target < (int)g_critters.size()) movers.push_back(due[i].target);
+    }
+    std::vector<CritterStep> steps(movers.size());
+    parallelFor(movers.size(), CRITTER_CHUNK_SIZE, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) steps[i] = decideCritterStep(g_critters[movers[i]], movers[i], tick);
+        });
+    for (size_t i = 0; i < movers.size(); ++i) {
+        g_critters[movers[i]] = steps[i].critter;
+        scheduleTimer(tick + steps[i].nextMoveDelay, TimerKind::CRITTER_MOVE, movers[i]);
+    }
+}
+
+// Moves the wheel on by one tick and returns the events due on it. The caller clears the slot once done.
+std::vector<TimerEvent>& advanceTimerWheel() {
+    TimerWheel& wheel = g_timerWheel;
+    long long tick = ++wheel.currentTick;
+
+    // Coarse levels first: their slot for this tick spills into the finer levels (possibly into this tick).
+    if ((tick & ((1LL << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS)) - 1)) == 0) {
+        std::vector<TimerEvent> far;
+        far.swap(wheel.overflow);
+        for (const TimerEvent& event : far) placeTimerEvent(event);
+    }
+    for (int level = TIMER_WHEEL_LEVELS - 1; level >= 1; --level) {
+        if ((tick & ((1LL << (TIMER_WHEEL_SLOT_BITS * level)) - 1)) != 0) continue;
+        std::vector<TimerEvent>& slot = wheel.slots[level][(tick >> (TIMER_WHEEL_SLOT_BITS * level)) & (TIMER_WHEEL_SLOTS - 1)];
+        for (const TimerEvent& event : slot) placeTimerEvent(event);
+        slot.clear();
+    }
+    return wheel.slots[0][tick & (TIMER_WHEEL_SLOTS - 1)];
+}
+
+// Fires every event due between the last processed tick and gameTicks, one tick at a time.
+void runDueTimers() {
+    PROFILE_SCOPE(ProfileCategory::SIM, "Timers");
+    TimerWheel& wheel = g_timerWheel;
+    while (wheel.currentTick < gameTicks) {
+        // Events booked while these run are due on a later tick, so they never land back in this slot.
+        std::vector<TimerEvent>& due = advanceTimerWheel();
+        long long tick = wheel.currentTick;
+        std::sort(due.begin(), due.end(), [](const TimerEvent& a, const TimerEvent& b) {
+            if (a.kind != b.kind) return a.kind < b.kind;
+            return a.target < b.target;
+            });
+        // Critter moves sort last; they run as one batch once everything else due this tick has.
+        size_t firstMove = 0;
+        while (firstMove < due.size() && due[firstMove].kind != TimerKind::CRITTER_MOVE) runTimerEvent(due[firstMove++]);
+        runCritterMoves(due, firstMove, tick);
+        due.clear();
+    }
+}
+
+// Starts the wheel at the current gameTicks with the world's systems and every critter already placed.
+void startSimulationTimers() {
+    resetTimerWheel(gameTicks);
+    resetAiScheduler();
+    scheduleTimer(gameTicks + 1, TimerKind::WEATHER_CHANGE);
+    scheduleTimer(gameTicks + CRITTER_SPAWN_INTERVAL, TimerKind::CRITTER_SPAWN);
+    scheduleTimer(gameTicks + UNDEAD_SPAWN_INTERVAL, TimerKind::UNDEAD_SPAWN);
+    scheduleTimer(gameTicks + HAUL_SCAN_INTERVAL, TimerKind::HAUL_SCAN);
+    for (size_t i = 0; i < g_critters.size(); ++i) {
+        scheduleTimer(gameTicks + std::max(1, g_critters[i].wanderCooldown), TimerKind::CRITTER_MOVE, (int)i);
+    }
+}
+
+// --- Idle Skip-Ahead ---
+// While the colony has nothing to do, every tick up to the next scheduled event only moves wanderers around.
+// Fast-forward then jumps straight to the tick before that event. Critters take the moves they would have made in
+// the gap, each decided for the tick it was due on, up to IDLE_SKIP_MAX_CRITTER_MOVES; undead stop as soon as they
+// come within sensing range of a pawn, so the colony sees them once the jump lands. Haul scans in the gap are
+// rebooked for the first tick after it, and idle pawns take a single wander step when they wake.
+const long long IDLE_SKIP_MIN_TICKS = 60; // Shorter gaps are cheaper to just run
+const int IDLE_SKIP_MAX_CRITTER_MOVES = 1024; // A random walk this long has crossed the map; later moves are dropped
+
+bool isColonyIdle() {
+    if (colonists.empty() || !jobQueue.empty()) return false;
+    return std::all_of(colonists.begin(), colonists.end(), [](const Pawn& p) { return p.currentTask == L"Idle"; });
+}
+
+bool isUndeadNearPawn(const Critter& critter) {
+    if (critter.type != CritterType::ZOMBIE && critter.type != CritterType::SKELETON) return false;
+    for (const Pawn& pawn : colonists) {
+        int distSq = (pawn.x - critter.x) * (pawn.x - critter.x) + (pawn.y - critter.y) * (pawn.y - critter.y);
+        if (distSq < ZOMBIE_SENSE_RADIUS * ZOMBIE_SENSE_RADIUS) return true;
+    }
+    return false;
+}
+
+// Idle, and nothing can hand anyone work before the next event: no pending searches or scans, no chop
+// designations for a wandering pawn to stumble across, no tree mid-fall and no undead in sensing range.
+bool canSkipIdleTime() {
+    if (!isColonyIdle() || !g_aiDeferredTasks.empty() || g_haulScan.active || !a_fallingTrees.empty()) return false;
+    for (const Pawn& pawn : colonists) {
+        if (pawn.isDrafted || pawn.jobSearchQueued) return false;
+    }
+    for (const Critter& critter : g_critters) {
+        if (isUndeadNearPawn(critter)) return false;
+    }
+    for (int y = 0; y < WORLD_HEIGHT; ++y) {
+        if (std::find(designations[y].begin(), designations[y].end(), L'C') != designations[y].end()) return false;
+    }
+    return true;
+}
+
+// The next tick at which currentTimeOfDay changes, or the next midnight, where the day (and full moon) roll over.
+long long nextTimeOfDayChangeTick(long long tick) {
+    const int boundaryHours[] = { 0, 5, 7, 12, 16, 18, 20, 22 };
+    long long dayStart = tick - tick % TICKS_PER_DAY;
+    for (int hour : boundaryHours) {
+        long long boundary = dayStart + hour * TICKS_PER_DAY / 24;
+        if (boundary > tick) return boundary;
+    }
+    return dayStart + TICKS_PER_DAY;
+}
+
+// The earliest weather change or spawn roll on the wheel. Critter moves and haul scans don't count: skipping
+// is exactly what they get folded into.
+long long nextScheduledEventTick() {
+    long long next = LLONG_MAX;
+    auto consider = [&next](const std::vector<TimerEvent>& events) {
+        for (const TimerEvent& event : events) {
+            if (event.kind != TimerKind::CRITTER_MOVE && event.kind != TimerKind::HAUL_SCAN && event.dueTick < next) next = event.dueTick;
+        }
+    };
+    for (const auto& level : g_timerWheel.slots) for (const auto& slot : level) consider(slot);
+    consider(g_timerWheel.overflow);
+    return next;
+}
+
+// Makes the moves a critter would have made from its due tick through the given tick. Pawns hold still during a
+// skip and critter moves never read each other, so the walk matches running the ticks one by one. Returns the
+// tick of the critter's next move.
+long long walkCritterThrough(int critterIndex, long long dueTick, long long tick) {
+    Critter& critter = g_critters[critterIndex];
+    for (int moves = 0; dueTick <= tick && moves < IDLE_SKIP_MAX_CRITTER_MOVES && !isUndeadNearPawn(critter); ++moves) {
+        CritterStep step = decideCritterStep(critter, critterIndex, dueTick);
+        critter = step.critter;
+        dueTick += step.nextMoveDelay;
+    }
+    return std::max(dueTick, tick + 1);
+}
+
+// Moves the wheel to the given tick without running anything. Critters walk through the moves that were due on
+// the way, and haul scans are rebooked for the tick after; the skip stops short of every other event.
+void skipTimersTo(long long tick) {
+    std::vector<TimerEvent> deferred;
+    while (g_timerWheel.currentTick < tick) {
+        std::vector<TimerEvent>& due = advanceTimerWheel();
+        deferred.insert(deferred.end(), due.begin(), due.end());
+        due.clear();
+    }
+    parallelFor(deferred.size(), CRITTER_CHUNK_SIZE, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            TimerEvent& event = deferred[i];
+            if (event.kind == TimerKind::CRITTER_MOVE && event.target >= 0 && event.target < (int)g_critters.size()) {
+                event.dueTick = walkCritterThrough(event.target, event.dueTick, tick);
+            }
+            else {
+                event.dueTick = tick + 1;
+            }
+        }
+        });
+    for (const TimerEvent& event : deferred) placeTimerEvent(event);
+}
+
+// Jumps gameTicks so that the next updateTime() lands on the next event or time-of-day change. Returns whether
+// it skipped anything. The jump is a whole number of updateTime() steps, and the ambient light takes each of
+// those steps, so it ends where running the ticks would have left it (the time of day can't change on the way).
+bool skipIdleTime() {
+    if (gameSpeed <= 0 || !canSkipIdleTime()) return false;
+    long long steps = (std::min(nextScheduledEventTick(), nextTimeOfDayChangeTick(gameTicks)) - gameSpeed - gameTicks) / gameSpeed;
+    long long target = gameTicks + steps * gameSpeed;
+    if (target - gameTicks < IDLE_SKIP_MIN_TICKS) return false;
+    PROFILE_SCOPE(ProfileCategory::SIM, "Idle Skip");
+    skipTimersTo(target);
+    updateSolarSystem(target - gameTicks);
+    for (long long step = 0; step < steps; ++step) {
+        float previous = currentLightLevel;
+        stepLightLevel();
+        if (currentLightLevel == previous) break; // Settled; the remaining steps would not move it either
+    }
+    gameTicks = target;
+    return true;
+}
+
+// Puts every colonist on the nearest walkable surface tile around the chosen start.
+void placeColonists(int startX, int startY) {
+    for (auto& p : colonists) {
+        bool placed = false;
+        for (int radius = 0; radius < 20 && !placed; ++radius) {
+            for (int dy = -radius; dy <= radius && !placed; ++dy) {
+                for (int dx = -radius; dx <= radius && !placed; ++dx) {
+                    if (abs(dx) != radius && abs(dy) != radius) continue;
+                    int checkX = startX + dx, checkY = startY + dy;
+                    if (checkX >= 0 && checkX < WORLD_WIDTH && checkY >= 0 && checkY < WORLD_HEIGHT) {
+                        if (isWalkable(checkX, checkY, BIOSPHERE_Z_LEVEL)) {
+                            p.x = checkX; p.y = checkY; p.z = BIOSPHERE_Z_LEVEL; placed = true;
+                        }
+                    }
+                }
+            }
+        }
+        if (!placed) { p.x = startX; p.y = startY; p.z = BIOSPHERE_Z_LEVEL; }
+    }
+}
+
+void updateGame() {
+    if (gameSpeed > 0) {
+        PROFILE_SCOPE(ProfileCategory::SIM, "updateGame");
+        updateTime();
+        updateSolarSystem(gameSpeed);
+        updateFallingTrees();
+
+        runDueTimers(); // Weather, spawning, haul scans and critter moves, each only when due
+        runAiScheduler(); // Job searches, re-plans and haul scan sources deferred by earlier ticks
+
+        // Think: every pawn's read-only work at once. Act: apply the results pawn by pawn, in index order.
+        std::vector<PawnThought> thoughts(colonists.size());
+        {
+            PROFILE_SCOPE(ProfileCategory::SIM, "Pawn Think");
+            parallelFor(colonists.size(), PAWN_CHUNK_SIZE, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) thoughts[i] = thinkPawn(colonists[i]);
+                });
+        }
+
+        // New: Track which pawns are currently researching.
+        int researchers = 0;
+
+        for (size_t pawnIndex = 0; pawnIndex < colonists.size(); ++pawnIndex) {
+            Pawn& pawn = colonists[pawnIndex];
+            {
+                PROFILE_SCOPE(ProfileCategory::SIM, "Pawn Flee");
+                bool isFleeing = (pawn.currentTask == L"Fleeing");
+                PawnThought& thought = thoughts[pawnIndex];
+                const Critter* closestThreat = (thought.threatIndex != -1) ? &g_critters[thought.threatIndex] : nullptr;
+
+                if (closestThreat) {
+                    // If a threat is found, interrupt everything and flee.
+                    if (!isFleeing) {
+                        pawn.currentTask = L"Fleeing";
+                        // Clear any current path, as fleeing takes priority
+                        pawn.currentPath.clear();
+                        pawn.currentPathIndex = 0;
+                        pawn.ticksStuck = 0;
+
+                        // Drop everything on the current tile
+                        if (!pawn.inventory.empty()) {
+                            for (const auto& item_pair : pawn.inventory) {
+                                for (int i = 0; i < item_pair.second; ++i) {
+                                    addItemToCell(pawn.x, pawn.y, pawn.z, item_pair.first);
+                                }
+                            }
+                            pawn.inventory.clear();
+                        }
+                    }
+
+                    Point3D fleeTarget = fleeTargetFor(pawn, *closestThreat);
+                    pawn.targetX = fleeTarget.x;
+                    pawn.targetY = fleeTarget.y;
+                    pawn.targetZ = fleeTarget.z;
+
+                    // A pawn that just started fleeing takes the path found while thinking; after that the path
+                    // is re-planned through the AI scheduler as the threat keeps moving.
+                    if (!isFleeing) {
+                        pawn.currentPath.swap(thought.fleePath);
+                        pawn.currentPathIndex = 0;
+                    }
+                    else if (!pawn.replanQueued) {
+                        pawn.replanQueued = true;
+                        g_aiDeferredTasks.push_back({ AiTaskType::REPLAN, (int)pawnIndex });
+                    }
+
+                }
+                else if (isFleeing) {
+                    // No more threats nearby, but we were fleeing. Stop fleeing.
+                    pawn.currentTask = L"Idle";
+                    pawn.currentPath.clear();
+                    pawn.currentPathIndex = 0;
+                }
+            }
+
+
+            if (pawn.currentTask == L"Research") {
+                researchers++;
+            }
+
+            if (pawn.isDrafted) {
+                PROFILE_SCOPE(ProfileCategory::SIM, "Pawn Movement");
+                // Drafted pawns follow a direct target set by the player, not pathfinding through jobs.
+                // Their movement is still simple step-by-step.
+                if (pawn.targetX != -1 && (pawn.x != pawn.targetX || pawn.y != pawn.targetY || pawn.z != pawn.targetZ)) {
+                    // Try to move closer (greedy approach for player control)
+                    int moveX = 0, moveY = 0, moveZ = 0;
+                    if (pawn.x < pawn.targetX) moveX = 1; else if (pawn.x > pawn.targetX) moveX = -1;
+                    if (pawn.y < pawn.targetY) moveY = 1; else if (pawn.y > pawn.targetY) moveY = -1;
+                    if (pawn.z < pawn.targetZ) moveZ = 1; else if (pawn.z > pawn.targetZ) moveZ = -1;
+
+                    // Prioritize Z movement if possible through stairs, then XY.
+                    if (moveZ != 0) {
+                        // Check if current tile has a stair to target Z level.
+                        TileType currentTile = Z_LEVELS[pawn.z][pawn.y][pawn.x].type;
+                        if ((moveZ == 1 && currentTile == TileType::STAIR_UP && pawn.z < TILE_WORLD_DEPTH - 1 && Z_LEVELS[pawn.z + 1][pawn.y][pawn.x].type == TileType::STAIR_DOWN) ||
+                            (moveZ == -1 && currentTile == TileType::STAIR_DOWN && pawn.z > 0 && Z_LEVELS[pawn.z - 1][pawn.y][pawn.x].type == TileType::STAIR_UP)) {
+                            pawn.z += moveZ;
+                        }
+                        else { // Cannot move in Z, try XY
+                            int newX = pawn.x + moveX;
+                            int newY = pawn.y + moveY;
+                            if (isWalkable(newX, newY, pawn.z)) {
+                                pawn.x = newX;
+                                pawn.y = newY;
+                            }
+                        }
+                    }
+                    else { // No Z-move needed/possible, just move XY
+                        int newX = pawn.x + moveX;
+                        int newY = pawn.y + moveY;
+                        if (isWalkable(newX, newY, pawn.z)) {
+                            pawn.x = newX;
+                            pawn.y = newY;
+                        }
+                    }
+                }
+                else if (pawn.targetX != -1 && pawn.x == pawn.targetX && pawn.y == pawn.targetY && pawn.z == pawn.targetZ) {
+                    pawn.targetX = -1; pawn.targetY = -1; pawn.targetZ = -1; // Arrived
+                }
+                continue; // Skip job logic for drafted pawns
+            }
+
+            if (pawn.currentTask == L"Idle") {
+                if (gameTicks >= pawn.nextJobSearchTick && !pawn.jobSearchQueued) {
+                    // The search itself runs in the AI scheduler under its per-tick budget; keep wandering meanwhile.
+                    pawn.jobSearchQueued = true;
+                    g_aiDeferredTasks.push_back({ AiTaskType::JOB_SEARCH, (int)pawnIndex });
+                }
+
+                // If still idle after all checks, wander.
+                if (pawn.currentTask == L"Idle") {
+                    if (gameTicks >= pawn.nextWanderTick) {
+                        PROFILE_SCOPE(ProfileCategory::SIM, "Pawn Movement");
+                        pawn.nextWanderTick = gameTicks + randomInt(g_rngPawns) % 60 + 40;
+                        int dx = (randomInt(g_rngPawns) % 3) - 1, dy = (randomInt(g_rngPawns) % 3) - 1;
+                        int newX = pawn.x + dx, newY = pawn.y + dy;
+                        if (isWalkable(newX, newY, pawn.z)) {
+                            pawn.x = newX;
+                            pawn.y = newY;
+                        }
+                    }
+                }
+            } // End of pawn is Idle block
+            else { // Pawn has an active task and should be following its path or performing its action
+                // Check if the pawn has a path to follow
+                if (!pawn.currentPath.empty() && pawn.currentPathIndex < pawn.currentPath.size()) {
+                    PROFILE_SCOPE(ProfileCategory::SIM, "Pawn Movement");
+                    Point3D nextStep = pawn.currentPath[pawn.currentPathIndex];
+
+                    // Check if the next step in the path is still walkable
+                    if (isWalkable(nextStep.x, nextStep.y, nextStep.z)) {
+                        pawn.x = nextStep.x;
+                        pawn.y = nextStep.y;
+                        pawn.z = nextStep.z;
+                        pawn.currentPathIndex++;
+                        pawn.ticksStuck = 0; // Reset stuck counter
+                    }
+                    else {
+                        // Path is blocked, increment stuck counter
+                        pawn.ticksStuck += gameSpeed;
+                        if (pawn.ticksStuck > 100) { // If stuck for too long, re-plan or go idle
+                            pawn.currentTask = L"Idle"; // Abandon current task
+                            pawn.currentPath.clear();
+                            pawn.currentPathIndex = 0;
+                            pawn.ticksStuck = 0;
+                            // Designations are cleared when job is taken, so nothing to clear here usually
+                        }
+                    }
+                }
+                // If pawn arrived at the end of its path (or didn't have one, meaning it's already at the job site)
+                if (pawn.currentPath.empty() || pawn.currentPathIndex >= pawn.currentPath.size()) {
+                    PROFILE_SCOPE(ProfileCategory::SIM, "Pawn Action");
+                    // Reset path state (should be empty already, but for safety)
+                    pawn.currentPath.clear();
+                    pawn.currentPathIndex = 0;
+                    pawn.ticksStuck = 0;
+
+                    // Perform the job action based on pawn's current task
+                    MapCell& cell = Z_LEVELS[pawn.z][pawn.y][pawn.x]; // The cell the pawn is currently on
+
+                    if (pawn.currentTask == JobTypeNames[static_cast<int>(JobType::Deconstruct)]) {
+                        // For deconstruct, the target is the structure itself. Pawn moves ADJACENT, not onto it.
+                        // So, the check `cell.type` needs to be `pawn.targetX/Y/Z` where the structure is.
+                        // However, since we path to an ADJACENT tile, `cell` is the walkable tile the pawn is on.
+                        // We need to find the structure that was designated near this pawn.
+                        TileType deconstructedType = TileType::EMPTY;
+                        // Find designated structure at original job target (pawn.x,y,z is adjacent to it)
+                        // A more robust system might store job location in pawn struct
+                        // For now, let's assume if pawn is on "Deconstruct", it's near a designated structure.
+                        // This simple version assumes the structure is at pawn.targetX,Y,Z from original job assignment
+                        // Since job target is now where pawn paths *to*, this needs reconsideration for adjacency.
+                        // For simplicity, if pawn has a deconstruct task and is AT its path destination,
+                        // we can iterate neighbors to find what to deconstruct.
+                        int deconstructTargetX = -1, deconstructTargetY = -1, deconstructTargetZ = -1;
+                        for (int dz = -1; dz <= 1; ++dz) {
+                            for (int dy = -1; dy <= 1; ++dy) {
+                                for (int dx = -1; dx <= 1; ++dx) {
+                                    if (dx == 0 && dy == 0 && dz == 0) continue;
+                                    int chkX = pawn.x + dx;
+                                    int chkY = pawn.y + dy;
+                                    int chkZ = pawn.z + dz;
+                                    if (chkX >= 0 && chkX < WORLD_WIDTH && chkY >= 0 && chkY < WORLD_HEIGHT && chkZ >= 0 && chkZ < TILE_WORLD_DEPTH) {
+                                        if (isDeconstructable(Z_LEVELS[chkZ][chkY][chkX].type) && designations[chkY][chkX] == L'D') {
+                                            deconstructTargetX = chkX; deconstructTargetY = chkY; deconstructTargetZ = chkZ;
+                                            deconstructedType = Z_LEVELS[chkZ][chkY][chkX].type;
+                                            goto foundDeconstructTarget;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    foundDeconstructTarget:;
+
+                        if (deconstructTargetX != -1) {
+                            MapCell& targetCell = Z_LEVELS[deconstructTargetZ][deconstructTargetY][deconstructTargetX];
+
+                            // Give back some resources (simple version)
+                            if (TILE_DATA.count(deconstructedType)) {
+                                const auto& tags = TILE_DATA.at(deconstructedType).tags;
+                                if (std::find(tags.begin(), tags.end(), TileTag::STRUCTURE) != tags.end()) {
+                                    if (deconstructedType == TileType::WOOD_FLOOR) {
+                                        addItemToCell(deconstructTargetX, deconstructTargetY, deconstructTargetZ, TileType::OAK_WOOD);
+                                    }
+                                    else {
+                                        addItemToCell(deconstructTargetX, deconstructTargetY, deconstructTargetZ, TileType::STONE_CHUNK);
+                                    }
+                                }
+                                else if (std::find(tags.begin(), tags.end(), TileTag::FURNITURE) != tags.end()) {
+                                    addItemToCell(deconstructTargetX, deconstructTargetY, deconstructTargetZ, TileType::OAK_WOOD);
+                                }
+                            }
+
+                            // Handle special cases
+                            if (deconstructedType == TileType::TORCH) {
+                                removeLightSourcesAt(deconstructTargetX, deconstructTargetY, deconstructTargetZ);
+                            }
+                            if (deconstructedType == TileType::STAIR_DOWN && deconstructTargetZ > 0) {
+                                Z_LEVELS[deconstructTargetZ - 1][deconstructTargetY][deconstructTargetX].type = Z_LEVELS[deconstructTargetZ - 1][deconstructTargetY][deconstructTargetX].underlying_type;
+                                markCellDirty(deconstructTargetX, deconstructTargetY, deconstructTargetZ - 1);
+                            }
+                            if (deconstructedType == TileType::STAIR_UP && deconstructTargetZ < TILE_WORLD_DEPTH - 1) {
+                                Z_LEVELS[deconstructTargetZ + 1][deconstructTargetY][deconstructTargetX].type = Z_LEVELS[deconstructTargetZ + 1][deconstructTargetY][deconstructTargetX].underlying_type;
+                                markCellDirty(deconstructTargetX, deconstructTargetY, deconstructTargetZ + 1);
+                            }
+                            if (deconstructedType == TileType::STAIR_DOWN || deconstructedType == TileType::STAIR_UP) markStairGraphDirty();
+                            if (deconstructedType == TileType::BLUEPRINT) {
+                                // Cancel any build jobs for this blueprint if it was a blueprint that was deconstructed
+                                jobQueue.erase(std::remove_if(jobQueue.begin(), jobQueue.end(),
+                                    [&](const Job& job) { return job.type == JobType::Build && job.x == deconstructTargetX && job.y == deconstructTargetY && job.z == deconstructTargetZ; }),
+                                    jobQueue.end());
+                            }
+
+                            // Reset the tile
+                            markCellDirty(deconstructTargetX, deconstructTargetY, deconstructTargetZ);
+                            targetCell.type = targetCell.underlying_type;
+                            targetCell.target_type = TileType::EMPTY;
+                            targetCell.construction_progress = 0;
+                            designations[deconstructTargetY][deconstructTargetX] = L' '; // Clear designation
+                            pawn.currentTask = L"Idle"; // Job complete
+                        }
+                        else {
+                            // No valid target found near pawn, or it was already deconstructed/invalidated
+                            pawn.currentTask = L"Idle"; // Job effectively cancelled
+                        }
+
+                    }
+                    else if (pawn.currentTask == L"Research") {
+                        // Pawn is at research bench location. It stays in this task until research is complete globally.
+                        if (g_currentResearchProject.empty()) {
+                            pawn.currentTask = L"Idle";
+                        } // Else: pawn continues to 'work' on research in global research progress
+                    }
+                    else if (pawn.currentTask == L"Construction") {
+                        // Pawn is at adjacent tile to blueprint. Find the blueprint near it.
+                        TileType blueprintTargetType = TileType::EMPTY;
+                        int blueprintX = -1, blueprintY = -1, blueprintZ = -1;
+                        for (int dz = -1; dz <= 1; ++dz) {
+                            for (int dy = -1; dy <= 1; ++dy) {
+                                for (int dx = -1; dx <= 1; ++dx) {
+                                    if (dx == 0 && dy == 0 && dz == 0) continue;
+                                    int chkX = pawn.x + dx; int chkY = pawn.y + dy; int chkZ = pawn.z + dz;
+                                    if (chkX >= 0 && chkX < WORLD_WIDTH && chkY >= 0 && chkY < WORLD_HEIGHT && chkZ >= 0 && chkZ < TILE_WORLD_DEPTH) {
+                                        if (Z_LEVELS[chkZ][chkY][chkX].type == TileType::BLUEPRINT) {
+                                            blueprintX = chkX; blueprintY = chkY; blueprintZ = chkZ;
+                                            blueprintTargetType = Z_LEVELS[chkZ][chkY][chkX].target_type;
+                                            goto foundBlueprint;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    foundBlueprint:;
+
+                        if (blueprintX != -1) {
+                            MapCell& blueprintCell = Z_LEVELS[blueprintZ][blueprintY][blueprintX];
+                            markCellDirty(blueprintX, blueprintY, blueprintZ);
+                            blueprintCell.construction_progress += gameSpeed * (1 + pawn.skills[L"Construction"] / 5);
+                            if (blueprintCell.construction_progress >= BUILD_WORK_REQUIRED) {
+                                TileType finalType = blueprintCell.target_type;
+                                blueprintCell.type = finalType;
+                                blueprintCell.target_type = TileType::EMPTY;
+                                blueprintCell.construction_progress = 0;
+
+                                if (finalType == TileType::STAIR_DOWN && blueprintZ > 0) { Z_LEVELS[blueprintZ - 1][blueprintY][blueprintX].type = TileType::STAIR_UP; markCellDirty(blueprintX, blueprintY, blueprintZ - 1); }
+                                if (finalType == TileType::STAIR_UP && blueprintZ < TILE_WORLD_DEPTH - 1) { Z_LEVELS[blueprintZ + 1][blueprintY][blueprintX].type = TileType::STAIR_DOWN; markCellDirty(blueprintX, blueprintY, blueprintZ + 1); }
+                                if (finalType == TileType::STAIR_DOWN || finalType == TileType::STAIR_UP) markStairGraphDirty();
+                                if (finalType == TileType::TORCH) addLightSource({ blueprintX, blueprintY, blueprintZ, 30 });
+
+                                pawn.currentTask = L"Idle"; // Job complete
+                            }
+                        }
+                        else {
+                            pawn.currentTask = L"Idle"; // Blueprint disappeared or invalid
+                        }
+
+                    }
+                    else if (pawn.currentTask == L"Mining") {
+                        // Pawn is at adjacent tile to mine designation. Find designation near it.
+                        int mineTargetX = -1, mineTargetY = -1, mineTargetZ = -1;
+                        for (int dz = -1; dz <= 1; ++dz) {
+                            for (int dy = -1; dy <= 1; ++dy) {
+                                for (int dx = -1; dx <= 1; ++dx) {
+                                    if (dx == 0 && dy == 0 && dz == 0) continue;
+                                    int chkX = pawn.x + dx; int chkY = pawn.y + dy; int chkZ = pawn.z + dz;
+                                    if (chkX >= 0 && chkX < WORLD_WIDTH && chkY >= 0 && chkY < WORLD_HEIGHT && chkZ >= 0 && chkZ < TILE_WORLD_DEPTH) {
+                                        if (designations[chkY][chkX] == L'M' && TILE_DATA.at(Z_LEVELS[chkZ][chkY][chkX].type).drops != TileType::EMPTY) {
+                                            mineTargetX = chkX; mineTargetY = chkY; mineTargetZ = chkZ;
+                                            goto foundMineTarget;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    foundMineTarget:;
+
+                        if (mineTargetX != -1) {
+                            MapCell& targetCell = Z_LEVELS[mineTargetZ][mineTargetY][mineTargetX];
+                            addItemToCell(mineTargetX, mineTargetY, mineTargetZ, TILE_DATA.at(targetCell.type).drops);
+                            targetCell.type = targetCell.underlying_type; // Revert to underlying type after mining
+                            markCellDirty(mineTargetX, mineTargetY, mineTargetZ);
+                            designations[mineTargetY][mineTargetX] = L' '; // Clear designation
+                            pawn.currentTask = L"Idle"; // Job complete
+                        }
+                        else {
+                            pawn.currentTask = L"Idle"; // Target disappeared or invalid
+                        }
+
+                    }
+                    else if (pawn.currentTask == JobTypeNames[static_cast<int>(JobType::Chop)]) {
+                        // Pawn has arrived at the spot next to the tree root.
+                        if (pawn.jobTreeId != -1 && a_trees.count(pawn.jobTreeId)) {
+                            fellTree(pawn.jobTreeId, pawn); // This clears all tree parts and designations
+                        }
+                        pawn.currentTask = L"Idle"; // Job complete or tree disappeared
+                        pawn.jobTreeId = -1;
+                    }
+                    else if (pawn.currentTask == L"Gathering Items") {
+                        // Pawn arrived at the source tile (pawn.x,y,z should be pawn.haulSourceX,Y,Z)
+                        MapCell& sourceCell = Z_LEVELS[pawn.haulSourceZ][pawn.haulSourceY][pawn.haulSourceX];
+
+                        TileType gatheringType = TileType::EMPTY;
+                        if (!pawn.inventory.empty()) {
+                            gatheringType = pawn.inventory.begin()->first;
+                        }
+                        else if (!sourceCell.itemsOnGround.empty()) {
+                            gatheringType = sourceCell.itemsOnGround.front();
+                        }
+
+                        // Pick up all matching items from the current tile.
+                        if (gatheringType != TileType::EMPTY) {
+                            for (int i = sourceCell.itemsOnGround.size() - 1; i >= 0; --i) {
+                                if (getTotalItemCount(pawn) < PAWN_INVENTORY_CAPACITY && sourceCell.itemsOnGround[i] == gatheringType) {
+                                    pawn.inventory[gatheringType]++;
+                                    removeItemFromCell(pawn.haulSourceX, pawn.haulSourceY, pawn.haulSourceZ, i); // Keeps stockpiled totals in sync
+                                }
+                            }
+                        }
+
+                        // Now, decide the next action.
+                        if (getTotalItemCount(pawn) >= PAWN_INVENTORY_CAPACITY) {
+                            // We're full, so now we switch to the "Hauling" task to go to the stockpile.
+                            pawn.currentTask = L"Hauling";
+                            // Calculate path to haul destination
+                            pawn.currentPath = findPath({ pawn.x, pawn.y, pawn.z }, { pawn.haulDestX, pawn.haulDestY, pawn.haulDestZ });
+                            pawn.currentPathIndex = 0;
+                        }
+                        else {
+                            // Not full. Ask the item index for the nearest other stacks of the same type
+                            // (5 tiles around the source, adjacent Z-levels included).
+                            bool foundMore = false;
+                            Point3D nextSourceTarget = { -1,-1,-1 };
+                            Point3D searchOrigin = { pawn.haulSourceX, pawn.haulSourceY, pawn.haulSourceZ };
+                            for (const Point3D& candidate : findNearestItemStacks(gatheringType, searchOrigin, 5, 1, 2)) {
+                                if (candidate.x == searchOrigin.x && candidate.y == searchOrigin.y && candidate.z == searchOrigin.z) continue; // Don't check current tile
+                                nextSourceTarget = candidate;
+                                foundMore = true;
+                                break;
+                            }
+
+                            if (foundMore) {
+                                // Found another pile. Set it as the next target to continue gathering.
+                                pawn.haulSourceX = nextSourceTarget.x;
+                                pawn.haulSourceY = nextSourceTarget.y;
+                                pawn.haulSourceZ = nextSourceTarget.z;
+                                // Pathfind to next source tile
+                                pawn.currentPath = findPath({ pawn.x, pawn.y, pawn.z }, nextSourceTarget);
+                                pawn.currentPathIndex = 0;
+                            }
+                            else {
+                                // No more found nearby. Haul what we have.
+                                if (!pawn.inventory.empty()) {
+                                    pawn.currentTask = L"Hauling";
+                                    // Pathfind to haul destination
+                                    pawn.currentPath = findPath({ pawn.x, pawn.y, pawn.z }, { pawn.haulDestX, pawn.haulDestY, pawn.haulDestZ });
+                                    pawn.currentPathIndex = 0;
+                                }
+                                else {
+                                    // We have nothing and found nothing. Job is done, go idle.
+                                    pawn.currentTask = L"Idle";
+                                }
+                            }
+                        }
+                    }
+                    else if (pawn.currentTask == L"Hauling") {
+                        // Pawn arrived at the destination (pawn.x,y,z should be pawn.haulDestX,Y,Z)
+                        MapCell& destCell = Z_LEVELS[pawn.haulDestZ][pawn.haulDestY][pawn.haulDestX]; // Corrected to use haulDest
+                        int destStockpileId = destCell.stockpileId;
+                        TileType itemTypeToDrop = pawn.inventory.empty() ? TileType::EMPTY : pawn.inventory.begin()->first;
+
+                        bool isDestinationValid = false;
+                        if (itemTypeToDrop != TileType::EMPTY && destStockpileId != -1) {
+                            const Stockpile* sp = findStockpileById(destStockpileId);
+                            if (sp && sp->acceptedResources.count(itemTypeToDrop)) {
+                                isDestinationValid = true;
+                            }
+                        }
+
+                        if (isDestinationValid) {
+                            for (auto it = pawn.inventory.begin(); it != pawn.inventory.end();) {
+                                TileType itemType = it->first;
+                                int& count = it->second;
+                                while (count > 0 && destCell.itemsOnGround.size() < MAX_STACK_SIZE) {
+                                    addItemToCell(pawn.haulDestX, pawn.haulDestY, pawn.haulDestZ, itemType); // Counts toward stockpiled totals
+                                    count--;
+                                }
+                                if (count <= 0) it = pawn.inventory.erase(it);
+                                else ++it;
+                            }
+                            pawn.currentTask = L"Idle";
+                        }
+                        else { // Destination no longer valid, find a new one or drop items
+                            int newDestX = -1, newDestY = -1, newDestZ = -1;
+                            bool foundNewDest = false;
+
+                            // Re-run the destination search logic for the item the pawn is holding, on any level,
+                            // keeping the stockpile spot with the cheapest estimated trip.
+                            if (itemTypeToDrop != TileType::EMPTY) {
+                                int bestCost = HAUL_COST_UNREACHABLE;
+                                for (const auto& sp : g_stockpiles) {
+                                    if (sp.acceptedResources.count(itemTypeToDrop)) {
+                                        for (size_t c = 0; c < sp.cells.size(); ++c) {
+                                            const Point3D& p = sp.cells[c];
+                                            const std::vector<TileType>& stack = Z_LEVELS[p.z][p.y][p.x].itemsOnGround;
+                                            // Ensure the new destination cell is walkable and not already full of something else
+                                            if (isWalkable(p.x, p.y, p.z) && (stack.empty() || (stack.size() < MAX_STACK_SIZE && stack.front() == itemTypeToDrop))) {
+                                                int cost = estimateHaulCost({ pawn.x, pawn.y, pawn.z }, p);
+                                                if (cost < bestCost) {
+                                                    bestCost = cost;
+                                                    newDestX = p.x; newDestY = p.y; newDestZ = p.z; foundNewDest = true;
+                                                }
+                                                break; // First usable spot stands in for its stockpile
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+
+                            // If a new destination was found, update the pawn's target and continue hauling.
+                            if (foundNewDest) {
+                                pawn.haulDestX = newDestX;
+                                pawn.haulDestY = newDestY;
+                                pawn.haulDestZ = newDestZ;
+                                // Re-path to the new valid destination
+                                pawn.currentPath = findPath({ pawn.x, pawn.y, pawn.z }, { pawn.haulDestX, pawn.haulDestY, pawn.haulDestZ });
+                                pawn.currentPathIndex = 0;
+                            }
+                            else { // If NO valid destination exists anywhere, drop the items on the ground as a last resort.
+                                for (auto it = pawn.inventory.begin(); it != pawn.inventory.end();) {
+                                    int& count = it->second;
+                                    while (count > 0) { // No stack limit, just dump it all
+                                        addItemToCell(pawn.haulDestX, pawn.haulDestY, pawn.haulDestZ, it->first);
+                                        count--;
+                                    }
+                                    it = pawn.inventory.erase(it);
+                                }
+                                pawn.currentTask = L"Idle";
+                            }
+                        }
+                    }
+                    else { // Any other task ends by simply going idle if path is complete
+                        // For non-hauling, non-building jobs, if we arrived and didn't find a target (e.g. mine was removed)
+                        pawn.currentTask = L"Idle";
+                        // Designations are cleared by the job-specific logic above (mine/chop/deconstruct)
+                    }
+                } // End of arrival at path end
+            } // End of pawn has active task
+        } // End of for each pawn
+
+        // Global research progress update based on number of active researchers.
+        if (!g_currentResearchProject.empty() && researchers > 0) {
+            PROFILE_SCOPE(ProfileCategory::SIM, "Research");
+            float research_speed_bonus = 1.0f;
+            if (g_completedResearch.count(L"WRT")) research_speed_bonus += 0.10f;
+            if (g_completedResearch.count(L"REN_PRP")) research_speed_bonus += 0.25f;
+
+            int total_points_added = 0;
+            for (auto& pawn : colonists) {
+                if (pawn.currentTask == L"Research") {
+                    // Ensure pawn is at the research bench location.
+                    // This is assumed by the pathfinding, but a check might be good.
+                    // For now, any pawn with "Research" task contributes.
+                    total_points_added += (1 + pawn.skills[L"Research"]);
+                }
+            }
+            g_researchProgress += static_cast<int>(total_points_added * gameSpeed * research_speed_bonus);
+
+            const auto& project = g_allResearch.at(g_currentResearchProject);
+            if (g_researchProgress >= project.cost) {
+                updateUnlockedContent(project);
+
+                g_completedResearch.insert(g_currentResearchProject);
+                stopFastForward(L"Research complete: " + project.name);
+                g_currentResearchProject = L"";
+                g_researchProgress = 0;
+                // Any pawns set to "Research" task will become "Idle" in the next tick
+                // as their job target (the research project) is now "complete".
+            }
+        }
+    }
+    if (gameSpeed > 0) profilerEndFrame(ProfileCategory::SIM);
+}
+
+void fellTree(int treeId, const Pawn& chopper) {
+    if (a_trees.find(treeId) == a_trees.end()) return;
+    Tree& tree = a_trees.at(treeId);
+    FallenTree ftree;
+    ftree.treeId = tree.id;
+    ftree.baseType = tree.type;
+    ftree.initialParts = tree.parts;
+    ftree.fallStep = 0;
+
+    // Determine fall direction (opposite of chopper)
+    int dx = tree.rootX - chopper.x;
+    int dy = tree.rootY - chopper.y;
+    if (dx == 0 && dy == 0) { dx = (randomInt(g_rngEvents) % 3) - 1; dy = (randomInt(g_rngEvents) % 3) - 1; if (dx == 0 && dy == 0) dx = 1; } // Fall in random direction if chopper is on the stump
+    ftree.fallDirectionX = (dx > 0) ? 1 : ((dx < 0) ? -1 : 0);
+    ftree.fallDirectionY = (dy > 0) ? 1 : ((dy < 0) ? -1 : 0);
+
+    a_fallingTrees.push_back(ftree);
+
+    // Remove tree from world grid AND CLEAR ALL DESIGNATIONS
+    for (const auto& part : tree.parts) {
+        // This part clears the 2D designation grid
+        if (part.x >= 0 && part.x < WORLD_WIDTH && part.y >= 0 && part.y < WORLD_HEIGHT) {
+            designations[part.y][part.x] = L' ';
+        }
+
+        // This part clears the 3D map cell data
+        if (part.x >= 0 && part.x < WORLD_WIDTH && part.y >= 0 && part.y < WORLD_HEIGHT && part.z >= 0 && part.z < TILE_WORLD_DEPTH) {
+            MapCell& cell = Z_LEVELS[part.z][part.y][part.x];
+            if (cell.tree && cell.tree->id == treeId) {
+                cell.type = cell.underlying_type;
+                cell.tree = nullptr;
+                markCellDirty(part.x, part.y, part.z);
+            }
+        }
+    }
+
+    // The single line that was here before is now handled by the loop above.
+    // designations[tree.rootY][tree.rootX] = L' ';
+    a_trees.erase(treeId);
+}
+void updateFallingTrees() {
+    PROFILE_SCOPE(ProfileCategory::SIM, "updateFallingTrees");
+    for (int i = a_fallingTrees.size() - 1; i >= 0; --i) {
+        FallenTree& ftree = a_fallingTrees[i];
+        ftree.fallStep++;
+
+        bool hasLanded = false;
+        for (const auto& part : ftree.initialParts) {
+            int currentX = part.x + ftree.fallStep * ftree.fallDirectionX;
+            int currentY = part.y + ftree.fallStep * ftree.fallDirectionY;
+            int currentZ = part.z - ftree.fallStep;
+
+            if (currentZ < BIOSPHERE_Z_LEVEL) {
+                hasLanded = true; break;
+            }
+        }
+
+        if (hasLanded || ftree.fallStep > 15) {
+            for (const auto& part : ftree.initialParts) {
+                const auto& partData = TILE_DATA.at(part.type);
+                if (partData.drops != TileType::EMPTY && (std::find(partData.tags.begin(), partData.tags.end(), TileTag::TREE_TRUNK) != partData.tags.end())) {
+                    int finalX = part.x + (ftree.fallStep - 1) * ftree.fallDirectionX;
+                    int finalY = part.y + (ftree.fallStep - 1) * ftree.fallDirectionY;
+                    if (finalX >= 0 && finalX < WORLD_WIDTH && finalY >= 0 && finalY < WORLD_HEIGHT) {
+                        addItemToCell(finalX, finalY, BIOSPHERE_Z_LEVEL, partData.drops);
+                    }
+                }
+            }
+            a_fallingTrees.erase(a_fallingTrees.begin() + i);
+        }
+    }
+}
+// --- State Hash ---
+void hashValue(uint64_t& hash, uint64_t value) {
+    hash = mixRandomSeed(hash, value);
+}
+
+void hashString(uint64_t& hash, const std::wstring& text) {
+    hashValue(hash, text.size());
+    for (wchar_t c : text) hashValue(hash, static_cast<uint64_t>(c));
+}
+
+int stateHashChunkKey(int x, int y, int z) {
+    return (z * STATE_HASH_CHUNKS_Y + y / STATE_HASH_CHUNK_SIZE) * STATE_HASH_CHUNKS_X + x / STATE_HASH_CHUNK_SIZE;
+}
+
+uint64_t hashMapChunk(int key) {
+    int cx = key % STATE_HASH_CHUNKS_X, cy = (key / STATE_HASH_CHUNKS_X) % STATE_HASH_CHUNKS_Y, z = key / (STATE_HASH_CHUNKS_X * STATE_HASH_CHUNKS_Y);
+    uint64_t hash = static_cast<uint64_t>(key); // Keyed, so identical chunks don't cancel out in the XOR
+    for (int y = cy * STATE_HASH_CHUNK_SIZE; y < std::min(WORLD_HEIGHT, (cy + 1) * STATE_HASH_CHUNK_SIZE); ++y) {
+        for (int x = cx * STATE_HASH_CHUNK_SIZE; x < std::min(WORLD_WIDTH, (cx + 1) * STATE_HASH_CHUNK_SIZE); ++x) {
+            const MapCell& cell = Z_LEVELS[z][y][x];
+            hashValue(hash, static_cast<uint64_t>(cell.type));
+            hashValue(hash, static_cast<uint64_t>(cell.underlying_type));
+            hashValue(hash, static_cast<uint64_t>(cell.target_type));
+            hashValue(hash, static_cast<uint64_t>(cell.construction_progress));
+            hashValue(hash, static_cast<uint64_t>(cell.stockpileId));
+            hashValue(hash, static_cast<uint64_t>(cell.tree ? cell.tree->id : -1));
+            hashValue(hash, cell.itemsOnGround.size());
+            for (TileType item : cell.itemsOnGround) hashValue(hash, static_cast<uint64_t>(item));
+        }
+    }
+    return hash;
+}
+
+void markCellDirty(int x, int y, int z) {
+    markLightCellChanged(x, y, z);
+    if (g_simHooks.cellChanged) g_simHooks.cellChanged(x, y, z);
+    markSolidColumnDirty(x, y);
+    MapHashState& state = g_mapHash;
+    if (!state.valid) return; // The next hash rebuilds every chunk anyway
+    int key = stateHashChunkKey(x, y, z);
+    if (state.dirty[key]) return;
+    state.dirty[key] = 1;
+    state.dirtyChunks.push_back(key);
+}
+
+void invalidateMapHash() {
+    g_mapHash.valid = false;
+}
+
+// Rehashes the chunks marked since the last call, or the whole map after world generation.
+uint64_t updateMapHash() {
+    MapHashState& state = g_mapHash;
+    if (!state.valid) {
+        int chunkCount = TILE_WORLD_DEPTH * STATE_HASH_CHUNKS_Y * STATE_HASH_CHUNKS_X;
+        state.chunks.assign(chunkCount, 0);
+        state.dirty.assign(chunkCount, 0);
+        state.dirtyChunks.clear();
+        state.combined = 0;
+        if (!Z_LEVELS.empty()) {
+            for (int key = 0; key < chunkCount; ++key) {
+                state.chunks[key] = hashMapChunk(key);
+                state.combined ^= state.chunks[key];
+            }
+        }
+        state.valid = true;
+        return state.combined;
+    }
+    for (int key : state.dirtyChunks) {
+        state.combined ^= state.chunks[key];
+        state.chunks[key] = hashMapChunk(key);
+        state.combined ^= state.chunks[key];
+        state.dirty[key] = 0;
+    }
+    state.dirtyChunks.clear();
+    return state.combined;
+}
+
+// The map hash from scratch, to catch an edit that forgot to call markCellDirty.
+uint64_t fullMapHash() {
+    uint64_t combined = 0;
+    if (Z_LEVELS.empty()) return combined;
+    int chunkCount = TILE_WORLD_DEPTH * STATE_HASH_CHUNKS_Y * STATE_HASH_CHUNKS_X;
+    for (int key = 0; key < chunkCount; ++key) combined ^= hashMapChunk(key);
+    return combined;
+}
+
+StateHash computeStateHash() {
+    PROFILE_SCOPE(ProfileCategory::SIM, "State Hash");
+    StateHash result;
+    result.tick = gameTicks;
+    result.parts[(int)StateHashPart::MAP] = updateMapHash();
+
+    uint64_t& pawns = result.parts[(int)StateHashPart::PAWNS];
+    for (const Pawn& pawn : colonists) {
+        hashValue(pawns, static_cast<uint64_t>(pawn.x)); hashValue(pawns, static_cast<uint64_t>(pawn.y)); hashValue(pawns, static_cast<uint64_t>(pawn.z));
+        hashString(pawns, pawn.currentTask);
+        hashValue(pawns, static_cast<uint64_t>(pawn.targetX)); hashValue(pawns, static_cast<uint64_t>(pawn.targetY)); hashValue(pawns, static_cast<uint64_t>(pawn.targetZ));
+        hashValue(pawns, pawn.isDrafted);
+        hashValue(pawns, static_cast<uint64_t>(pawn.jobTreeId));
+        hashValue(pawns, static_cast<uint64_t>(pawn.ticksStuck));
+        hashValue(pawns, pawn.currentPath.size()); hashValue(pawns, pawn.currentPathIndex);
+        hashValue(pawns, pawn.inventory.size());
+        for (const auto& item : pawn.inventory) { hashValue(pawns, static_cast<uint64_t>(item.first)); hashValue(pawns, static_cast<uint64_t>(item.second)); }
+    }
+
+    uint64_t& critters = result.parts[(int)StateHashPart::CRITTERS];
+    for (const Critter& critter : g_critters) {
+        hashValue(critters, static_cast<uint64_t>(critter.type));
+        hashValue(critters, static_cast<uint64_t>(critter.x)); hashValue(critters, static_cast<uint64_t>(critter.y)); hashValue(critters, static_cast<uint64_t>(critter.z));
+        hashValue(critters, static_cast<uint64_t>(critter.targetPawnIndex));
+    }
+
+    uint64_t& jobs = result.parts[(int)StateHashPart::JOBS];
+    for (const Job& job : jobQueue) {
+        hashValue(jobs, static_cast<uint64_t>(job.type));
+        hashValue(jobs, static_cast<uint64_t>(job.x)); hashValue(jobs, static_cast<uint64_t>(job.y)); hashValue(jobs, static_cast<uint64_t>(job.z));
+        hashValue(jobs, static_cast<uint64_t>(job.treeId)); hashValue(jobs, static_cast<uint64_t>(job.itemType));
+        hashValue(jobs, static_cast<uint64_t>(job.itemSourceX)); hashValue(jobs, static_cast<uint64_t>(job.itemSourceY)); hashValue(jobs, static_cast<uint64_t>(job.itemSourceZ));
+    }
+    for (const std::wstring& row : designations) hashString(jobs, row);
+    hashString(jobs, g_currentResearchProject);
+    hashValue(jobs, static_cast<uint64_t>(g_researchProgress));
+
+    uint64_t& clock = result.parts[(int)StateHashPart::CLOCK];
+    uint32_t lightBits;
+    memcpy(&lightBits, &currentLightLevel, sizeof(lightBits));
+    hashValue(clock, static_cast<uint64_t>(gameTicks));
+    hashValue(clock, static_cast<uint64_t>(currentWeather));
+    hashValue(clock, static_cast<uint64_t>(temperature));
+    hashValue(clock, static_cast<uint64_t>(currentSeason));
+    hashValue(clock, lightBits);
+
+    uint64_t& random = result.parts[(int)StateHashPart::RANDOM];
+    for (const RandomStream* rng : { &g_rngCritters, &g_rngPawns, &g_rngWeather, &g_rngEvents }) {
+        hashValue(random, rng->state);
+        hashValue(random, rng->inc);
+    }
+    return result;
+}
+
+// --- Headless Runner ---
+// Recognised options: --headless --seed N --biome NAME --colonists N --ticks N --threads N (biome names as in
+// BIOME_DATA, spaces replaced by underscores, e.g. boreal_forest; --threads 1 runs parallel phases serially).
+// Determinism: --determinism (serial vs --threads), --hash-out FILE, --hash-in FILE, --verify-hash, and
+// --ai-quota N for the fixed AI work per tick these runs use in place of the time budget. --replay FILE plays
+// back a command log; --record FILE (without --headless) records the windowed session to one.
+// --fast-forward-check records a run at maximum fast-forward (to the --record file, if given) and replays it.
+HeadlessOptions parseHeadlessOptions(const std::string& commandLine) {
+    HeadlessOptions options;
+    std::istringstream args(commandLine);
+    std::string arg;
+    while (args >> arg) {
+        if (arg == "--headless") options.enabled = true;
+        else if (arg == "--seed") args >> options.seed;
+        else if (arg == "--colonists") args >> options.colonists;
+        else if (arg == "--ticks") args >> options.ticks;
+        else if (arg == "--threads") args >> g_simThreadCount;
+        else if (arg == "--determinism") { options.determinism = true; options.compareSerial = true; }
+        else if (arg == "--hash-out") { args >> options.hashOut; options.determinism = true; }
+        else if (arg == "--hash-in") { args >> options.hashIn; options.determinism = true; }
+        else if (arg == "--verify-hash") { options.verifyHash = true; options.determinism = true; }
+        else if (arg == "--fast-forward-check") { options.fastForwardCheck = true; options.enabled = true; }
+        else if (arg == "--ai-quota") args >> g_aiTaskQuota;
+        else if (arg == "--record") args >> options.recordPath;
+        else if (arg == "--replay") { args >> options.replayPath; options.enabled = true; }
+        else if (arg == "--biome") {
+            std::string name;
+            args >> name;
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return (char)tolower(c); });
+            for (const auto& entry : BIOME_DATA) {
+                std::string biomeName = WStringToString(entry.second.name);
+                std::transform(biomeName.begin(), biomeName.end(), biomeName.begin(), [](unsigned char c) { return c == ' ' ? '_' : (char)tolower(c); });
+                if (biomeName == name && entry.first != Biome::OCEAN) options.biome = entry.first;
+            }
+        }
+    }
+    options.colonists = std::max(1, options.colonists);
+    options.ticks = std::max(1LL, options.ticks);
+    return options;
+}
+
+// Builds a colony the way the setup screens would (minus the planet map).
+void setUpHeadlessColony(const HeadlessOptions& options) {
+    resetWorld();
+    setWorldSeed(options.seed);
+    landingSiteX = PLANET_MAP_WIDTH / 2; landingSiteY = PLANET_MAP_HEIGHT / 2; landingBiome = options.biome;
+    generateFullWorld(landingBiome); spawnInitialCritters();
+    finalStartX = WORLD_WIDTH / 2; finalStartY = WORLD_HEIGHT / 2;
+    colonists.clear();
+    for (int i = 0; i < options.colonists; ++i) colonists.push_back(generatePawn());
+    placeColonists(finalStartX, finalStartY);
+    gameTicks = 3600 * 12;
+    updateTime(); startSimulationTimers();
+}
+
+// Runs updateGame() back to back and prints throughput.
+int runHeadless(const HeadlessOptions& options) {
+    setUpHeadlessColony(options);
+#ifdef PROFILER_ENABLED
+    for (ProfileZone& zone : g_profiler.zones) { zone.totalMicros = 0; zone.calls = 0; }
+#endif
+
+    std::vector<long long> tickMicros;
+    tickMicros.reserve(static_cast<size_t>(options.ticks));
+    auto runStart = std::chrono::steady_clock::now();
+    for (long long i = 0; i < options.ticks; ++i) {
+        auto tickStart = std::chrono::steady_clock::now();
+        updateGame();
+        tickMicros.push_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tickStart).count());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+
+    std::vector<long long> sorted = tickMicros;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](double p) { return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))]; };
+
+    printf("seed %llu, biome %s, %d colonists, %lld ticks, %zu threads\n", (unsigned long long)options.seed, WStringToString(BIOME_DATA[options.biome].name).c_str(), options.colonists, options.ticks, g_workerPool.threads.size() + 1);
+    printf("ticks/s %.1f  p50 %lld us  p99 %lld us  max %lld us\n", options.ticks / std::max(seconds, 1e-9), percentile(0.50), percentile(0.99), sorted.back());
+#ifdef PROFILER_ENABLED
+    std::vector<const ProfileZone*> simZones;
+    for (const ProfileZone& zone : g_profiler.zones) if (zone.category == ProfileCategory::SIM && zone.calls > 0) simZones.push_back(&zone);
+    std::sort(simZones.begin(), simZones.end(), [](const ProfileZone* a, const ProfileZone* b) { return a->totalMicros > b->totalMicros; });
+    for (const ProfileZone* zone : simZones) {
+        printf("  %-18s %10.2f us/tick %12lld calls\n", zone->name, (double)zone->totalMicros / options.ticks, zone->calls);
+    }
+#else
+    printf("  (per-zone timings need a build with COLONY_PROFILER defined)\n");
+#endif
+    printf("critters %zu, jobs queued %zu\n", g_critters.size(), jobQueue.size());
+    fflush(stdout);
+    return 0;
+}
+
+// Runs a fresh colony for options.ticks ticks and hashes the state after each one.
+std::vector<StateHash> recordStateHashes(const HeadlessOptions& options) {
+    setUpHeadlessColony(options);
+    std::vector<StateHash> hashes;
+    hashes.reserve(static_cast<size_t>(options.ticks));
+    for (long long i = 0; i < options.ticks; ++i) {
+        updateGame();
+        hashes.push_back(computeStateHash());
+        if (options.verifyHash && fullMapHash() != hashes.back().parts[(int)StateHashPart::MAP]) {
+            printf("tick %lld: incremental map hash disagrees with a full rehash (a cell edit skipped markCellDirty)\n", gameTicks);
+        }
+    }
+    return hashes;
+}
+
+// One line per tick: the tick, then each part's hash in StateHashPart order, in hex.
+void writeStateHashes(const std::string& path, const std::vector<StateHash>& hashes) {
+    std::ofstream file(path);
+    for (const StateHash& hash : hashes) {
+        file << hash.tick << std::hex;
+        for (uint64_t part : hash.parts) file << ' ' << part;
+        file << std::dec << '\n';
+    }
+}
+
+bool readStateHashes(const std::string& path, std::vector<StateHash>& hashes) {
+    std::ifstream file(path);
+    if (!file) return false;
+    StateHash hash;
+    while (file >> hash.tick >> std::hex) {
+        for (uint64_t& part : hash.parts) file >> part;
+        file >> std::dec;
+        if (!file) return false;
+        hashes.push_back(hash);
+    }
+    return true;
+}
+
+// Prints the first tick where the two logs disagree and which parts differ there. Returns true if they agree.
+bool reportFirstDivergence(const std::vector<StateHash>& expected, const char* expectedName, const std::vector<StateHash>& actual, const char* actualName) {
+    size_t count = std::min(expected.size(), actual.size());
+    for (size_t i = 0; i < count; ++i) {
+        std::string parts;
+        if (expected[i].tick != actual[i].tick) parts = "tick counter";
+        for (int part = 0; part < (int)StateHashPart::COUNT; ++part) {
+            if (expected[i].parts[part] == actual[i].parts[part]) continue;
+            if (!parts.empty()) parts += ", ";
+            parts += STATE_HASH_PART_NAMES[part];
+        }
+        if (!parts.empty()) {
+            printf("%s vs %s: first divergence at tick %lld (step %zu): %s\n", expectedName, actualName, expected[i].tick, i + 1, parts.c_str());
+            return false;
+        }
+    }
+    if (expected.size() != actual.size()) {
+        printf("%s vs %s: identical for %zu ticks, but one log has %zu and the other %zu\n", expectedName, actualName, count, expected.size(), actual.size());
+        return false;
+    }
+    printf("%s vs %s: identical for %zu ticks\n", expectedName, actualName, count);
+    return true;
+}
+
+// Hashes a run on the pool started for --threads and checks it against a serial run and/or a recorded log.
+// Returns 0 when every comparison agrees.
+int runDeterminismCheck(const HeadlessOptions& options) {
+    if (g_aiTaskQuota <= 0) g_aiTaskQuota = DETERMINISM_AI_TASK_QUOTA;
+    int threads = (int)g_workerPool.threads.size() + 1;
+    printf("seed %llu, biome %s, %d colonists, %lld ticks, %d threads, AI quota %d\n", (unsigned long long)options.seed, WStringToString(BIOME_DATA[options.biome].name).c_str(), options.colonists, options.ticks, threads, g_aiTaskQuota);
+
+    bool agree = true;
+    std::vector<StateHash> hashes = recordStateHashes(options);
+    if (options.compareSerial) {
+        startWorkerPool(1);
+        std::vector<StateHash> serial = recordStateHashes(options);
+        startWorkerPool(threads);
+        std::string parallelName = std::to_string(threads) + " threads";
+        agree = reportFirstDivergence(serial, "1 thread", hashes, parallelName.c_str()) && agree;
+    }
+    if (!options.hashIn.empty()) {
+        std::vector<StateHash> recorded;
+        if (!readStateHashes(options.hashIn, recorded)) {
+            printf("could not read hash log %s\n", options.hashIn.c_str());
+            agree = false;
+        }
+        else {
+            agree = reportFirstDivergence(recorded, options.hashIn.c_str(), hashes, "this build") && agree;
+        }
+    }
+    if (!options.hashOut.empty()) writeStateHashes(options.hashOut, hashes);
+    fflush(stdout);
+    return agree ? 0 : 1;
+}
+
+void stopFastForward(const std::wstring& reason) {
+    if (g_fastForwardMode != FastForwardMode::UNTIL_EVENT) return;
+    g_fastForwardMode = FastForwardMode::OFF;
+    g_fastForwardStopReason = reason;
+}
+
@@ -0,0 +1,821 @@
+#pragma once
+// --- Simulation ---
+// The world and everything that runs it: static game data, world generation, the tick (updateGame and the systems
+// it drives), pathfinding, the state hash and the headless runner. Nothing here touches Win32, so the same code
+// builds into the game, into ColonySimHeadless and into the CMake build on any platform. main.cpp owns the window,
+// input, rendering and UI state; caches of its own that follow the map hear about edits through g_simHooks.
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Colours are Win32 uint32_t values (0x00BBGGRR) held as plain integers; makeColor() builds one the way RGB() does.
+inline uint32_t makeColor(int r, int g, int b) {
+    return (uint32_t)(r & 0xff) | ((uint32_t)(g & 0xff) << 8) | ((uint32_t)(b & 0xff) << 16);
+}
+// A rectangle of map cells, laid out like a Win32 RECT.
+struct CellRect {
+    int left, top, right, bottom;
+};
+
+// --- Pathfinding & Navigation ---
+// (This Point3D struct should be above initGameData, as it's used in global contexts)
+struct Point3D {
+    int x, y, z;
+    // NEW: Define operator< for Point3D to allow its use in std::set and other sorted containers.
+    bool operator<(const Point3D& other) const {
+        if (z != other.z) return z < other.z;
+        if (y != other.y) return y < other.y;
+        return x < other.x;
+    }
+};
+
+// NEW: Define a Point2D struct for 2D coordinate handling where comparison is needed
+// This will be used in the 'spread_ore' function.
+struct Point2D {
+    int x, y; // Changed from long to int for consistency with game coordinates
+
+    // Define operator< for Point2D for use in std::set (still needed if you use Point2D in std::map keys elsewhere, but not for this specific visited optimization)
+    bool operator<(const Point2D& other) const {
+        if (y != other.y) return y < other.y; // Compare by y first
+        return x < other.x; // Then by x
+    }
+};
+
+// --- Tile, Tag, & Biome System ---
+enum class TileTag {
+    NONE, STONE, TREE_PART, DIRT, WATER, MINERAL, SOIL,
+    SEDIMENTARY, IGNEOUS_INTRUSIVE, IGNEOUS_EXTRUSIVE, METAMORPHIC, INNER_STONE,
+    WOOD, ITEM, CHUNK, FLUID,
+    TREE_TRUNK, TREE_BRANCH, TREE_LEAF, CACTUS_PART,
+    STRUCTURE, FURNITURE, LIGHTS, PRODUCTION,
+    BLUEPRINT_TAG,
+    STOCKPILE_ZONE,
+    METAL, ORE,
+    SECURITY // NEW
+};
+enum class TileType {
+    EMPTY, DIRT_FLOOR, GRASS, SAND, SNOW, ICE, STONE_FLOOR, WOOD_FLOOR,
+    JUNGLE_GRASS,
+    // Stones
+    CHALK, CHERT, CLAYSTONE, CONGLOMERATE, DOLOMITE, LIMESTONE, MUDSTONE, ROCK_SALT, SANDSTONE, SHALE, SILTSTONE,
+    DIORITE, GABBRO, GRANITE, ANDESITE, BASALT, DACITE, OBSIDIAN, RHYOLITE,
+    GNEISS, MARBLE, PHYLLITE, QUARTZITE, SCHIST, SLATE,
+    CORESTONE, WATER, MOLTEN_CORE, RICH_MINERALS,
+    // Tree/Cactus Base Types (for generation logic)
+    OAK, ACACIA, SPRUCE, BIRCH, PINE, POPLAR, CECROPIA,
+    COCOA, CYPRESS, MAPLE, PALM, TEAK, SAGUARO, PRICKLYPEAR, CHOLLA,
+    // --- Tree & Cactus Parts ---
+    // Generic
+    TRUNK, BRANCH, LEAF,
+    // Oak
+    OAK_TRUNK, OAK_BRANCH, OAK_LEAF,
+    // Acacia
+    ACACIA_TRUNK, ACACIA_BRANCH, ACACIA_LEAF,
+    // Spruce
+    SPRUCE_TRUNK, SPRUCE_BRANCH, SPRUCE_NEEDLE,
+    // Birch
+    BIRCH_TRUNK, BIRCH_BRANCH, BIRCH_LEAF,
+    // Pine
+    PINE_TRUNK, PINE_BRANCH, PINE_NEEDLE,
+    // Poplar
+    POPLAR_TRUNK, POPLAR_BRANCH, POPLAR_LEAF,
+    // Cecropia
+    CECROPIA_TRUNK, CECROPIA_BRANCH, CECROPIA_LEAF,
+    // Cocoa
+    COCOA_TRUNK, COCOA_BRANCH, COCOA_LEAF,
+    // Cypress
+    CYPRESS_TRUNK, CYPRESS_BRANCH, CYPRESS_FOLIAGE,
+    // Maple
+    MAPLE_TRUNK, MAPLE_BRANCH, MAPLE_LEAF,
+    // Palm
+    PALM_TRUNK, PALM_FROND,
+    // Teak
+    TEAK_TRUNK, TEAK_BRANCH, TEAK_LEAF,
+    // Saguaro
+    SAGUARO_TRUNK, SAGUARO_ARM,
+    // Prickly Pear
+    PRICKLYPEAR_PAD, PRICKLYPEAR_TUNA,
+    // Cholla
+    CHOLLA_TRUNK, CHOLLA_JOINT,
+    // --- Resources on ground ---
+    /// Stone Chunks
+    STONE_CHUNK,
+    CHALK_CHUNK, CHERT_CHUNK, CLAYSTONE_CHUNK, CONGLOMERATE_CHUNK, DOLOMITE_CHUNK, LIMESTONE_CHUNK, MUDSTONE_CHUNK,
+    ROCK_SALT_CHUNK, SANDSTONE_CHUNK, SHALE_CHUNK, SILTSTONE_CHUNK, DIORITE_CHUNK, GABBRO_CHUNK, GRANITE_CHUNK,
+    ANDESITE_CHUNK, BASALT_CHUNK, DACITE_CHUNK, OBSIDIAN_CHUNK, RHYOLITE_CHUNK, GNEISS_CHUNK, MARBLE_CHUNK,
+    PHYLLITE_CHUNK, QUARTZITE_CHUNK, SCHIST_CHUNK, SLATE_CHUNK, CORESTONE_CHUNK,
+    /// Woods
+    OAK_WOOD, ACACIA_WOOD, SPRUCE_WOOD, BIRCH_WOOD, PINE_WOOD, POPLAR_WOOD, CECROPIA_WOOD,
+    COCOA_WOOD, CYPRESS_WOOD, MAPLE_WOOD, PALM_WOOD, TEAK_WOOD, SAGUARO_WOOD, PRICKLYPEAR_WOOD, CHOLLA_WOOD,
+    /// Metals
+    COPPER_METAL, TIN_METAL, NICKEL_METAL, ZINC_METAL, IRON_METAL, LEAD_METAL,
+    SILVER_METAL, TUNGSTEN_METAL, GOLD_METAL, PLATINUM_METAL, ALUMINUM_METAL,
+    CHROMIUM_METAL, BISMUTH_METAL, RHODIUM_METAL, OSMIUM_METAL, IRIDIUM_METAL,
+    COBALT_METAL, PALLADIUM_METAL, MITHRIL_METAL, ORICHALCUM_METAL, ADAMANTIUM_METAL, TITANIUM_METAL,
+    /// Ores
+    BISMUTHINITE_ORE, CASSITERITE_ORE, NATIVE_COPPER_ORE, GALENA_ORE, GARNIERITE_ORE,
+    NATIVE_GOLD_ORE, HEMATITE_ORE, HORN_SILVER_ORE, LIMONITE_ORE, MAGNETITE_ORE,
+    MALACHITE_ORE, NATIVE_PLATINUM_ORE, NATIVE_SILVER_ORE, SPHALERITE_ORE, TETRAHEDRITE_ORE,
+    NATIVE_ALUMINUM_ORE, ADAMANTITE_ORE, WOLFRAMITE_ORE, SPERRYLITE_ORE, IRIDOSMINE_ORE,
+    COBALTITE_ORE, PALLADINITE_ORE, MITHRITE_ORE, ORICALCITE_ORE, RUTILE_ORE,
+    // --- Architect Placeables ---
+    BLUEPRINT,
+    GROWING_ZONE, HYDROPONICS_BASIN,
+    WALL, STONE_WALL, ACOUSTIC_WALL_ITEM,
+    COLUMN,
+    STAIR_UP, STAIR_DOWN,
+    BLACKBOARD_FURNITURE, SCHOOL_CHAIR_FURNITURE, SCHOOL_DESK_FURNITURE,
+    HOSPITAL_BED,
+    TORCH,
+    ELECTRIC_LAMP,
+    CHAIR, TABLE,
+    RESEARCH_BENCH, ADVANCED_RESEARCH_BENCH,
+    MINE_SHAFT,
+    CARPENTRY_WORKBENCH, STONECUTTING_TABLE, SMITHY, BLAST_FURNACE, COINING_MILL,
+    DRUG_LAB, PRINTING_PRESS_FURNITURE, TYPEWRITER,
+    WINDMILL, WIND_TURBINE,
+    ASSEMBLY_LINE,
+    THEATRE_STAGE,
+    TELESCOPE_FURNITURE, RADIO_FURNITURE, COMPUTER_FURNITURE,
+    LIGHTHOUSE_BUILDING,
+    SERVER, SWITCH, ROUTER,
+
+
+    // Melee Weapon
+    KNIGHT_WEAPON,
+
+
+    // Ranged Weapon
+    BOW, ARROW,
+
+
+
+    // Tools/Items/Apparel
+    PICKAXE, COMPASS_ITEM,
+
+
+    // Security 
+    SPIKE_TRAP,
+
+    // Vehicles
+    RAFT, BOAT_ITEM,
+
+
+
+
+
+    // Resources
+    WHEEL, COIN, LENS, GUNPOWDER_ITEM, WIRE, LIGHTBULB,
+
+
+    // Apparel    
+    GLASSES, KNIGHT_ARMOR,
+
+
+    // Devices
+    SMARTPHONE, TABLET, SMARTWATCH,
+    MOUSE, SCREEN, KEYBOARD, // NEW
+
+
+    // Chemicals
+    CHEMICALS_ITEM,
+
+
+
+
+    // Drugs    
+    DRUGS_ITEM,
+
+};
+
+enum class CritterTag {
+    // Main Groups
+    NONE, MAMMAL, MARINE_MAMMAL, BIRD, INSECT, RODENT, REPTILE, ARACHNID,
+    CRUSTACEAN, CNIDARIAN, AMPHIBIAN, FISH, CRYPTID, YOUKAI, MYTHICAL,
+    BEAST, MEGAFAUNA, CELESTIAL, DEMON, ABERRATION, ENTITY,
+
+    // Sub-Tags
+    LIVESTOCK, DOMESTIC, UNDEAD, PRIMATE, HUMANOID, MARSUPIAL, MOLLUSK,
+    ANNELID, DINOSAUR, DRAGONOID, FAE, CONSTRUCT, CHIMERA, GIANT, PLANTFOLK,
+    CHIROPTERA, CETACEAN, MUSTELID, PACHYDERM,
+
+    // Sub-Sub-Tags (Behavior/Attribute)
+    PREDATOR, VERMIN, SCAVENGER, FLYING, AQUATIC, VENOMOUS, NOCTURNAL,
+    MIGRATORY, PARASITIC, PACK_ANIMAL, BURROWING, DIURNAL, SWARMING, PARTHENOGENIC,
+    SYNTHETIC, MUTATED, MOUNT,
+};
+
+
+enum class CritterType {
+    // Mammals
+    DEER, WOLF, PIG, COW, SHEEP, GOAT, CAT, DOG, MONKEY, KANGAROO, BEAR,
+    // Marine Mammals
+    DOLPHIN, WHALE,
+    // Birds
+    PIGEON, HAWK,
+    // Insects
+    BUTTERFLY, BEETLE,
+    // Rodents
+    RAT, SQUIRREL,
+    // Reptiles
+    SNAKE, LIZARD,
+    // Arachnids
+    SPIDER,
+    // Crustaceans
+    CRAB,
+    // Fish
+    TROUT, TUNA,
+    // Undead
+    ZOMBIE, SKELETON,
+    // Mythical
+    GRIFFIN,
+    // Dragonoid
+    WYVERN
+};
+
+struct TileData {
+    std::wstring name;
+    wchar_t character;
+    uint32_t color;
+    std::vector<TileTag> tags;
+    TileType drops;
+    float hardness;
+    float value;
+    TileType display_trunk_type = TileType::EMPTY;
+    std::wstring symbol;
+};
+extern std::map<TileType, TileData> TILE_DATA;
+
+enum class Biome { OCEAN, TUNDRA, BOREAL_FOREST, TEMPERATE_FOREST, JUNGLE, DESERT };
+struct BiomeData { std::wstring name; uint32_t mapColor; };
+extern std::map<Biome, BiomeData> BIOME_DATA;
+extern Biome landingBiome;
+
+// --- Simulation Hooks ---
+// main.cpp keeps caches and selections that follow the simulation (the minimap texture, the stockpile being
+// configured). Each hook is optional and runs on whichever thread changed the world.
+struct SimulationHooks {
+    void (*cellChanged)(int x, int y, int z) = nullptr; // Every markCellDirty call
+    void (*mapReplaced)() = nullptr;                    // generateFullWorld or resetWorld swapped the whole map
+    void (*stockpileRemoved)(int slot) = nullptr;       // g_stockpiles[slot] was erased; later slots moved down one
+};
+extern SimulationHooks g_simHooks;
+
+// --- Fast-Forward ---
+// Fast-forward runs whole ticks back to back instead of scaling deltas by gameSpeed (the simulation thread in
+// main.cpp paces it); UNTIL_EVENT drops back to normal speed on the next event worth looking at.
+enum class FastForwardMode { OFF, MAX, UNTIL_EVENT };
+extern FastForwardMode g_fastForwardMode;
+extern std::wstring g_fastForwardStopReason; // Why UNTIL_EVENT last stopped
+
+// --- Random Streams ---
+// All randomness comes from PCG32 streams derived from one world seed. Long-lived subsystems own a stream
+// each, so one drawing more numbers never shifts another's sequence; world generation derives a fresh stream
+// per step (and per Z-level), so the same seed and landing site always rebuild the same map.
+struct RandomStream {
+    uint64_t state = 0x853c49e6748fea9bULL;
+    uint64_t inc = 0xda3e39cb94b95bdbULL; // Must stay odd
+};
+enum class RandomStreamId : uint64_t {
+    CRITTERS = 1, PAWNS, WEATHER, EVENTS,
+    SOLAR_SYSTEM, DISTANT_STARS, PLANET_MAP, CONTINENT_NAME,
+    SURFACE, LEVEL_STRATA, LEVEL_CAVES, LEVEL_ORES
+};
+extern uint64_t g_worldSeed;
+extern RandomStream g_rngCritters; // Spawns and critter movement
+extern RandomStream g_rngPawns;    // Pawn generation and pawn decisions
+extern RandomStream g_rngWeather;
+extern RandomStream g_rngEvents;   // Undead raids, falling trees
+// Counter-based draws: the n-th number for a key is a pure function of (key, n), so work spread over threads
+// draws exactly the numbers a serial run would, whatever order the threads finish in.
+struct CounterRandom {
+    uint64_t key;
+    uint64_t counter = 0;
+};
+
+// --- Time, Season, Weather & Lighting ---
+extern long long gameTicks;
+extern int gameHour, gameMinute, gameSecond, gameDay, gameMonth, gameYear;
+extern bool isFullMoon;
+enum class Season { SPRING, SUMMER, AUTUMN, WINTER };
+const std::vector<std::wstring> SeasonNames = { L"Spring", L"Summer", L"Autumn", L"Winter" };
+const std::vector<std::wstring> MonthNames = { L"March", L"April", L"May", L"June", L"July", L"August", L"September", L"October", L"November", L"December", L"January", L"February" };
+extern Season currentSeason;
+enum class Weather { CLEAR, RAINING, SNOWING }; extern Weather currentWeather;
+extern int temperature;
+enum class TimeOfDay { DAWN, MORNING, MIDDAY, AFTERNOON, EVENING, DUSK, NIGHT, MIDNIGHT };
+extern TimeOfDay currentTimeOfDay;
+extern float currentLightLevel;
+struct LightSource { int x, y, z, radius; };
+extern std::vector<LightSource> g_lightSources; // Change through addLightSource/removeLightSourcesAt so the light maps follow
+
+// --- Light Maps ---
+// Torch light per Z-level, so drawing reads one value per cell instead of measuring the distance to every light.
+// Each cell holds the brightest contribution any light gives it (1 at the torch, falling to 0 at its radius),
+// with walls, rock and tree trunks casting shadows. Adding or removing a light marks that light's square stale;
+// changing a cell a light reaches queues the cell, and if it has since turned opaque or clear the next frame marks
+// the lights around it stale too. Each frame recomputes only the stale squares.
+const uint8_t LIGHT_CELL_QUEUED = 0x80; // Flag in seen: the cell is in changed
+struct LightMapLevel {
+    std::vector<float> level;  // WORLD_WIDTH * WORLD_HEIGHT; empty until a light touches this Z-level
+    std::vector<uint8_t> seen; // Opacity a light last found in each cell: 0 never looked, 1 clear, 2 opaque
+    std::vector<int> changed;  // Cells to re-check against seen, as y * WORLD_WIDTH + x
+    std::vector<CellRect> stale; // Inclusive cell rectangles to recompute
+};
+extern std::vector<LightMapLevel> g_lightMaps; // Indexed by z
+extern bool g_lightShadows; // Shift+F9 in debug mode falls back to plain radius falloff
+// Solid column index: per (x, y) column, one bit per Z-level set where the cell is not EMPTY, so the first solid
+// cell under any Z is a bit scan. markCellDirty only flags the column, since callers mark cells both before and
+// after changing them; flagged columns are re-read from the map before the next frame.
+struct SolidColumnIndex {
+    bool valid = false; // False until the first update after world generation; then kept up by dirty columns
+    int words = 0;      // uint64_t words per column
+    std::vector<uint64_t> bits; // (y * WORLD_WIDTH + x) * words + z / 64
+    std::vector<char> dirty;
+    std::vector<int> dirtyColumns;
+};
+extern SolidColumnIndex g_solidColumns;
+const float SEE_THROUGH_SHADE_PER_LEVEL = 0.85f; // Brightness kept per Z-level looked down through
+const float SEE_THROUGH_MIN_SHADE = 0.25f;       // Floor, so the surface stays readable from the top of the sky
+const int HOUR_SLOWNESS_FACTOR = 2;
+const long long BASE_TICKS_PER_DAY = 24LL * 60 * 60;
+const long long TICKS_PER_DAY = BASE_TICKS_PER_DAY * HOUR_SLOWNESS_FACTOR;
+extern int TROPOSPHERE_TOP_Z_LEVEL;
+
+// -- Undead Invasion State --
+const long long UNDEAD_SPAWN_INTERVAL = TICKS_PER_DAY / 2; // Check twice per day
+const int UNDEAD_SPAWN_CHANCE_PER_1000 = 5; // 0.5% chance per check
+const int ZOMBIE_SENSE_RADIUS = 25; // Zombies close in on any pawn nearer than this
+
+// -- Periodic Systems --
+const size_t MAX_CRITTERS = 4096; // Critter moves are decided in parallel (see runCritterMoves)
+const long long CRITTER_SPAWN_INTERVAL = TICKS_PER_DAY / 48; // Every 30 in-game minutes
+const long long HAUL_SCAN_INTERVAL = 100;
+
+// --- Timer Wheel ---
+// Everything that only needs attention every so often (weather, spawn rolls, haul scans, each critter's next
+// move) registers the gameTicks value it is next due at. Events wait in a hierarchical wheel: level L has
+// TIMER_WHEEL_SLOTS slots of TIMER_WHEEL_SLOTS^L ticks each and drops its slot one level down when time reaches
+// it, so each tick only looks at one slot and the cost of a tick follows the number of due events.
+enum class TimerKind { WEATHER_CHANGE, CRITTER_SPAWN, UNDEAD_SPAWN, HAUL_SCAN, CRITTER_MOVE };
+struct TimerEvent {
+    long long dueTick;
+    TimerKind kind;
+    int target; // Critter index for CRITTER_MOVE, unused otherwise
+};
+const int TIMER_WHEEL_SLOT_BITS = 6;
+const int TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_SLOT_BITS;
+const int TIMER_WHEEL_LEVELS = 3; // Covers 64^3 = 262144 ticks; anything further waits in the overflow list
+struct TimerWheel {
+    long long currentTick = 0; // Last tick whose events have fired
+    std::vector<TimerEvent> slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    std::vector<TimerEvent> overflow;
+};
+extern TimerWheel g_timerWheel;
+// --- AI Scheduler ---
+// Expensive AI work (idle-pawn job searches, flee re-plans, haul scan sources) is queued rather than run inline
+// and paid off each tick within g_aiBudgetMicros, oldest request first, so many pawns going idle at once
+// spreads over a few ticks instead of stalling one.
+enum class AiTaskType { JOB_SEARCH, REPLAN };
+struct AiTask {
+    AiTaskType type;
+    int pawnIndex;
+};
+extern std::deque<AiTask> g_aiDeferredTasks;
+const size_t AI_TASK_BATCH = 16; // Tasks thought through together; fixed so results never depend on the thread count
+extern int g_aiBudgetMicros;
+extern int g_aiTaskQuota; // When > 0: exactly this many tasks and haul sources per tick instead of a time budget
+struct HaulScanState {
+    bool active = false;
+    std::vector<Point3D> sources; // Snapshot taken when the scan started, in (z, y, x) order
+    size_t next = 0;
+};
+extern HaulScanState g_haulScan;
+struct AiSchedulerStats {
+    long long lastTickMicros = 0;
+    int tasksRun = 0;
+    int haulSourcesScanned = 0;
+};
+extern AiSchedulerStats g_aiStats;
+
+// --- Worker Pool ---
+// A fixed set of threads for data-parallel sim phases. parallelFor() deals out fixed-size chunks from a shared
+// counter, so whichever thread is free takes the next chunk; the calling thread works too and returns once every
+// chunk is done. Work items may read shared state but must write only their own output slot.
+struct WorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::function<void(size_t, size_t)> job; // Runs items [begin, end)
+    size_t itemCount = 0;
+    size_t chunkSize = 1;
+    std::atomic<size_t> nextChunk{ 0 };
+    size_t busyWorkers = 0;
+    unsigned long long generation = 0;
+    bool stopping = false;
+};
+extern WorkerPool g_workerPool;
+extern int g_simThreadCount; // Threads sharing parallel sim work, caller included; 0 picks one per hardware thread
+
+// --- Profiler ---
+// PROFILE_SCOPE(category, name) times the rest of the enclosing block into a named zone. Each zone keeps a rolling
+// window of per-frame totals (a frame is one sim tick or one paint, by category) for the F11 debug overlay, and
+// Shift+F11 records every scope until pressed again, then writes profile_trace.json for chrome://tracing.
+// Sim zones are timed on the simulation thread and render zones on the window thread, so everything in Profiler
+// is read and written under its mutex. Only debug builds, or builds defining COLONY_PROFILER, compile the timers
+// in; elsewhere the macro is empty.
+#if defined(_DEBUG) || defined(COLONY_PROFILER)
+#define PROFILER_ENABLED 1
+#endif
+enum class ProfileCategory { SIM, RENDER };
+#ifdef PROFILER_ENABLED
+const int PROFILE_HISTORY = 120;
+const size_t PROFILE_TRACE_MAX_EVENTS = 1000000; // ~24 MB; capture stops growing past this
+struct ProfileZone {
+    const char* name;
+    ProfileCategory category;
+    long long frameMicros = 0; // Accumulated since the category's last frame ended
+    long long totalMicros = 0;
+    long long calls = 0;
+    long long history[PROFILE_HISTORY] = {};
+    int historyNext = 0;
+    int historyCount = 0;
+};
+struct ProfileTraceEvent {
+    int zone;
+    long long startMicros;
+    long long durationMicros;
+};
+struct Profiler {
+    std::mutex mutex;
+    std::vector<ProfileZone> zones;
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    bool capturing = false;
+    std::vector<ProfileTraceEvent> trace;
+};
+extern Profiler g_profiler;
+int registerProfileZone(ProfileCategory category, const char* name);
+struct ProfileScope {
+    int zone;
+    std::chrono::steady_clock::time_point start;
+    explicit ProfileScope(int zoneId) : zone(zoneId), start(std::chrono::steady_clock::now()) {}
+    ~ProfileScope();
+};
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(category, name) \
+    static const int PROFILE_CONCAT(profileZone_, __LINE__) = registerProfileZone(category, name); \
+    ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(PROFILE_CONCAT(profileZone_, __LINE__))
+#else
+#define PROFILE_SCOPE(category, name) ((void)0)
+#endif
+
+// --- Headless Runner ---
+// `--headless` on the command line runs a fixed-seed colony for a set number of ticks without creating a window
+// and prints tick throughput, so performance changes can be compared run to run. Profiler builds add each sim
+// zone's average cost per tick. The determinism options instead hash the state after every tick and report the
+// first tick at which two runs (serial and parallel, or this build and a recorded log) stop agreeing.
+struct HeadlessOptions {
+    bool enabled = false;
+    uint64_t seed = 1;
+    Biome biome = Biome::TEMPERATE_FOREST;
+    int colonists = 3;
+    long long ticks = 36000;
+    bool determinism = false;   // Hash every tick instead of timing
+    bool compareSerial = false; // Also run on one thread and compare against it
+    bool verifyHash = false;    // Check the incremental map hash against a full rehash every tick
+    bool fastForwardCheck = false; // Record a fast-forward run, replay it and compare the two
+    std::string hashIn, hashOut; // Hash log to compare against / to write
+    std::string recordPath;      // Windowed sessions: command log to write
+    std::string replayPath;      // Command log to replay instead of running a fresh colony
+};
+const int DETERMINISM_AI_TASK_QUOTA = 64;
+
+// Critter Data
+struct CritterData {
+    std::wstring name;
+    wchar_t character;
+    uint32_t color;
+    std::vector<CritterTag> tags;
+    int wander_speed; // Ticks between moves
+};
+
+struct Critter {
+    CritterType type;
+    int x, y, z;
+    int wanderCooldown; // Ticks until the first move; later moves are booked on the timer wheel
+    int targetPawnIndex = -1;
+};
+struct CritterStep {
+    Critter critter; // The critter as it will be once the move is committed
+    int nextMoveDelay;
+};
+const size_t CRITTER_CHUNK_SIZE = 64;
+extern std::map<CritterType, CritterData> g_CritterData;
+extern std::map<CritterTag, std::wstring> g_CritterTagNames;
+extern std::vector<Critter> g_critters;
+extern std::map<Biome, std::vector<CritterType>> g_BiomeCritters;
+
+// --- Z-Layer System ---
+enum class Stratum {
+    INNER_CORE, OUTER_CORE, LOWER_MANTLE, UPPER_MANTLE, ASTHENOSPHERE, LITHOSPHERE, CRUST,
+    HYDROSPHERE, BIOSPHERE, ATMOSPHERE,
+    TROPOSPHERE, STRATOSPHERE, MESOSPHERE, THERMOSPHERE, EXOSPHERE,
+    OUTER_SPACE_PLANET_VIEW, OUTER_SPACE_SYSTEM_VIEW, OUTER_SPACE_BEYOND
+};
+struct StratumInfo { std::wstring name; Stratum type; int depth; };
+const std::vector<StratumInfo> strataDefinition = {
+    { L"Inner Core",     Stratum::INNER_CORE,             5 },
+    { L"Outer Core",     Stratum::OUTER_CORE,             10},
+    { L"Lower Mantle",   Stratum::LOWER_MANTLE,           15},
+    { L"Upper Mantle",   Stratum::UPPER_MANTLE,           10},
+    { L"Asthenosphere",  Stratum::ASTHENOSPHERE,          3 },
+    { L"Lithosphere",    Stratum::LITHOSPHERE,            5 },
+    { L"Crust",          Stratum::CRUST,                  2 },
+    { L"Hydrosphere",    Stratum::HYDROSPHERE,            1 },
+    { L"Biosphere",      Stratum::BIOSPHERE,              1 },
+    { L"Atmosphere",     Stratum::ATMOSPHERE,             10 },
+    { L"Troposphere",    Stratum::TROPOSPHERE,            3 },
+    { L"Stratosphere",   Stratum::STRATOSPHERE,           2 },
+    { L"Mesosphere",     Stratum::MESOSPHERE,             2 },
+    { L"Thermosphere",   Stratum::THERMOSPHERE,           2 },
+    { L"Exosphere",      Stratum::EXOSPHERE,              3 },
+};
+extern int TILE_WORLD_DEPTH; extern int BIOSPHERE_Z_LEVEL; extern int HYDROSPHERE_Z_LEVEL; extern int ATMOSPHERE_TOP_Z;
+
+// --- Research System ---
+enum class ResearchEra { NEOLITHIC, CLASSICAL, MEDIEVAL, RENAISSANCE, INDUSTRIAL, MODERN, ATOMIC, INFORMATION, CYBERNETIC, INTERSTELLAR };
+const std::vector<std::wstring> ResearchEraNames = { L"Neolithic", L"Classical", L"Medieval", L"Renaissance", L"Industrial", L"Modern", L"Atomic", L"Information", L"Cybernetic", L"Interstellar" };
+enum class ResearchCategory {
+    ALL, CONSTRUCTION, CRAFTING, APPAREL, COOKING, FARMING, ANIMALS, STORAGE, COMBAT, SECURITY,
+    MEDICINE, HOSPITALITY, TECH, POWER, TRANSPORT, RECREATION, SCIENCE, SPACE,
+    LIGHTS
+};
+struct ResearchProject { std::wstring id, name, description; int cost; ResearchEra era; ResearchCategory category; std::vector<std::wstring> prerequisites; std::vector<std::wstring> unlocks; };
+extern std::map<std::wstring, ResearchProject> g_allResearch;
+extern unsigned g_researchDataVersion; // Bumped whenever g_allResearch is rebuilt, so cached layouts know to refresh
+extern std::set<std::wstring> g_completedResearch;
+extern std::wstring g_currentResearchProject;
+extern int g_researchProgress;
+extern std::set<TileType> g_unlockedBuildings;
+extern unsigned g_unlockedContentVersion; // Bumped whenever g_unlockedBuildings changes, so cached UI lists refresh
+
+// --- Solar System & Planet Generation Data ---
+enum class WorldType { EARTH_LIKE, SINGLE_CONTINENT, ARCHIPELAGO }; const std::vector<std::wstring> WorldTypeNames = { L"Earth-like", L"Single Continent", L"Archipelago" };
+const int PLANET_MAP_WIDTH = 220, PLANET_MAP_HEIGHT = 100;
+struct Planet { std::wstring name; WorldType type; std::vector<std::vector<Biome>> biomeMap; double orbitalRadius, currentAngle, orbitalSpeed; uint32_t color; int size; };
+extern std::vector<Planet> solarSystem; struct Moon { double orbitalRadius, currentAngle, orbitalSpeed; uint32_t color; int size; }; extern Moon homeMoon;
+struct Star { float x, y, dx; int size; uint32_t color; }; extern std::vector<Star> distantStars; extern int g_homeSystemStarIndex;
+extern int landingSiteX, landingSiteY; extern int finalStartX, finalStartY;
+
+// --- In-Game World & Map Data ---
+const int BUILD_WORK_REQUIRED = 200;
+struct Tree; // Forward declaration
+struct MapCell {
+    TileType type = TileType::EMPTY;
+    TileType underlying_type = TileType::EMPTY;
+    TileType target_type = TileType::EMPTY; // What this cell will become (for blueprints)
+    int construction_progress = 0;          // Ticks of work applied
+    std::vector<TileType> itemsOnGround;
+    Tree* tree = nullptr; // Pointer to the tree this cell is part of
+    int stockpileId = -1; // NEW: ID of the stockpile this cell belongs to, -1 if none
+};
+const int WORLD_WIDTH = 120, WORLD_HEIGHT = 60;
+extern std::vector<std::vector<std::vector<MapCell>>> Z_LEVELS;
+extern std::vector<std::wstring> designations;
+const int MAX_STACK_SIZE = 64;
+
+struct ContinentInfo {
+    bool found = false;
+    std::wstring name;
+    std::vector<Point2D> tiles;
+    std::set<Biome> biomes;
+    float avgTemp = 0.0f;
+    float timezoneOffset = 0.0f;
+};
+
+// --- Tree System ---
+struct TreePart { int x, y, z; TileType type; };
+struct Tree { int id; TileType type; int rootX, rootY, rootZ; std::vector<TreePart> parts; };
+extern std::map<int, Tree> a_trees; // Use map for stable IDs
+extern int nextTreeId;
+struct FallenTree {
+    int treeId; TileType baseType;
+    std::vector<TreePart> initialParts;
+    int fallStep;
+    int fallDirectionX, fallDirectionY;
+};
+extern std::vector<FallenTree> a_fallingTrees;
+
+// --- Job & Pawn Data ---
+struct Backstory { std::wstring name; std::wstring description; };
+extern std::map<std::wstring, Backstory> g_Backstories;
+extern std::map<std::wstring, std::wstring> g_SkillDescriptions;
+
+enum class JobType { Mine, Chop, Farm, Build, Haul, Cook, Hunt, Research, Deconstruct }; // <-- ADD Deconstruct
+const std::vector<std::wstring> JobTypeNames = { L"Mining", L"Chopping", L"Farming", L"Construction", L"Hauling", L"Cooking", L"Hunting", L"Research", L"Deconstruction" };
+struct Job {
+    JobType type;
+    int x, y, z;          // Target/Primary location (e.g., where to mine, where to build)
+    int treeId = -1;      // For chop jobs
+    TileType itemType = TileType::EMPTY; // For haul jobs: type of item to haul
+    int itemSourceX = -1; // For haul jobs: source X of the item
+    int itemSourceY = -1; // For haul jobs: source Y of the item
+    int itemSourceZ = -1; // For haul jobs: source Z of the item
+};
+extern std::vector<Job> jobQueue;
+// A job a pawn settled on while thinking; claimJobChoice() checks it is still free before taking it.
+struct JobChoice {
+    bool found = false;
+    Job job = {};
+    int queueIndex = -1; // Position in jobQueue when chosen; -1 for chop jobs, which live in designations
+    wchar_t treeRootMark = L' '; // Chop jobs: the tree root's designation when chosen
+    std::vector<Point3D> path;
+};
+// What a batch of deferred tasks worked out in parallel, before being committed in pawn order.
+struct AiTaskResult {
+    JobChoice choice;              // JOB_SEARCH
+    std::vector<Point3D> path;     // REPLAN
+};
+struct Pawn {
+    std::wstring name, gender, backstory; int age; std::vector<std::wstring> traits;
+    bool isDrafted = false;
+    int x = -1, y = -1, z = 0;
+    std::wstring currentTask = L"Idle";
+    int targetX = -1, targetY = -1, targetZ = -1; // Current target location for movement
+    long long nextWanderTick = 0; // gameTicks at which an idle pawn may take its next random step
+    int jobTreeId = -1; // ID of the tree this pawn is assigned to chop
+    long long nextJobSearchTick = 0; // gameTicks at which an idle pawn may look for work again
+    std::map<std::wstring, int> skills; std::map<JobType, int> priorities;
+    std::map<TileType, int> inventory;
+    long long haulBlockedUntilTick = 0; // No haul jobs are taken before this gameTicks value
+    bool jobSearchQueued = false; // Waiting in the AI scheduler for a job search
+    bool replanQueued = false;    // Waiting in the AI scheduler for a new path to its target
+
+    int haulSourceX = -1, haulSourceY = -1, haulSourceZ = -1;
+    int haulDestX = -1, haulDestY = -1, haulDestZ = -1;
+
+    int ticksStuck = 0; // NEW: Counter for how long the pawn has been unable to move towards target
+
+    // NEW: Pathfinding data
+    std::vector<Point3D> currentPath; // Stores the sequence of (x,y,z) points to follow
+    size_t currentPathIndex = 0;      // Index of the next point in currentPath to move to
+};
+// What a pawn worked out in the parallel think step of updateGame, for its act step to apply.
+struct PawnThought {
+    int threatIndex = -1;          // Closest undead in sight, index into g_critters
+    std::vector<Point3D> fleePath; // Only for a pawn about to start fleeing
+};
+const size_t PAWN_CHUNK_SIZE = 8;
+const int PAWN_INVENTORY_CAPACITY = 15; // NEW: Maximum items a pawn can carry.
+extern std::vector<Pawn> rerollablePawns; extern std::vector<Pawn> colonists;
+extern std::map<std::wstring, int> resources;
+extern std::map<TileType, int> g_stockpiledResources;
+extern unsigned g_stockpileContentsVersion; // Bumped whenever g_stockpiledResources changes
+
+// Stockpile Struct
+struct Stockpile {
+    int id;
+    CellRect rect; // {left, top, right, bottom} in world coordinates (x,y)
+    int z;
+    std::set<TileType> acceptedResources; // Items this stockpile accepts
+    std::vector<Point3D> cells; // Member cells in row-major order; rect is only their bounding box
+    // For UI, to maintain order and easily iterate
+    /* std::vector<TileType> allHaulableItems; */
+};
+
+// Global Stockpile Management
+// g_stockpiles stays in ascending id order: ids are handed out increasingly and removal preserves order.
+// g_stockpileSlotById maps a stockpile id to its index in g_stockpiles (-1 once removed) for O(1) lookup.
+extern std::vector<Stockpile> g_stockpiles;
+extern std::vector<int> g_stockpileSlotById;
+extern int nextStockpileId;
+extern std::map<int, int> g_unreachableStockpileCache;
+extern std::map<TileTag, std::wstring> g_tagNames; // Maps TileTag to a display name (e.g., TileTag::WOOD -> "Woods")
+extern std::map<TileTag, std::vector<TileType>> g_haulableItemsGrouped; // Stores TileTypes grouped by their primary TileTag
+
+// --- Item Spatial Index ---
+// Loose item stacks bucketed per TileType into square chunks of each Z-level, so "nearby stacks of type T"
+// costs in proportion to the matches found instead of the volume searched. All itemsOnGround edits
+// go through addItemToCell/removeItemFromCell so the counts below stay exact without rescans.
+const int ITEM_INDEX_CHUNK_SIZE = 8;
+const int ITEM_INDEX_CHUNKS_X = (WORLD_WIDTH + ITEM_INDEX_CHUNK_SIZE - 1) / ITEM_INDEX_CHUNK_SIZE;
+const int ITEM_INDEX_CHUNKS_Y = (WORLD_HEIGHT + ITEM_INDEX_CHUNK_SIZE - 1) / ITEM_INDEX_CHUNK_SIZE;
+struct ItemTypeIndex {
+    int countOnMap = 0;        // Every loose item of this type, stockpiled or not
+    int countInStockpiles = 0; // The part of countOnMap lying on stockpile cells
+    std::map<int, std::vector<Point3D>> chunks; // Chunk key -> cells holding at least one item of this type
+};
+extern std::map<TileType, ItemTypeIndex> g_itemIndex;
+
+// --- Stair Graph ---
+// Every completed stair pair (STAIR_UP at zLower, STAIR_DOWN right above it). Haul planning prices trips between
+// levels over this small graph instead of flooding the 3D grid; it is rebuilt lazily after any stair change.
+struct StairLink {
+    int x, y, zLower;
+};
+extern std::vector<StairLink> g_stairLinks;
+extern std::vector<std::vector<int>> g_stairNodesByLevel; // Z-level -> stair endpoints on it (link * 2 + 0 lower, + 1 upper)
+extern bool g_stairGraphDirty;
+const int HAUL_COST_UNREACHABLE = INT_MAX;
+
+// --- State Hash ---
+// A fingerprint of the simulation, split by subsystem so two runs that disagree also say where. The map part is
+// kept incrementally: every Z-level is cut into square chunks whose hashes are XORed together, and whatever
+// edits a MapCell calls markCellDirty so that only the chunks touched since the last hash are rehashed.
+enum class StateHashPart { MAP, PAWNS, CRITTERS, JOBS, CLOCK, RANDOM, COUNT };
+const char* const STATE_HASH_PART_NAMES[] = { "map", "pawns", "critters", "jobs", "clock/weather", "random streams" };
+struct StateHash {
+    long long tick = 0;
+    uint64_t parts[(int)StateHashPart::COUNT] = {};
+};
+const int STATE_HASH_CHUNK_SIZE = 16;
+const int STATE_HASH_CHUNKS_X = (WORLD_WIDTH + STATE_HASH_CHUNK_SIZE - 1) / STATE_HASH_CHUNK_SIZE;
+const int STATE_HASH_CHUNKS_Y = (WORLD_HEIGHT + STATE_HASH_CHUNK_SIZE - 1) / STATE_HASH_CHUNK_SIZE;
+struct MapHashState {
+    bool valid = false; // False until the first hash after world generation; then kept up by dirty chunks
+    uint64_t combined = 0;
+    std::vector<uint64_t> chunks; // Chunk key -> hash of its cells
+    std::vector<char> dirty;
+    std::vector<int> dirtyChunks;
+};
+extern MapHashState g_mapHash;
+
+extern int gameSpeed;
+extern std::vector<std::vector<std::vector<bool>>> g_isTileReachable;
+
+// --- Function Prototypes ---
+void initGameData(); void initResearchData();
+void initPawnData();
+void initCritterData();
+void initBiomeCritterSpawns();
+void resetWorld();
+void computeGlobalReachability();
+void updateGame(); void updateTime(); void updateSolarSystem(long long ticks); void updateFallingTrees();
+Pawn generatePawn(); void generateFullWorld(Biome biome); void generatePlanetMap(Planet& planet); void generateSolarSystem(int numPlanets, bool preserveNames = false); void generateDistantStars(); void preparePawnSelection();
+void spawnInitialCritters();
+StratumInfo getStratumInfoForZ(int z); std::wstring getDaySuffix(int day);
+void spawnTree(int x, int y, TileType type, RandomStream& rng);
+void fellTree(int treeId, const Pawn& chopper);
+ContinentInfo findContinentInfo(int startX, int startY);
+bool isOceanOrOutOfBounds(int x, int y);
+std::string WStringToString(const std::wstring& wstr);
+std::wstring replacePlaceholder(std::wstring original, const std::wstring& placeholder, const std::wstring& value);
+uint64_t mixRandomSeed(uint64_t seed, uint64_t salt);
+uint64_t makeRandomSeed(); void setWorldSeed(uint64_t seed);
+bool isCritterWalkable(int x, int y, int z);
+bool CanBuildOn(int x, int y, int z, TileType toBuild);
+std::vector<Point2D> BresenhamLine(int x1, int y1, int x2, int y2);
+void updateUnlockedContent(const ResearchProject& project);
+void invalidateLightMaps(); void updateLightMaps(); float lightMapAt(int x, int y, int z);
+void invalidateSolidColumns(); void updateSolidColumns(); int solidCellAtOrBelow(int x, int y, int z); float seeThroughShade(int depth);
+void addItemToCell(int x, int y, int z, TileType item);
+TileType removeItemFromCell(int x, int y, int z, size_t itemIndex);
+void setCellStockpileId(int x, int y, int z, int stockpileId);
+void clearItemIndex();
+std::vector<Point3D> findNearestItemStacks(TileType type, Point3D origin, int radius, int zRange, int maxResults);
+int getItemCountOnMap(TileType type);
+int getItemCountInStockpiles(TileType type);
+void markStairGraphDirty();
+void markCellDirty(int x, int y, int z); void invalidateMapHash();
+int estimateHaulCost(Point3D from, Point3D to);
+void resetTimerWheel(long long tick);
+void scheduleTimer(long long dueTick, TimerKind kind, int target = -1);
+void addCritter(const Critter& critter);
+void startSimulationTimers();
+void placeColonists(int startX, int startY);
+void startWorkerPool(int threadCount); void stopWorkerPool();
+void parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& fn);
+void stopFastForward(const std::wstring& reason);
+bool isColonyIdle(); bool skipIdleTime();
+void profilerEndFrame(ProfileCategory category); void toggleProfilerTrace();
+void runDueTimers();
+void resetAiScheduler();
+void runAiScheduler();
+Stockpile* findStockpileById(int id);
+int getStockpileSlot(int id);
+int createStockpile(int x1, int y1, int x2, int y2, int z);
+void removeStockpile(int id);
+StateHash computeStateHash();
+HeadlessOptions parseHeadlessOptions(const std::string& commandLine);
+void setUpHeadlessColony(const HeadlessOptions& options);
+int runHeadless(const HeadlessOptions& options);
+bool reportFirstDivergence(const std::vector<StateHash>& expected, const char* expectedName, const std::vector<StateHash>& actual, const char* actualName);
+int runDeterminismCheck(const HeadlessOptions& options);
+
+// NEW: For pawn pathfinding and logic
+bool isWalkable(int x, int y, int z); // This should already be there, but double check
+bool isDeconstructable(TileType type); // Add this prototype
+std::vector<Point3D> findPath(Point3D start, Point3D end); // Add this prototype
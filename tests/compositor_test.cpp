@@ -0,0 +1,145 @@
+// Checks the compositor's SSE2 paths against their scalar references, and that scrolling plus redrawing only the
+// changed cells gives the same pixels as compositing the whole view. Exits non-zero on the first mismatch.
+#include "../compositor.h"
+
+#include <cstdio>
+#include <vector>
+
+static uint32_t g_state = 12345;
+static uint32_t nextRandom() {
+    g_state = g_state * 1664525u + 1013904223u;
+    return g_state >> 8;
+}
+
+static int g_failures = 0;
+static void expect(bool condition, const char* what, int a, int b) {
+    if (condition) return;
+    if (g_failures++ < 10) printf("FAIL: %s (%d, %d)\n", what, a, b);
+}
+
+static void testBlendPixel() {
+    for (int i = 0; i < 1000; ++i) {
+        uint32_t dst = nextRandom() & 0xFFFFFF, fg = nextRandom() & 0xFFFFFF;
+        expect(blendPixel(dst, fg, 0) == dst, "blendPixel with no coverage keeps the background", i, 0);
+        expect(blendPixel(dst, fg, 255) == fg, "blendPixel with full coverage gives the foreground", i, 0);
+    }
+}
+
+static void testBlendGlyphMask() {
+    for (int w = 1; w <= 19; ++w) {
+        for (int h = 1; h <= 5; ++h) {
+            std::vector<uint8_t> mask((size_t)w * h);
+            for (uint8_t& c : mask) {
+                uint32_t r = nextRandom() % 4;
+                c = r == 0 ? 0 : r == 1 ? 255 : (uint8_t)(nextRandom() & 0xFF);
+            }
+            for (int x = 0; x < w; ++x) mask[x] = 0; // An empty first row, which the SSE2 path skips
+            const int bufferWidth = w + 7, bufferHeight = h + 2;
+            std::vector<uint32_t> background((size_t)bufferWidth * bufferHeight);
+            for (uint32_t& p : background) p = nextRandom() & 0xFFFFFF;
+            std::vector<uint32_t> vectorPixels = background, scalarPixels = background;
+            PixelBuffer vectorBuffer = { vectorPixels.data(), bufferWidth, bufferHeight, bufferWidth };
+            PixelBuffer scalarBuffer = { scalarPixels.data(), bufferWidth, bufferHeight, bufferWidth };
+            uint32_t fg = nextRandom() & 0xFFFFFF;
+            int x = (int)(nextRandom() % 7), y = (int)(nextRandom() % 3);
+            blendGlyphMask(vectorBuffer, x, y, mask.data(), w, h, fg);
+            blendGlyphMaskScalar(scalarBuffer, x, y, mask.data(), w, h, fg);
+            expect(vectorPixels == scalarPixels, "blendGlyphMask matches the scalar blend", w, h);
+        }
+    }
+}
+
+static void testTintPixels() {
+    const int scales[] = { 0, 1, 77, 128, 200, 255, 256 };
+    for (size_t count = 0; count <= 37; ++count) {
+        std::vector<uint32_t> src(count);
+        for (uint32_t& p : src) p = (nextRandom() & 0xFFFFFF) | ((nextRandom() & 1) ? PIXEL_TINTED : 0);
+        for (int scale : scales) {
+            std::vector<uint32_t> vectorOut(count, 0xDEADBEEF), scalarOut(count, 0xDEADBEEF);
+            tintPixels(src.data(), vectorOut.data(), count, scale);
+            tintPixelsScalar(src.data(), scalarOut.data(), count, scale);
+            expect(vectorOut == scalarOut, "tintPixels matches the scalar tint", (int)count, scale);
+        }
+    }
+    expect(lightScale(0.0f) == 0 && lightScale(1.0f) == 256 && lightScale(2.0f) == 256 && lightScale(-1.0f) == 0, "lightScale clamps to [0, 256]", 0, 0);
+}
+
+static ScreenCell randomCell() {
+    ScreenCell cell;
+    cell.glyph = (wchar_t)(L'A' + nextRandom() % 4);
+    cell.fg = nextRandom() & 0xFFFFFF;
+    cell.bg = nextRandom() % 2 ? 0 : (nextRandom() & 0xFFFFFF);
+    if (nextRandom() % 4 == 0) {
+        cell.overlay = L'A';
+        cell.overlayFg = nextRandom() & 0xFFFFFF;
+    }
+    return cell;
+}
+
+static void testScrollAndRedraw() {
+    const int cellWidth = 5, cellHeight = 7, columns = 9, rows = 6;
+    GlyphAtlas atlas;
+    resetGlyphAtlas(atlas, L"Test", cellWidth, cellHeight);
+    for (wchar_t glyph = L'A'; glyph < L'A' + 4; ++glyph) {
+        std::vector<uint8_t> mask((size_t)cellWidth * cellHeight);
+        for (uint8_t& c : mask) c = (uint8_t)(nextRandom() & 0xFF);
+        addGlyphMask(atlas, glyph, mask.data());
+    }
+    expect(findGlyphMask(atlas, L'Z') == nullptr, "an unrasterised glyph has no mask", 0, 0);
+
+    // A world twice the view's size, viewed from a camera that scrolls around it
+    const int worldColumns = columns * 2, worldRows = rows * 2;
+    std::vector<ScreenCell> world((size_t)worldColumns * worldRows);
+    for (ScreenCell& cell : world) cell = randomCell();
+    auto view = [&](int cameraX, int cameraY) {
+        std::vector<ScreenCell> cells((size_t)columns * rows);
+        for (int row = 0; row < rows; ++row)
+            for (int col = 0; col < columns; ++col) cells[(size_t)row * columns + col] = world[(size_t)(cameraY + row) * worldColumns + cameraX + col];
+        return cells;
+    };
+
+    const int width = columns * cellWidth, height = rows * cellHeight;
+    std::vector<uint32_t> pixels((size_t)width * height);
+    PixelBuffer buffer = { pixels.data(), width, height, width };
+    std::vector<ScreenCell> presented;
+    int cameraX = 4, cameraY = 3;
+    expect(compositeChangedCells(buffer, atlas, view(cameraX, cameraY).data(), presented, columns, rows) == columns * rows, "the first frame redraws every cell", 0, 0);
+
+    const int moves[][2] = { { 1, 0 }, { 0, 1 }, { -2, -1 }, { 3, 2 }, { 0, 0 }, { -4, 0 } };
+    for (const auto& move : moves) {
+        // Change a few cells as well, as the simulation would between frames
+        for (int i = 0; i < 3; ++i) world[nextRandom() % world.size()] = randomCell();
+        int newCameraX = cameraX + move[0], newCameraY = cameraY + move[1];
+        int shiftX = cameraX - newCameraX, shiftY = cameraY - newCameraY;
+        shiftPixels(buffer, shiftX * cellWidth, shiftY * cellHeight);
+        shiftCells(presented, columns, rows, shiftX, shiftY);
+        cameraX = newCameraX;
+        cameraY = newCameraY;
+        std::vector<ScreenCell> cells = view(cameraX, cameraY);
+        compositeChangedCells(buffer, atlas, cells.data(), presented, columns, rows);
+
+        std::vector<uint32_t> fullPixels((size_t)width * height);
+        PixelBuffer fullBuffer = { fullPixels.data(), width, height, width };
+        std::vector<ScreenCell> nothingPresented;
+        compositeChangedCells(fullBuffer, atlas, cells.data(), nothingPresented, columns, rows);
+        expect(pixels == fullPixels, "scrolling and redrawing changed cells matches a full redraw", move[0], move[1]);
+    }
+}
+
+int main() {
+    testBlendPixel();
+    testBlendGlyphMask();
+    testTintPixels();
+    testScrollAndRedraw();
+#ifdef COMPOSITOR_SSE2
+    const char* paths = "SSE2";
+#else
+    const char* paths = "scalar only";
+#endif
+    if (g_failures) {
+        printf("%d compositor checks failed (%s)\n", g_failures, paths);
+        return 1;
+    }
+    printf("compositor checks passed (%s)\n", paths);
+    return 0;
+}